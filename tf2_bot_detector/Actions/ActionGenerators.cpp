@@ -1,19 +1,124 @@
 #include "ActionGenerators.h"
 #include "Actions.h"
+#include "ConsoleLog/ConsoleLines.h"
 #include "IActionManager.h"
+#include "IPlayer.h"
 #include "Log.h"
 
+#include <cstdlib>
+
 using namespace tf2_bot_detector;
 using namespace std::chrono_literals;
 
-duration_t StatusUpdateActionGenerator::GetInterval() const
+StatusUpdateActionGenerator::StatusUpdateActionGenerator(IWorldState& world) :
+	AutoWorldEventListener(world),
+	AutoConsoleLineListener(world)
+{
+}
+
+void StatusUpdateActionGenerator::OnActivity()
 {
-	return 3s;
+	m_LastActivityTime = clock_t::now();
+	m_ActivitySinceLastRun = true;
+	m_Interval = MIN_INTERVAL;
+}
+
+void StatusUpdateActionGenerator::OnPlayerStatusUpdate(IWorldState& world, const IPlayer& player)
+{
+	// Ping swings this big usually mean someone is still loading in
+	constexpr uint16_t PING_CHANGE_THRESHOLD = 40;
+
+	const uint16_t ping = player.GetPing();
+	const TFTeam team = player.GetTeam();
+	const PlayerStatusState state = player.GetConnectionState();
+	const auto [it, isNew] = m_LastPlayerStatus.try_emplace(player.GetSteamID(), LastPlayerStatus{ ping, team, state });
+	auto& last = it->second;
+
+	if (isNew)
+	{
+		OnActivity();
+	}
+	else if (state != last.m_State)
+	{
+		// Someone getting further through loading in. Staying in the same state isn't activity,
+		// otherwise one player stuck connecting would keep status at the fastest interval.
+		last.m_State = state;
+		OnActivity();
+	}
+	else if (team != last.m_Team)
+	{
+		// Autobalance, or teams getting scrambled/swapped. Usually more than one player at once.
+		last.m_Team = team;
+		OnActivity();
+	}
+	else if (std::abs(int(ping) - int(last.m_Ping)) > PING_CHANGE_THRESHOLD)
+	{
+		last.m_Ping = ping;
+		OnActivity();
+	}
+}
+
+void StatusUpdateActionGenerator::OnLocalPlayerInitialized(IWorldState& world, bool initialized)
+{
+	if (!initialized)
+		m_LastPlayerStatus.clear(); // Connecting somewhere new
+
+	OnActivity();
+}
+
+void StatusUpdateActionGenerator::OnLocalPlayerSpawned(IWorldState& world, TFClassType classType)
+{
+	OnActivity();
+}
+
+void StatusUpdateActionGenerator::OnPlayerDroppedFromServer(IWorldState& world, IPlayer& player, const std::string_view& reason)
+{
+	m_LastPlayerStatus.erase(player.GetSteamID());
+	OnActivity();
+}
+
+void StatusUpdateActionGenerator::OnConsoleLineParsed(IWorldState& world, IConsoleLine& line)
+{
+	switch (line.GetType())
+	{
+	case ConsoleLineType::LobbyChanged:
+		OnActivity();
+		break;
+
+	case ConsoleLineType::LobbyHeader:
+	{
+		// Printed every time the lobby is polled, only the counts changing means anything
+		auto& headerLine = static_cast<const LobbyHeaderLine&>(line);
+		if (headerLine.GetMemberCount() != m_LastLobbyMemberCount ||
+			headerLine.GetPendingCount() != m_LastLobbyPendingCount)
+		{
+			m_LastLobbyMemberCount = headerLine.GetMemberCount();
+			m_LastLobbyPendingCount = headerLine.GetPendingCount();
+			OnActivity();
+		}
+		break;
+	}
+
+	case ConsoleLineType::LobbyStatusFailed:
+	{
+		// Not in a lobby (anymore)
+		if (m_LastLobbyMemberCount != 0 || m_LastLobbyPendingCount != 0)
+		{
+			m_LastLobbyMemberCount = 0;
+			m_LastLobbyPendingCount = 0;
+			OnActivity();
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
 }
 
 bool StatusUpdateActionGenerator::ExecuteImpl(IActionManager& manager)
 {
-	// 3 second interval, we want:
+	// Interval varies from MIN_INTERVAL to MAX_INTERVAL, we want:
 	//   1. status
 	//   2. ping
 	//   3. status short
@@ -37,6 +142,12 @@ bool StatusUpdateActionGenerator::ExecuteImpl(IActionManager& manager)
 
 	m_NextPing = !m_NextPing;
 
+	// Back off a bit every time nothing happened since the last poll
+	if (!m_ActivitySinceLastRun)
+		m_Interval = std::min(m_Interval * 2, MAX_INTERVAL);
+
+	m_ActivitySinceLastRun = false;
+
 	return true;
 }
 
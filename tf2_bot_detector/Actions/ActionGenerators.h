@@ -1,6 +1,13 @@
 #pragma once
 
 #include "Clock.h"
+#include "ConsoleLog/ConsoleLineListener.h"
+#include "PlayerStatus.h"
+#include "SteamID.h"
+#include "TFConstants.h"
+#include "WorldEventListener.h"
+
+#include <unordered_map>
 
 namespace tf2_bot_detector
 {
@@ -25,6 +32,9 @@ namespace tf2_bot_detector
 
 		bool Execute(IActionManager& manager) override final;
 
+		// When Execute() will next do any work. Only meaningful once Execute() has been called.
+		time_point_t GetNextRunTime() const { return m_LastRunTime + GetInterval(); }
+
 	protected:
 		[[nodiscard]] virtual bool ExecuteImpl(IActionManager& manager) = 0;
 
@@ -32,15 +42,50 @@ namespace tf2_bot_detector
 		time_point_t m_LastRunTime{};
 	};
 
-	class StatusUpdateActionGenerator final : public IPeriodicActionGenerator
+	// Polls status/ping. Speeds up while the server is changing (connecting, players joining or
+	// leaving, team switches, lobby changes, large ping swings) and backs off while everything is
+	// stable, since full status replies are the most expensive thing we parse.
+	class StatusUpdateActionGenerator final : public IPeriodicActionGenerator, AutoWorldEventListener, AutoConsoleLineListener
 	{
 	public:
-		duration_t GetInterval() const override;
+		StatusUpdateActionGenerator(IWorldState& world);
+
+		duration_t GetInterval() const override { return m_Interval; }
+
+		static constexpr duration_t MIN_INTERVAL = std::chrono::seconds(1);
+		static constexpr duration_t MAX_INTERVAL = std::chrono::seconds(6);
+
+		// Time since something last happened that made us speed up polling
+		duration_t GetTimeSinceActivity() const { return clock_t::now() - m_LastActivityTime; }
 
 	protected:
 		bool ExecuteImpl(IActionManager& manager) override;
 
 	private:
+		void OnPlayerStatusUpdate(IWorldState& world, const IPlayer& player) override;
+		void OnLocalPlayerInitialized(IWorldState& world, bool initialized) override;
+		void OnLocalPlayerSpawned(IWorldState& world, TFClassType classType) override;
+		void OnPlayerDroppedFromServer(IWorldState& world, IPlayer& player, const std::string_view& reason) override;
+		void OnConsoleLineParsed(IWorldState& world, IConsoleLine& line) override;
+
+		void OnActivity();
+
+		duration_t m_Interval = MIN_INTERVAL;
+		time_point_t m_LastActivityTime{};
+		bool m_ActivitySinceLastRun = true;
+
+		struct LastPlayerStatus
+		{
+			uint16_t m_Ping = 0;
+			TFTeam m_Team = TFTeam::Unknown;
+			PlayerStatusState m_State = PlayerStatusState::Invalid;
+		};
+		std::unordered_map<SteamID, LastPlayerStatus> m_LastPlayerStatus;
+
+		// From the last tf_lobby_debug
+		unsigned m_LastLobbyMemberCount = 0;
+		unsigned m_LastLobbyPendingCount = 0;
+
 		bool m_NextShort = false;
 		bool m_NextPing = false;
 	};
@@ -4,6 +4,7 @@
 #include "ConsoleLog/ConsoleLines.h"
 #include "Actions.h"
 #include "Log.h"
+#include "Util/TimingWheel.h"
 #include "WorldEventListener.h"
 #include "WorldState.h"
 
@@ -12,6 +13,7 @@
 #include <srcon/async_client.h>
 
 #include <filesystem>
+#include <bit>
 #include <iomanip>
 #include <queue>
 #include <regex>
@@ -53,30 +55,53 @@ namespace
 			return AddPeriodicActionGenerator(std::make_unique<TAction>(std::forward<TArgs>(args)...));
 		}
 
+		std::map<std::string, CommandRTTStats, std::less<>> GetRTTStats() const override { return m_RTTStats; }
+
 	private:
 		void OnLocalPlayerInitialized(IWorldState& world, bool initialized) override;
 
-		struct RunningCommand
+		// Commands written by actions, waiting to be packed into rcon packets
+		std::vector<std::string> m_PendingCommands;
+
+		// One rcon packet. Several commands may be coalesced into it, joined with ';'. Their output
+		// comes back as one response, which is all the console line parser needs.
+		struct RunningPacket
 		{
 			time_point_t m_StartTime{};
-			std::string m_Command;
+			std::vector<std::string> m_Commands;
 			std::shared_future<std::string> m_Future;
 		};
-		std::queue<RunningCommand> m_RunningCommands;
+		std::queue<RunningPacket> m_RunningPackets;
 		void ProcessRunningCommands();
 		void ProcessQueuedCommands();
+		void SendPendingCommands();
+		void OnPacketCompleted(const RunningPacket& packet, const std::string_view& response);
 
 		struct Writer;
 
-		static constexpr duration_t UPDATE_INTERVAL = std::chrono::milliseconds(250);
+		// Only commands that are safe to join with ';' are coalesced, and only up to this many
+		// characters. The game truncates longer command lines.
+		static constexpr size_t MAX_COALESCED_LENGTH = 480;
+		// Responses are processed in order, so don't let too many packets stack up behind a slow one
+		static constexpr size_t MAX_IN_FLIGHT_PACKETS = 4;
+		// If the game stops responding, actions stay in m_Actions (which limits each type with
+		// IAction::GetMaxQueuedCount()) rather than piling up here as commands
+		static constexpr size_t MAX_PENDING_COMMANDS = 64;
+		// Granularity of the periodic action generator schedule
+		static constexpr duration_t SCHEDULER_TICK = std::chrono::milliseconds(50);
+		// Generators can shorten their interval at any time (StatusUpdateActionGenerator does), so
+		// check back at least this often. Execute() is a no-op if they aren't due yet.
+		static constexpr duration_t MAX_GENERATOR_SLEEP = std::chrono::seconds(1);
 
 		IWorldState& m_WorldState;
 		const Settings& m_Settings;
-		time_point_t m_LastUpdateTime{};
 		std::vector<std::unique_ptr<IAction>> m_Actions;
 		std::vector<std::unique_ptr<IPeriodicActionGenerator>> m_PeriodicActionGenerators;
+		TimingWheel<IPeriodicActionGenerator*> m_GeneratorSchedule{ SCHEDULER_TICK };
 		std::map<ActionType, time_point_t> m_LastTriggerTime;
 
+		std::map<std::string, CommandRTTStats, std::less<>> m_RTTStats;
+
 		bool ShouldDiscardCommand(const std::string_view& cmd) const;
 		bool m_IsDiscardingServerCommands = true;
 	};
@@ -134,6 +159,8 @@ bool RCONActionManager::QueueAction(std::unique_ptr<IAction>&& action)
 
 void RCONActionManager::AddPeriodicActionGenerator(std::unique_ptr<IPeriodicActionGenerator>&& action)
 {
+	// First run is immediate, IPeriodicActionGenerator::Execute() takes care of any initial delay
+	m_GeneratorSchedule.Schedule(tfbd_clock_t::now(), action.get());
 	m_PeriodicActionGenerators.push_back(std::move(action));
 }
 
@@ -144,6 +171,51 @@ void RCONActionManager::OnLocalPlayerInitialized(IWorldState& world, bool initia
 		m_IsDiscardingServerCommands, m_Settings.m_ConfigCompatibilityMode);
 }
 
+void IRCONActionManager::CommandRTTStats::AddSample(duration_t rtt)
+{
+	const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(rtt).count();
+	const size_t bucket = ms > 0 ? size_t(std::bit_width(uint64_t(ms))) : 0;
+	m_Buckets[std::min(bucket, BUCKET_COUNT - 1)]++;
+
+	m_Count++;
+	m_TotalRTT += rtt;
+	m_MaxRTT = std::max(m_MaxRTT, rtt);
+}
+
+void RCONActionManager::OnPacketCompleted(const RunningPacket& packet, const std::string_view& response)
+{
+	const auto elapsed = tfbd_clock_t::now() - packet.m_StartTime;
+
+	for (size_t i = 0; i < packet.m_Commands.size(); i++)
+	{
+		const std::string_view cmd = packet.m_Commands[i];
+		const std::string_view cmdName = cmd.substr(0, cmd.find(' '));
+
+		auto found = m_RTTStats.find(cmdName);
+		if (found == m_RTTStats.end())
+			found = m_RTTStats.emplace(std::string(cmdName), CommandRTTStats{}).first;
+
+		found->second.AddSample(elapsed);
+
+		if (m_Settings.m_Unsaved.m_DebugShowCommands)
+		{
+			const auto elapsedMS = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+			std::string msg = "Game command processed in "s << elapsedMS.count() << "ms : " << std::quoted(cmd);
+
+			if (packet.m_Commands.size() > 1)
+				msg << " (coalesced " << (i + 1) << '/' << packet.m_Commands.size() << ')';
+
+			if (i == (packet.m_Commands.size() - 1) && !response.empty())
+				msg << ", response " << response.size() << " bytes";
+
+			DebugLog({ 1, 1, 1, 0.5f }, std::move(msg));
+		}
+	}
+
+	if (!response.empty())
+		m_WorldState.AddConsoleOutputChunk(response);
+}
+
 void RCONActionManager::ProcessRunningCommands()
 {
 	constexpr const char* funcName = __func__;
@@ -152,43 +224,42 @@ void RCONActionManager::ProcessRunningCommands()
 		return DebugLogWarning(""s << funcName << "(): " << msg);
 	};
 
-	while (!m_RunningCommands.empty())
+	while (!m_RunningPackets.empty())
 	{
-		auto& cmd = m_RunningCommands.front();
-		if (cmd.m_Future.wait_for(0s) == std::future_status::timeout)
+		auto& packet = m_RunningPackets.front();
+		if (packet.m_Future.wait_for(0s) == std::future_status::timeout)
 			break;
 
-		try
+		const auto GetPacketText = [&]
 		{
-			auto resultStr = cmd.m_Future.get();
-
-			if (m_Settings.m_Unsaved.m_DebugShowCommands)
+			std::string retVal;
+			for (const auto& cmd : packet.m_Commands)
 			{
-				const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(tf2_bot_detector::clock_t::now() - cmd.m_StartTime);
-				std::string msg = "Game command processed in "s << elapsed.count() << "ms : " << std::quoted(cmd.m_Command);
-
-				if (!resultStr.empty())
-					msg << ", response " << resultStr.size() << " bytes";
+				if (!retVal.empty())
+					retVal << "; ";
 
-				DebugLog({ 1, 1, 1, 0.5f }, std::move(msg));
+				retVal << cmd;
 			}
+			return retVal;
+		};
 
-			if (!resultStr.empty())
-				m_WorldState.AddConsoleOutputChunk(resultStr);
+		try
+		{
+			OnPacketCompleted(packet, packet.m_Future.get());
 		}
 		catch (const std::future_error& e)
 		{
 			if (e.code() == std::future_errc::broken_promise)
-				DebugLogWarning(std::string(__FUNCTION__) << "(): " << e.code().message() << ": " << e.what() << ": " << std::quoted(cmd.m_Command));
+				DebugLogWarning(std::string(__FUNCTION__) << "(): " << e.code().message() << ": " << e.what() << ": " << std::quoted(GetPacketText()));
 			else
-				PrintErrorMsg(e.code().message() << ": " << e.what() << ": " << std::quoted(cmd.m_Command));
+				PrintErrorMsg(e.code().message() << ": " << e.what() << ": " << std::quoted(GetPacketText()));
 		}
 		catch (const std::exception& e)
 		{
-			PrintErrorMsg(""s << e.what() << ": " << std::quoted(cmd.m_Command));
+			PrintErrorMsg(""s << e.what() << ": " << std::quoted(GetPacketText()));
 		}
 
-		m_RunningCommands.pop();
+		m_RunningPackets.pop();
 	}
 }
 
@@ -215,18 +286,62 @@ bool RCONActionManager::ShouldDiscardCommand(const std::string_view& cmd) const
 	return true;
 }
 
+// Commands that can safely share a command line with others. Anything quoted (chat messages,
+// votes) or already containing separators gets its own packet.
+static bool IsCoalescable(const std::string_view& cmd)
+{
+	return cmd.find_first_of(";\"\n") == cmd.npos;
+}
+
+void RCONActionManager::SendPendingCommands()
+{
+	auto& client = m_Settings.m_Unsaved.m_RCONClient;
+
+	auto it = m_PendingCommands.begin();
+	while (it != m_PendingCommands.end() && m_RunningPackets.size() < MAX_IN_FLIGHT_PACKETS)
+	{
+		RunningPacket packet;
+		std::string packetText = std::move(*it);
+		packet.m_Commands.push_back(packetText);
+		++it;
+
+		if (IsCoalescable(packetText))
+		{
+			for (; it != m_PendingCommands.end() && IsCoalescable(*it); ++it)
+			{
+				if ((packetText.size() + it->size() + 1) > MAX_COALESCED_LENGTH)
+					break;
+
+				packetText << ';' << *it;
+				packet.m_Commands.push_back(std::move(*it));
+			}
+		}
+
+		packet.m_StartTime = tfbd_clock_t::now();
+		packet.m_Future = client->send_command_async(packetText, false);
+		m_RunningPackets.push(std::move(packet));
+	}
+
+	m_PendingCommands.erase(m_PendingCommands.begin(), it);
+}
+
 void RCONActionManager::ProcessQueuedCommands()
 {
 	if (!m_Settings.m_Unsaved.m_RCONClient)
 		return;
 
 	const auto curTime = tfbd_clock_t::now();
-	if (curTime < (m_LastUpdateTime + UPDATE_INTERVAL))
-		return;
 
-	// Update periodic actions
-	for (const auto& generator : m_PeriodicActionGenerators)
-		generator->Execute(*this);
+	// Run whichever periodic generators are due. Everything they queue this update ends up
+	// coalesced together in SendPendingCommands().
+	m_GeneratorSchedule.Advance(curTime, [&](IPeriodicActionGenerator* generator)
+		{
+			generator->Execute(*this);
+
+			// If it failed (queue full), GetNextRunTime() is in the past and we just try again next tick
+			const auto nextRunTime = std::clamp(generator->GetNextRunTime(), curTime + SCHEDULER_TICK, curTime + MAX_GENERATOR_SLEEP);
+			m_GeneratorSchedule.Schedule(nextRunTime, generator);
+		});
 
 	if (!m_Actions.empty())
 	{
@@ -242,12 +357,7 @@ void RCONActionManager::ProcessQueuedCommands()
 				if (!args.empty())
 					cmd << ' ' << args;
 
-				m_Manager->m_RunningCommands.push(
-					{
-						.m_StartTime = tfbd_clock_t::now(),
-						.m_Command = cmd,
-						.m_Future = m_Manager->m_Settings.m_Unsaved.m_RCONClient->send_command_async(cmd, false),
-					});
+				m_Manager->m_PendingCommands.push_back(std::move(cmd));
 			}
 
 			RCONActionManager* m_Manager = nullptr;
@@ -258,6 +368,9 @@ void RCONActionManager::ProcessQueuedCommands()
 
 		const auto ProcessAction = [&](const IAction* action)
 		{
+			if (m_PendingCommands.size() >= MAX_PENDING_COMMANDS)
+				return false;
+
 			const ActionType type = action->GetType();
 			{
 				auto& previousMsg = actionTypes[(int)type];
@@ -285,7 +398,7 @@ void RCONActionManager::ProcessQueuedCommands()
 		}
 	}
 
-	m_LastUpdateTime = curTime;
+	SendPendingCommands();
 }
 
 void RCONActionManager::Update()
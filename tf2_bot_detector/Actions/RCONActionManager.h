@@ -1,7 +1,13 @@
 #pragma once
 
+#include "Clock.h"
 #include "IActionManager.h"
 
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
 namespace tf2_bot_detector
 {
 	class Settings;
@@ -11,5 +17,24 @@ namespace tf2_bot_detector
 	{
 	public:
 		static std::unique_ptr<IRCONActionManager> Create(const Settings& settings, IWorldState& world);
+
+		struct CommandRTTStats
+		{
+			// Bucket i counts round trips shorter than 2^i ms (that didn't fit in a smaller bucket).
+			// The last bucket holds everything slower.
+			static constexpr size_t BUCKET_COUNT = 12;
+			std::array<uint32_t, BUCKET_COUNT> m_Buckets{};
+
+			uint32_t m_Count = 0;
+			duration_t m_TotalRTT{};
+			duration_t m_MaxRTT{};
+
+			void AddSample(duration_t rtt);
+			duration_t GetAverageRTT() const { return m_Count > 0 ? (m_TotalRTT / m_Count) : duration_t{}; }
+		};
+
+		// Keyed by command name (without arguments). Commands that were sent together in one
+		// coalesced packet all share that packet's round trip time.
+		virtual std::map<std::string, CommandRTTStats, std::less<>> GetRTTStats() const = 0;
 	};
 }
@@ -10,7 +10,10 @@
 #include <mh/source_location.hpp>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <shared_mutex>
+#include <vector>
 
 using namespace tf2_bot_detector;
 
@@ -24,12 +27,24 @@ namespace
 	class AccountAges final : public IAccountAges
 	{
 	public:
+		AccountAges();
+
 		void OnDataReady(const SteamID& id, time_point_t creationTime) override;
 
 		std::optional<time_point_t> EstimateAccountCreationTime(const SteamID& id) const override;
 
 	private:
 		[[nodiscard]] bool CheckSteamIDValid(const SteamID& id, MH_SOURCE_LOCATION_AUTO(location)) const;
+
+		// In-memory copy of TABLE_ACCOUNT_AGES, sorted by account ID. This gets hit per player
+		// per frame by the scoreboard, so it needs to stay away from sqlite.
+		struct Sample
+		{
+			uint32_t m_AccountID;
+			time_point_t m_CreationTime;
+		};
+		std::vector<Sample> m_Samples;
+		mutable std::shared_mutex m_SamplesMutex;
 	};
 
 	static const std::filesystem::path ACCOUNT_AGES_FILENAME = "cfg/account_ages.json";
@@ -40,6 +55,29 @@ std::shared_ptr<IAccountAges> tf2_bot_detector::IAccountAges::Create()
 	return std::make_shared<AccountAges>();
 }
 
+AccountAges::AccountAges()
+{
+	// Not a function-try-block, that would rethrow after logging
+	try
+	{
+		const auto startTime = clock_t::now();
+
+		TF2BDApplication::GetApplication().GetTempDB().ForEachAccountAgeInfo([&](const DB::AccountAgeInfo& info)
+			{
+				// Rows come back in ascending order, so this stays sorted
+				assert(m_Samples.empty() || m_Samples.back().m_AccountID < info.m_SteamID.GetAccountID());
+				m_Samples.push_back({ info.m_SteamID.GetAccountID(), info.m_CreationTime });
+			});
+
+		DebugLog("Loaded {} account age samples in {}ms", m_Samples.size(), to_seconds<double>(clock_t::now() - startTime) * 1000);
+	}
+	catch (...)
+	{
+		m_Samples.clear();
+		LogException("Failed to load account ages, estimates will only use data from this session");
+	}
+}
+
 bool AccountAges::CheckSteamIDValid(const SteamID& id, const mh::source_location& location) const
 {
 	if (id.Type != SteamAccountType::Individual)
@@ -56,6 +94,19 @@ void AccountAges::OnDataReady(const SteamID& id, time_point_t creationTime)
 	if (!CheckSteamIDValid(id))
 		return;
 
+	{
+		std::lock_guard lock(m_SamplesMutex);
+
+		const auto accountID = id.GetAccountID();
+		auto it = std::lower_bound(m_Samples.begin(), m_Samples.end(), accountID,
+			[](const Sample& sample, uint32_t accountID) { return sample.m_AccountID < accountID; });
+
+		if (it != m_Samples.end() && it->m_AccountID == accountID)
+			it->m_CreationTime = creationTime;
+		else
+			m_Samples.insert(it, Sample{ accountID, creationTime });
+	}
+
 	DB::ITempDB& tempDB = TF2BDApplication::GetApplication().GetTempDB();
 	DB::AccountAgeInfo info{};
 	info.m_SteamID = id;
@@ -68,20 +119,30 @@ std::optional<time_point_t> AccountAges::EstimateAccountCreationTime(const Steam
 	if (!CheckSteamIDValid(id))
 		return std::nullopt;
 
-	std::optional<DB::AccountAgeInfo> lower, upper;
-	TF2BDApplication::GetApplication().GetTempDB().GetNearestAccountAgeInfos(id, lower, upper);
+	const auto accountID = id.GetAccountID();
+
+	std::shared_lock lock(m_SamplesMutex);
+
+	// First sample >= accountID
+	const auto upper = std::lower_bound(m_Samples.begin(), m_Samples.end(), accountID,
+		[](const Sample& sample, uint32_t accountID) { return sample.m_AccountID < accountID; });
 
-	if (!lower.has_value())
+	if (upper != m_Samples.end() && upper->m_AccountID == accountID)
+		return upper->m_CreationTime; // exact match
+
+	if (upper == m_Samples.begin())
 		return std::nullopt;   // super new, we don't have any data for this
-	if (!upper.has_value())
-		return lower.value().m_CreationTime;  // Nothing to interpolate to, pick the lower value
+
+	const auto lower = std::prev(upper);
+	if (upper == m_Samples.end())
+		return lower->m_CreationTime;  // Nothing to interpolate to, pick the lower value
 
 	if (lower->m_CreationTime == upper->m_CreationTime)
 		return lower->m_CreationTime;  // they're the same picture
 
 	// Interpolate the time between the nearest lower and upper steam ID
-	const auto interpValue = mh::remap(id.GetAccountID(),
-		lower->m_SteamID.GetAccountID(), upper->m_SteamID.GetAccountID(),
+	const auto interpValue = mh::remap(accountID,
+		lower->m_AccountID, upper->m_AccountID,
 		lower->m_CreationTime.time_since_epoch().count(), upper->m_CreationTime.time_since_epoch().count());
 
 	assert(interpValue >= 0);
@@ -1,12 +1,12 @@
 #define _SILENCE_CXX17_CODECVT_HEADER_DEPRECATION_WARNING 1
 
 #include "ChatWrappers.h"
+#include "LocalizationIndex.h"
 #include "Util/JSONUtils.h"
 #include "Util/TextUtils.h"
 #include "Log.h"
 
 #include <vdf_parser.hpp>
-#include <mh/coroutine/generator.hpp>
 #include <mh/text/fmtstr.hpp>
 #include <mh/text/string_insertion.hpp>
 #include <nlohmann/json.hpp>
@@ -16,6 +16,9 @@
 #include <compare>
 #include <concepts>
 #include <execution>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <random>
 #include <regex>
 #include <set>
@@ -256,39 +259,34 @@ static bool GetChatCategory(const std::string* src, std::string_view* name, Chat
 	return true;
 }
 
-static void GetChatMsgFormats(const std::string_view& debugInfo, const std::string_view& translations, ChatFormatStrings& strings)
+static void GetChatMsgFormats(const std::string_view& debugInfo, const std::vector<LocalizationToken>& tokens,
+	ChatFormatStrings& strings)
 {
-	assert(!translations.empty());
+	// Within a single file, the first occurrence of a key wins
+	std::array<bool, size_t(ChatCategory::COUNT)> foundEnglish{};
+	std::array<bool, size_t(ChatCategory::COUNT)> foundLocalized{};
 
-	const char* begin = translations.data();
-	const char* end = begin + translations.size();
-	std::error_code ec;
-	auto parsed = tyti::vdf::read(begin, end, ec);
-	if (ec)
-	{
-		LogError("Failed to parse translations from "s << std::quoted(debugInfo) << ": " << ec);
-		return;
-	}
+	std::string_view chatType;
+	bool isEnglish;
 
-	if (auto tokens = parsed.childs["Tokens"])
+	for (const auto& token : tokens)
 	{
-		std::string_view chatType;
-		bool isEnglish;
-
-		for (const auto& attrib : tokens->attribs)
-		{
-			ChatCategory cat;
-			if (!GetChatCategory(&attrib.first, &chatType, &cat, &isEnglish))
-				continue;
+		ChatCategory cat;
+		if (!GetChatCategory(&token.m_Key, &chatType, &cat, &isEnglish))
+			continue;
 
-			if (attrib.second.empty())
-			{
-				LogWarning(MH_SOURCE_LOCATION_CURRENT(), "{}: Empty value read for {} ({})",
-					std::quoted(debugInfo), std::quoted(attrib.first), mh::enum_fmt(cat));
-			}
+		if (auto& found = (isEnglish ? foundEnglish : foundLocalized)[(int)cat]; found)
+			continue;
+		else
+			found = true;
 
-			(isEnglish ? strings.m_English : strings.m_Localized)[(int)cat] = attrib.second;
+		if (token.m_Value.empty())
+		{
+			LogWarning(MH_SOURCE_LOCATION_CURRENT(), "{}: Empty value read for {} ({})",
+				std::quoted(debugInfo), std::quoted(token.m_Key), mh::enum_fmt(cat));
 		}
+
+		(isEnglish ? strings.m_English : strings.m_Localized)[(int)cat] = token.m_Value;
 	}
 }
 
@@ -322,64 +320,83 @@ static void ApplyChatWrappers(const std::string_view& debugInfo, ChatCategory ca
 	translation = std::move(replaced);
 }
 
-static mh::generator<std::filesystem::path> GetLocalizationFiles(
-	const std::filesystem::path& tfDir, const std::string_view& language, bool baseFirst = true)
+namespace
 {
-	if (baseFirst)
+	// Kept around for the whole session, so running the setup flow again only has to look at
+	// folders and files that changed since last time.
+	class ChatLocalizationCache final
 	{
-		if (auto path = tfDir / "resource" / ("tf_"s << language << ".txt"); std::filesystem::exists(path))
-			co_yield path;
-		if (auto path = tfDir / "resource" / ("chat_"s << language << ".txt"); std::filesystem::exists(path))
-			co_yield path;
-	}
+	public:
+		static ChatLocalizationCache& Get()
+		{
+			static ChatLocalizationCache s_Cache;
+			return s_Cache;
+		}
 
-	for (const auto& customDirEntry : std::filesystem::directory_iterator(tfDir / "custom"))
-	{
-		if (!customDirEntry.is_directory())
-			continue;
+		void UpdateIndex(const std::filesystem::path& tfDir)
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Index.Update(tfDir);
+		}
 
-		const auto customDir = customDirEntry.path();
-		if (!std::filesystem::exists(customDir / "resource"))
-			continue;
+		std::vector<std::filesystem::path> GetFiles(const std::string_view& language) const
+		{
+			std::lock_guard lock(m_Mutex);
+			return m_Index.GetFiles(language);
+		}
 
-		if (customDir.filename() == TF2BD_CHAT_WRAPPERS_DIR)
-			continue;
+		// The TF_Chat_ tokens in the given file, only re-read if the file was modified
+		std::shared_ptr<const std::vector<LocalizationToken>> GetChatTokens(const std::filesystem::path& path);
 
-		if (auto path = customDir / "resource" / ("tf_"s << language << ".txt"); std::filesystem::exists(path))
-			co_yield path;
-		if (auto path = customDir / "resource" / ("chat_"s << language << ".txt"); std::filesystem::exists(path))
-			co_yield path;
-	}
+	private:
+		mutable std::mutex m_Mutex;
+		LocalizationIndex m_Index;
 
-	if (!baseFirst)
-	{
-		if (auto path = tfDir / "resource" / ("tf_"s << language << ".txt"); std::filesystem::exists(path))
-			co_yield path;
-		if (auto path = tfDir / "resource" / ("chat_"s << language << ".txt"); std::filesystem::exists(path))
-			co_yield path;
-	}
+		struct CachedFile
+		{
+			std::filesystem::file_time_type m_WriteTime{};
+			uintmax_t m_Size{};
+			std::shared_ptr<const std::vector<LocalizationToken>> m_Tokens;
+		};
+		std::map<std::filesystem::path, CachedFile> m_Files;
+	};
 }
 
-static std::filesystem::path FindExistingChatTranslationFile(
-	const std::filesystem::path& tfDir, const std::string_view& language)
+std::shared_ptr<const std::vector<LocalizationToken>> ChatLocalizationCache::GetChatTokens(
+	const std::filesystem::path& path)
 {
-	const auto desiredFilename = "chat_"s << language << ".txt";
-	for (const auto& path : GetLocalizationFiles(tfDir, language, false))
+	CachedFile file;
+	file.m_WriteTime = std::filesystem::last_write_time(path);
+	file.m_Size = std::filesystem::file_size(path);
+
 	{
-		//Log("Filename: "s << path.filename());
-		if (path.filename() == desiredFilename)
-			return path;
+		std::lock_guard lock(m_Mutex);
+		if (auto found = m_Files.find(path); found != m_Files.end() &&
+			found->second.m_WriteTime == file.m_WriteTime && found->second.m_Size == file.m_Size)
+		{
+			return found->second.m_Tokens;
+		}
 	}
 
-	return {};
+	file.m_Tokens = std::make_shared<const std::vector<LocalizationToken>>(
+		ReadLocalizationTokens(path, { "TF_Chat_"sv, "[english]TF_Chat_"sv }));
+
+	std::lock_guard lock(m_Mutex);
+	return (m_Files[path] = std::move(file)).m_Tokens;
 }
 
-static ChatFormatStrings FindExistingTranslations(const std::filesystem::path& tfdir, const std::string_view& language)
+static ChatFormatStrings FindExistingTranslations(ChatLocalizationCache& cache, const std::string_view& language)
 {
 	ChatFormatStrings retVal;
 
-	for (const auto& filename : GetLocalizationFiles(tfdir, language))
-		GetChatMsgFormats(filename.string(), ToMB(ReadWideFile(filename)), retVal);
+	for (const auto& filename : cache.GetFiles(language))
+	{
+		// Our own folder, left over from last time
+		if (filename.parent_path().parent_path().filename() == TF2BD_CHAT_WRAPPERS_DIR)
+			continue;
+
+		GetChatMsgFormats(filename.string(), *cache.GetChatTokens(filename), retVal);
+	}
 
 	return retVal;
 }
@@ -668,6 +685,9 @@ ChatWrappers tf2_bot_detector::RandomizeChatWrappers(const std::filesystem::path
 		progressSource.set(progress);
 	};
 
+	auto& localizationCache = ChatLocalizationCache::Get();
+	localizationCache.UpdateIndex(tfdir);
+
 	ChatFormatStrings translations[std::size(LANGUAGES)];
 	ChatFmtStrLengths translationLengths;
 
@@ -679,7 +699,7 @@ ChatWrappers tf2_bot_detector::RandomizeChatWrappers(const std::filesystem::path
 			[&](const std::string_view& lang)
 			{
 				const size_t index = &lang - std::begin(LANGUAGES);
-				const auto& localTrans = translations[index] = FindExistingTranslations(tfdir, lang);
+				const auto& localTrans = translations[index] = FindExistingTranslations(localizationCache, lang);
 
 				ChatFmtStrLengths localLengths;
 
@@ -8,6 +8,8 @@
 #include <mh/text/string_insertion.hpp>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+
 using namespace tf2_bot_detector;
 
 DRPInfo::DRPInfo(const Settings& settings) :
@@ -28,11 +30,8 @@ auto DRPInfo::FindMap(const std::string_view& name) const -> const Map*
 		try
 		{
 			auto& drpInfo = m_DRPInfo.get();
-			for (const auto& map : drpInfo.m_Maps)
-			{
-				if (map.Matches(name))
-					return &map;
-			}
+			if (const size_t index = drpInfo.m_MapMatcher.Find(name); index != MapMatcher::npos)
+				return &drpInfo.m_Maps.at(index);
 		}
 		catch (...)
 		{
@@ -63,6 +62,8 @@ void DRPInfo::DRPFile::Deserialize(const nlohmann::json& json)
 		try_get_to_defaulted(it.value(), map.m_LargeImageKeyOverride, "large_image_key_override");
 		m_Maps.push_back(std::move(map));
 	}
+
+	m_MapMatcher = MapMatcher(m_Maps);
 }
 
 void DRPInfo::DRPFile::Serialize(nlohmann::json& json) const
@@ -156,3 +157,124 @@ bool DRPInfo::Map::Matches(const std::string_view& mapName) const
 
 	return false;
 }
+
+static bool IsASCIIDigit(char c) { return c >= '0' && c <= '9'; }
+static bool IsASCIIAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+std::string_view DRPInfo::MapMatcher::StripVersionSuffix(const std::string_view& mapName)
+{
+	// Hand-written version of the suffix part of the regex in Map::Matches:
+	// _(?:rc|final|[abv])\d*[a-zA-Z]? after the last underscore
+	const auto underscore = mapName.rfind('_');
+	if (underscore == mapName.npos)
+		return mapName;
+
+	std::string_view suffix = mapName.substr(underscore + 1);
+	if (suffix.starts_with("rc"))
+		suffix.remove_prefix(2);
+	else if (suffix.starts_with("final"))
+		suffix.remove_prefix(5);
+	else if (suffix.starts_with('a') || suffix.starts_with('b') || suffix.starts_with('v'))
+		suffix.remove_prefix(1);
+	else
+		return mapName;
+
+	while (!suffix.empty() && IsASCIIDigit(suffix.front()))
+		suffix.remove_prefix(1);
+
+	if (!suffix.empty() && IsASCIIAlpha(suffix.front()))
+		suffix.remove_prefix(1);
+
+	return suffix.empty() ? mapName.substr(0, underscore) : mapName;
+}
+
+void DRPInfo::MapMatcher::AddName(std::unordered_map<std::string, size_t>& names, std::string name, size_t mapIndex)
+{
+	// Earlier maps win, just like the linear search
+	names.emplace(mh::tolower(name), mapIndex);
+}
+
+DRPInfo::MapMatcher::MapMatcher(const std::vector<Map>& maps)
+{
+	std::string combinedRegex;
+
+	for (size_t i = 0; i < maps.size(); i++)
+	{
+		const auto& mapNames = maps[i].m_MapNames;
+		if (mapNames.empty())
+			continue;
+
+		// The ? after the name in Map::Matches makes the last character of the name optional too
+		const std::string& baseName = mapNames[0];
+		AddName(m_BaseNames, baseName, i);
+		if (!baseName.empty())
+			AddName(m_BaseNames, baseName.substr(0, baseName.size() - 1), i);
+
+		for (size_t n = 1; n < mapNames.size(); n++)
+		{
+			const std::string& alias = mapNames[n];
+			if (std::all_of(alias.begin(), alias.end(), [](char c) { return IsASCIIDigit(c) || IsASCIIAlpha(c) || c == '_'; }))
+			{
+				AddName(m_ExactNames, alias, i);
+				continue;
+			}
+
+			try
+			{
+				m_RegexAliases.push_back({ i, std::regex(alias, std::regex::icase) });
+			}
+			catch (const std::exception& e)
+			{
+				LogError(MH_SOURCE_LOCATION_CURRENT(), mh::format("{}: {}: {}", std::quoted(alias), typeid(e).name(), e.what()));
+				continue;
+			}
+
+			if (!combinedRegex.empty())
+				combinedRegex += '|';
+
+			combinedRegex += "(?:";
+			combinedRegex += alias;
+			combinedRegex += ')';
+		}
+	}
+
+	if (!combinedRegex.empty())
+		m_CombinedRegex = std::regex(combinedRegex, std::regex::icase | std::regex::optimize);
+}
+
+size_t DRPInfo::MapMatcher::Find(const std::string_view& mapName) const
+{
+	const std::string lowerName = mh::tolower(mapName);
+	size_t result = npos;
+
+	const auto FindName = [&](const std::unordered_map<std::string, size_t>& names, const std::string& name)
+	{
+		if (auto found = names.find(name); found != names.end())
+			result = std::min(result, found->second);
+	};
+
+	FindName(m_BaseNames, lowerName);
+	FindName(m_ExactNames, lowerName);
+
+	if (const auto stripped = StripVersionSuffix(lowerName); stripped.size() != lowerName.size())
+		FindName(m_BaseNames, std::string(stripped));
+
+	// Only bother with the regexes if they could beat what we already found
+	if (!m_RegexAliases.empty() && m_RegexAliases.front().m_MapIndex < result &&
+		std::regex_match(mapName.begin(), mapName.end(), m_CombinedRegex))
+	{
+		for (const auto& alias : m_RegexAliases)
+		{
+			if (alias.m_MapIndex >= result)
+				break;
+
+			if (std::regex_match(mapName.begin(), mapName.end(), alias.m_Regex))
+			{
+				result = alias.m_MapIndex;
+				break;
+			}
+		}
+	}
+
+	return result;
+}
@@ -8,6 +8,8 @@
 #include <regex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace tf2_bot_detector
 {
@@ -29,8 +31,47 @@ namespace tf2_bot_detector
 			std::string m_LargeImageKeyOverride;
 		};
 
+		// Index over a map table, built once when the table is loaded. Gives the same result as
+		// calling Map::Matches on each map in order, but most lookups are a couple of hash lookups.
+		class MapMatcher final
+		{
+		public:
+			static constexpr size_t npos = size_t(-1);
+
+			MapMatcher() = default;
+			explicit MapMatcher(const std::vector<Map>& maps);
+
+			// Index of the first map that matches, or npos if none of them do
+			size_t Find(const std::string_view& mapName) const;
+
+			// "pl_upward_rc3" -> "pl_upward". Expects a lowercase name, returns mapName if it has no suffix.
+			static std::string_view StripVersionSuffix(const std::string_view& mapName);
+
+		private:
+			void AddName(std::unordered_map<std::string, size_t>& names, std::string name, size_t mapIndex);
+
+			// Lowercase m_MapNames[0], which also match with a version suffix
+			std::unordered_map<std::string, size_t> m_BaseNames;
+
+			// Lowercase aliases that don't use any regex syntax
+			std::unordered_map<std::string, size_t> m_ExactNames;
+
+			// Everything else, in map order. m_CombinedRegex matches if any of these do, so we
+			// only have to check them one by one for names that are actually aliases.
+			struct RegexAlias
+			{
+				size_t m_MapIndex;
+				std::regex m_Regex;
+			};
+			std::vector<RegexAlias> m_RegexAliases;
+			std::regex m_CombinedRegex;
+		};
+
 		const Map* FindMap(const std::string_view& name) const;
 
+		// FindMap always returns nullptr until this is true
+		bool IsLoaded() const { return m_DRPInfo.is_ready(); }
+
 	private:
 		const Settings* m_Settings = nullptr;
 
@@ -45,6 +86,7 @@ namespace tf2_bot_detector
 			static constexpr int DRP_SCHEMA_VERSION = 3;
 
 			std::vector<Map> m_Maps;
+			MapMatcher m_MapMatcher;
 		};
 
 		mh::task<DRPFile> m_DRPInfo;
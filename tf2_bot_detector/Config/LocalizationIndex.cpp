@@ -0,0 +1,298 @@
+#include "LocalizationIndex.h"
+#include "Util/TextUtils.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <execution>
+#include <fstream>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	template<typename CharT>
+	bool IsSpace(CharT c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+
+	template<typename CharT>
+	bool StartsWithASCII(const std::basic_string_view<CharT>& str, const std::string_view& prefix)
+	{
+		if (str.size() < prefix.size())
+			return false;
+
+		for (size_t i = 0; i < prefix.size(); i++)
+		{
+			if (str[i] != CharT(prefix[i]))
+				return false;
+		}
+
+		return true;
+	}
+
+	std::string ToString(const std::string_view& str) { return std::string(str); }
+	std::string ToString(const std::u16string_view& str) { return ToMB(str); }
+
+	// Same as the vdf parser, the only escape sequence that gets removed is \"
+	std::string UnescapeQuotes(std::string str)
+	{
+		for (size_t i = str.find("\\\""); i != str.npos; i = str.find("\\\"", i + 1))
+			str.erase(i, 1);
+
+		return str;
+	}
+
+	template<typename CharT>
+	void ExtractTokens(const std::basic_string_view<CharT>& text,
+		const std::initializer_list<std::string_view>& keyPrefixes, std::vector<LocalizationToken>& tokens)
+	{
+		using view_t = std::basic_string_view<CharT>;
+
+		bool hasKey = false;
+		view_t key;
+
+		size_t i = 0;
+		while (i < text.size())
+		{
+			const CharT c = text[i];
+			if (IsSpace(c))
+			{
+				i++;
+			}
+			else if (c == '/' && (i + 1) < text.size() && text[i + 1] == '/')
+			{
+				// Comment
+				i = text.find(CharT('\n'), i);
+			}
+			else if (c == '{' || c == '}')
+			{
+				// Whatever came before this was the name of a block, not a key
+				hasKey = false;
+				i++;
+			}
+			else if (c == '[')
+			{
+				// Platform conditional, eg [$WIN32]
+				i = text.find(CharT(']'), i);
+				if (i != text.npos)
+					i++;
+			}
+			else
+			{
+				view_t token;
+				if (c == '"')
+				{
+					size_t end = i + 1;
+					while ((end = text.find(CharT('"'), end)) != text.npos && text[end - 1] == '\\')
+						end++;
+
+					if (end == text.npos)
+						break;
+
+					token = text.substr(i + 1, end - i - 1);
+					i = end + 1;
+				}
+				else
+				{
+					const size_t begin = i;
+					while (i < text.size() && !IsSpace(text[i]) && text[i] != '"' && text[i] != '{' && text[i] != '}')
+						i++;
+
+					token = text.substr(begin, i - begin);
+				}
+
+				if (!hasKey)
+				{
+					key = token;
+					hasKey = true;
+					continue;
+				}
+
+				hasKey = false;
+				for (const auto& prefix : keyPrefixes)
+				{
+					if (StartsWithASCII(key, prefix))
+					{
+						tokens.push_back({ UnescapeQuotes(ToString(key)), UnescapeQuotes(ToString(token)) });
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
+std::vector<LocalizationToken> tf2_bot_detector::ExtractLocalizationTokens(const std::string_view& fileData,
+	std::initializer_list<std::string_view> keyPrefixes)
+{
+	std::vector<LocalizationToken> tokens;
+
+	if (fileData.starts_with("\xFF\xFE"sv))
+	{
+		// UTF-16LE. Work on the raw code units, only the tokens we actually want get converted.
+		std::u16string wide((fileData.size() - 2) / sizeof(char16_t), u'\0');
+		std::memcpy(wide.data(), fileData.data() + 2, wide.size() * sizeof(char16_t));
+		ExtractTokens(std::u16string_view(wide), keyPrefixes, tokens);
+	}
+	else
+	{
+		std::string_view text = fileData;
+		if (text.starts_with("\xEF\xBB\xBF"sv))
+			text.remove_prefix(3);
+
+		ExtractTokens(text, keyPrefixes, tokens);
+	}
+
+	return tokens;
+}
+
+std::vector<LocalizationToken> tf2_bot_detector::ReadLocalizationTokens(const std::filesystem::path& path,
+	std::initializer_list<std::string_view> keyPrefixes)
+{
+	std::string fileData;
+	{
+		std::ifstream file;
+		file.exceptions(std::ios::badbit | std::ios::failbit);
+		file.open(path, std::ios::binary);
+
+		file.seekg(0, std::ios::end);
+		fileData.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0, std::ios::beg);
+		file.read(fileData.data(), fileData.size());
+	}
+
+	return ExtractLocalizationTokens(fileData, keyPrefixes);
+}
+
+void LocalizationIndex::ResourceDir::Update()
+{
+	// Most custom folders don't have a resource folder at all. That's remembered as a write time of
+	// zero, so one showing up later still triggers a scan.
+	std::error_code ec;
+	const auto writeTime = std::filesystem::last_write_time(m_Path, ec);
+	if (ec)
+	{
+		m_WriteTime = {};
+		m_Files.clear();
+		m_Scanned = true;
+		return;
+	}
+
+	if (m_Scanned && writeTime == m_WriteTime)
+		return;
+
+	m_WriteTime = writeTime;
+	m_Files.clear();
+	m_Scanned = true;
+
+	for (const auto& entry : std::filesystem::directory_iterator(m_Path, ec))
+	{
+		// Paths are case insensitive on windows, so the game would load TF_English.txt too
+		const auto u8Filename = entry.path().filename().u8string();
+		std::string filename(reinterpret_cast<const char*>(u8Filename.data()), u8Filename.size());
+		std::transform(filename.begin(), filename.end(), filename.begin(),
+			[](char c) { return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c; });
+
+		std::string_view name = filename;
+		if (!name.ends_with(".txt"sv))
+			continue;
+
+		name.remove_suffix(4);
+
+		LocalizationFile file;
+		if (name.starts_with("tf_"sv))
+		{
+			name.remove_prefix(3);
+		}
+		else if (name.starts_with("chat_"sv))
+		{
+			name.remove_prefix(5);
+			file.m_IsChat = true;
+		}
+		else
+		{
+			continue;
+		}
+
+		if (std::error_code fileEC; name.empty() || !entry.is_regular_file(fileEC))
+			continue;
+
+		file.m_Path = entry.path();
+		file.m_Language = name;
+		m_Files.push_back(std::move(file));
+	}
+
+	if (ec)
+		LogWarning(MH_SOURCE_LOCATION_CURRENT(), "Failed to list {}: {}", m_Path, ec.message());
+}
+
+void LocalizationIndex::Update(const std::filesystem::path& tfDir)
+{
+	if (m_TFDir != tfDir)
+	{
+		*this = {};
+		m_TFDir = tfDir;
+		m_BaseResourceDir.m_Path = tfDir / "resource";
+	}
+
+	m_BaseResourceDir.Update();
+
+	const auto customDir = tfDir / "custom";
+	std::error_code ec;
+	if (const auto customDirWriteTime = std::filesystem::last_write_time(customDir, ec);
+		ec || customDirWriteTime != m_CustomDirWriteTime)
+	{
+		// Folders were added or removed, keep the ones we already know about
+		std::vector<ResourceDir> resourceDirs;
+		for (const auto& entry : std::filesystem::directory_iterator(customDir, ec))
+		{
+			if (std::error_code dirEC; !entry.is_directory(dirEC))
+				continue;
+
+			auto& dir = resourceDirs.emplace_back();
+			dir.m_Path = entry.path() / "resource";
+			if (auto found = std::lower_bound(m_CustomResourceDirs.begin(), m_CustomResourceDirs.end(), dir.m_Path,
+				[](const ResourceDir& existing, const std::filesystem::path& path) { return existing.m_Path < path; });
+				found != m_CustomResourceDirs.end() && found->m_Path == dir.m_Path)
+			{
+				dir = *found;
+			}
+		}
+
+		std::sort(resourceDirs.begin(), resourceDirs.end(),
+			[](const ResourceDir& lhs, const ResourceDir& rhs) { return lhs.m_Path < rhs.m_Path; });
+
+		m_CustomDirWriteTime = ec ? std::filesystem::file_time_type{} : customDirWriteTime;
+		m_CustomResourceDirs = std::move(resourceDirs);
+	}
+
+	// Mostly waiting on the filesystem
+	std::for_each(std::execution::par, m_CustomResourceDirs.begin(), m_CustomResourceDirs.end(),
+		[](ResourceDir& dir) { dir.Update(); });
+}
+
+std::vector<std::filesystem::path> LocalizationIndex::GetFiles(const std::string_view& language) const
+{
+	std::vector<std::filesystem::path> files;
+
+	const auto AddFiles = [&](const ResourceDir& dir)
+	{
+		for (bool isChat : { false, true })
+		{
+			for (const auto& file : dir.m_Files)
+			{
+				if (file.m_IsChat == isChat && file.m_Language == language)
+					files.push_back(file.m_Path);
+			}
+		}
+	};
+
+	AddFiles(m_BaseResourceDir);
+	for (const auto& dir : m_CustomResourceDirs)
+		AddFiles(dir);
+
+	return files;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <filesystem>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	struct LocalizationToken
+	{
+		std::string m_Key;
+		std::string m_Value;
+	};
+
+	// Pulls "key" "value" pairs out of a valve localization file (UTF-16LE with a BOM, or UTF-8) without
+	// parsing or converting the whole thing. Only tokens with a key starting with one of keyPrefixes are
+	// converted and returned, in file order.
+	std::vector<LocalizationToken> ExtractLocalizationTokens(const std::string_view& fileData,
+		std::initializer_list<std::string_view> keyPrefixes);
+	std::vector<LocalizationToken> ReadLocalizationTokens(const std::filesystem::path& path,
+		std::initializer_list<std::string_view> keyPrefixes);
+
+	// The tf_<language>.txt and chat_<language>.txt files in tf/resource and tf/custom/*/resource.
+	// Directory listings are kept between calls to Update, and a folder is only listed again if its
+	// last write time changed, so updating is cheap even with hundreds of custom folders.
+	class LocalizationIndex final
+	{
+	public:
+		void Update(const std::filesystem::path& tfDir);
+
+		// Files for the given (lowercase) language in the order the game loads them: tf/resource first,
+		// then custom folders in alphabetical order. tf_ comes before chat_ in each folder.
+		std::vector<std::filesystem::path> GetFiles(const std::string_view& language) const;
+
+	private:
+		struct LocalizationFile
+		{
+			std::filesystem::path m_Path;
+			std::string m_Language;
+			bool m_IsChat = false;
+		};
+
+		struct ResourceDir
+		{
+			std::filesystem::path m_Path;
+			std::filesystem::file_time_type m_WriteTime{};
+			bool m_Scanned = false;
+			std::vector<LocalizationFile> m_Files;
+
+			void Update();
+		};
+
+		std::filesystem::path m_TFDir;
+		ResourceDir m_BaseResourceDir;
+
+		std::filesystem::file_time_type m_CustomDirWriteTime{};
+		std::vector<ResourceDir> m_CustomResourceDirs;  // Sorted by custom folder name
+	};
+}
@@ -116,6 +116,7 @@ namespace tf2_bot_detector
 		{
 			{ "rcon_packets", d.m_RCONPackets },
 			{ "discord_rich_presence", d.m_DiscordRichPresence },
+			{ "event_journal", d.m_EventJournal },
 		};
 	}
 	void from_json(const nlohmann::json& j, Settings::Logging& d)
@@ -124,6 +125,7 @@ namespace tf2_bot_detector
 
 		try_get_to_defaulted(j, d.m_RCONPackets, "rcon_packets", DEFAULTS.m_RCONPackets);
 		try_get_to_defaulted(j, d.m_DiscordRichPresence, "discord_rich_presence", DEFAULTS.m_DiscordRichPresence);
+		try_get_to_defaulted(j, d.m_EventJournal, "event_journal", DEFAULTS.m_EventJournal);
 	}
 
 	void to_json(nlohmann::json& j, const Settings::UIState::MainWindow& d)
@@ -134,6 +136,7 @@ namespace tf2_bot_detector
 			{ "chat_enabled", d.m_ChatEnabled },
 			{ "scoreboard_enabled", d.m_ScoreboardEnabled },
 			{ "team_stats_enabled", d.m_TeamStatsEnabled },
+			{ "chat_history_length", d.m_ChatHistoryLength },
 		};
 	}
 	void from_json(const nlohmann::json& j, Settings::UIState::MainWindow& d)
@@ -143,6 +146,7 @@ namespace tf2_bot_detector
 		try_get_to_defaulted(j, d, &MainWindow::m_ChatEnabled, "chat_enabled");
 		try_get_to_defaulted(j, d, &MainWindow::m_ScoreboardEnabled, "scoreboard_enabled");
 		try_get_to_defaulted(j, d, &MainWindow::m_TeamStatsEnabled, "team_stats_enabled");
+		try_get_to_defaulted(j, d, &MainWindow::m_ChatHistoryLength, "chat_history_length");
 	}
 
 	void to_json(nlohmann::json& j, const Settings::UIState& d)
@@ -138,6 +138,7 @@ namespace tf2_bot_detector
 		{
 			bool m_RCONPackets = false;
 			bool m_DiscordRichPresence = false;
+			bool m_EventJournal = false;
 
 		} m_Logging;
 
@@ -155,6 +156,7 @@ namespace tf2_bot_detector
 				bool m_ScoreboardEnabled = true;
 				bool m_AppLogEnabled = true;
 				bool m_TeamStatsEnabled = true;
+				uint32_t m_ChatHistoryLength = 512;
 
 			} m_MainWindow;
 
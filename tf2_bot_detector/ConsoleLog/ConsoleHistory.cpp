@@ -0,0 +1,217 @@
+#include "ConsoleHistory.h"
+#include "ConsoleLines.h"
+#include "GameData/UserMessageType.h"
+#include "Log.h"
+#include "WorldState.h"
+
+#include <mh/text/format.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <utility>
+
+#undef GetMessage
+
+using namespace tf2_bot_detector;
+
+ConsoleHistory::ConsoleHistory(size_t capacity)
+{
+	capacity = std::clamp(capacity, MIN_CAPACITY, MAX_CAPACITY);
+	m_Records.resize(capacity);
+	m_Arena.resize(capacity * TEXT_BYTES_PER_RECORD);
+}
+
+void ConsoleHistory::SetCapacity(size_t capacity)
+{
+	capacity = std::clamp(capacity, MIN_CAPACITY, MAX_CAPACITY);
+	if (capacity == GetCapacity())
+		return;
+
+	ConsoleHistory newHistory(capacity);
+
+	const size_t keepCount = std::min(m_Count, capacity);
+	newHistory.m_NextID = GetFirstID() + (m_Count - keepCount);
+	for (size_t i = m_Count - keepCount; i < m_Count; i++)
+	{
+		const ConsoleHistoryRecord& record = (*this)[i];
+		ConsoleHistoryRecord& newRecord = newHistory.AddRecord(record.m_Type, record.m_Timestamp,
+			GetName(record), GetText(record));
+
+		// Everything except where the text ended up
+		ConsoleHistoryRecord copy = record;
+		copy.m_ID = newRecord.m_ID;
+		copy.m_TextOffset = newRecord.m_TextOffset;
+		copy.m_NameLength = newRecord.m_NameLength;
+		copy.m_TextLength = newRecord.m_TextLength;
+		newRecord = copy;
+	}
+
+	*this = std::move(newHistory);
+}
+
+void ConsoleHistory::clear()
+{
+	m_First = 0;
+	m_Count = 0;
+}
+
+const ConsoleHistoryRecord& ConsoleHistory::operator[](size_t index) const
+{
+	assert(index < m_Count);
+	return m_Records[(m_First + index) % m_Records.size()];
+}
+
+ConsoleHistoryRecord& ConsoleHistory::operator[](size_t index)
+{
+	return const_cast<ConsoleHistoryRecord&>(std::as_const(*this)[index]);
+}
+
+const ConsoleHistoryRecord* ConsoleHistory::FindByID(uint64_t id) const
+{
+	if (id < GetFirstID() || id >= m_NextID)
+		return nullptr;
+
+	return &(*this)[id - GetFirstID()];
+}
+
+ConsoleHistoryRecord* ConsoleHistory::FindByID(uint64_t id)
+{
+	return const_cast<ConsoleHistoryRecord*>(std::as_const(*this).FindByID(id));
+}
+
+bool ConsoleHistory::Add(const IConsoleLine& line)
+{
+	if (!line.ShouldPrint())
+		return false;
+
+	switch (line.GetType())
+	{
+	case ConsoleLineType::Chat:
+	{
+		auto& chatLine = static_cast<const ChatConsoleLine&>(line);
+		AddChat(line.GetTimestamp(), chatLine.GetPlayerSteamID(), chatLine.GetPlayerName(), chatLine.GetMessage(),
+			chatLine.IsDead(), chatLine.IsTeam(), chatLine.IsSelf(), chatLine.GetTeamShareResult());
+		return true;
+	}
+	case ConsoleLineType::LobbyChanged:
+		AddSeparator(line.GetTimestamp());
+		return true;
+	case ConsoleLineType::SVC_UserMessage:
+		AddText(line.GetTimestamp(), { 0, 1, 1, 1 },
+			mh::format("{}", mh::enum_fmt(static_cast<const SVCUserMessageLine&>(line).GetUserMessageType())));
+		return true;
+	case ConsoleLineType::TeamsSwitched:
+		AddText(line.GetTimestamp(), { 0.98f, 0.73f, 0.01f, 1 }, "Teams have been switched.");
+		return true;
+
+	default:
+		LogError(MH_SOURCE_LOCATION_CURRENT(), "Unexpected printable console line type {}", int(line.GetType()));
+		return false;
+	}
+}
+
+void ConsoleHistory::AddChat(time_point_t timestamp, SteamID steamID, const std::string_view& playerName,
+	const std::string_view& message, bool isDead, bool isTeam, bool isSelf, TeamShareResult teamShareResult)
+{
+	ConsoleHistoryRecord& record = AddRecord(ConsoleHistoryRecordType::Chat, timestamp, playerName, message);
+	record.m_SteamID = steamID;
+	record.m_IsDead = isDead;
+	record.m_IsTeam = isTeam;
+	record.m_IsSelf = isSelf;
+	record.m_TeamShareResult = teamShareResult;
+}
+
+void ConsoleHistory::AddSeparator(time_point_t timestamp)
+{
+	AddRecord(ConsoleHistoryRecordType::Separator, timestamp, {}, {});
+}
+
+void ConsoleHistory::AddText(time_point_t timestamp, const std::array<float, 4>& color, const std::string_view& text)
+{
+	AddRecord(ConsoleHistoryRecordType::Text, timestamp, {}, text).m_Color = color;
+}
+
+ConsoleHistoryRecord& ConsoleHistory::AddRecord(ConsoleHistoryRecordType type, time_point_t timestamp,
+	std::string_view name, std::string_view text)
+{
+	if (m_Count == m_Records.size())
+		PopOldest();
+
+	// Anything longer than the whole arena is truncated, chat messages never get anywhere close
+	const size_t arenaSize = m_Arena.size();
+	name = name.substr(0, arenaSize);
+	text = text.substr(0, arenaSize - name.size());
+	const size_t length = name.size() + text.size();
+
+	// Don't let text wrap around the end of the arena, so it can always be returned as a single string_view
+	uint64_t start = m_ArenaHead;
+	if ((start % arenaSize) + length > arenaSize)
+		start += arenaSize - (start % arenaSize);
+
+	const uint64_t end = start + length;
+
+	// Drop the records whose text we are about to overwrite
+	while (m_Count > 0 && end > arenaSize && (*this)[0].m_TextOffset < (end - arenaSize))
+		PopOldest();
+
+	char* dest = m_Arena.data() + (start % arenaSize);
+	std::copy(name.begin(), name.end(), dest);
+	std::copy(text.begin(), text.end(), dest + name.size());
+	m_ArenaHead = end;
+
+	ConsoleHistoryRecord& record = m_Records[(m_First + m_Count) % m_Records.size()];
+	m_Count++;
+
+	record = {};
+	record.m_ID = m_NextID++;
+	record.m_Type = type;
+	record.m_Timestamp = timestamp;
+	record.m_TextOffset = start;
+	record.m_NameLength = uint32_t(name.size());
+	record.m_TextLength = uint32_t(text.size());
+	return record;
+}
+
+void ConsoleHistory::PopOldest()
+{
+	assert(m_Count > 0);
+	m_First = (m_First + 1) % m_Records.size();
+	m_Count--;
+}
+
+std::string_view ConsoleHistory::GetArenaView(uint64_t offset, size_t length) const
+{
+	if (length == 0)
+		return {};
+
+	return std::string_view(m_Arena.data() + (offset % m_Arena.size()), length);
+}
+
+std::string_view ConsoleHistory::GetName(const ConsoleHistoryRecord& record) const
+{
+	return GetArenaView(record.m_TextOffset, record.m_NameLength);
+}
+
+std::string_view ConsoleHistory::GetText(const ConsoleHistoryRecord& record) const
+{
+	return GetArenaView(record.m_TextOffset + record.m_NameLength, record.m_TextLength);
+}
+
+void ConsoleHistory::Find(const std::string_view& filter, std::vector<uint64_t>& results, uint64_t startID) const
+{
+	const auto Contains = [&](const std::string_view& str)
+	{
+		return std::search(str.begin(), str.end(), filter.begin(), filter.end(), [](char a, char b)
+			{
+				return std::tolower((unsigned char)a) == std::tolower((unsigned char)b);
+			}) != str.end();
+	};
+
+	for (size_t i = std::max(startID, GetFirstID()) - GetFirstID(); i < m_Count; i++)
+	{
+		const ConsoleHistoryRecord& record = (*this)[i];
+		if (filter.empty() || Contains(GetName(record)) || Contains(GetText(record)))
+			results.push_back(record.m_ID);
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Clock.h"
+#include "SteamID.h"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	class IConsoleLine;
+	enum class TeamShareResult;
+
+	enum class ConsoleHistoryRecordType : uint8_t
+	{
+		Chat,
+		Separator,
+		Text,
+	};
+
+	// Just enough about a printed console line to draw it again later
+	struct ConsoleHistoryRecord
+	{
+		uint64_t m_ID = 0;
+		time_point_t m_Timestamp{};
+		SteamID m_SteamID;
+
+		uint64_t m_TextOffset = 0;  // Position in ConsoleHistory's text arena
+		uint32_t m_NameLength = 0;  // Chat only, the player name is stored right before the message
+		uint32_t m_TextLength = 0;
+
+		std::array<float, 4> m_Color{ 1, 1, 1, 1 };  // Text only
+		ConsoleHistoryRecordType m_Type = ConsoleHistoryRecordType::Text;
+		TeamShareResult m_TeamShareResult{};
+		bool m_IsDead = false;
+		bool m_IsTeam = false;
+		bool m_IsSelf = false;
+
+		float m_DisplayHeight = 0;  // Remembered by the UI between frames, 0 if unknown
+	};
+
+	// Fixed capacity history of printed console lines. Records live in a ring buffer, and their
+	// text lives in a ring buffer of bytes sized from the record capacity, so memory use doesn't
+	// depend on what gets printed. When either runs out of room, the oldest records are dropped.
+	class ConsoleHistory final
+	{
+	public:
+		static constexpr size_t DEFAULT_CAPACITY = 512;
+		static constexpr size_t MIN_CAPACITY = 16;
+		static constexpr size_t MAX_CAPACITY = 65536;
+		static constexpr size_t TEXT_BYTES_PER_RECORD = 128;
+
+		explicit ConsoleHistory(size_t capacity = DEFAULT_CAPACITY);
+
+		size_t GetCapacity() const { return m_Records.size(); }
+
+		// Keeps as many of the newest records as will fit
+		void SetCapacity(size_t capacity);
+
+		size_t size() const { return m_Count; }
+		bool empty() const { return m_Count == 0; }
+		void clear();
+
+		// Index 0 is the oldest record
+		const ConsoleHistoryRecord& operator[](size_t index) const;
+		ConsoleHistoryRecord& operator[](size_t index);
+
+		// IDs are assigned in increasing order and never reused
+		uint64_t GetNextID() const { return m_NextID; }
+		uint64_t GetFirstID() const { return m_NextID - m_Count; }
+		const ConsoleHistoryRecord* FindByID(uint64_t id) const;
+		ConsoleHistoryRecord* FindByID(uint64_t id);
+
+		// Returns false if the line isn't one that gets printed
+		bool Add(const IConsoleLine& line);
+
+		void AddChat(time_point_t timestamp, SteamID steamID, const std::string_view& playerName,
+			const std::string_view& message, bool isDead, bool isTeam, bool isSelf, TeamShareResult teamShareResult);
+		void AddSeparator(time_point_t timestamp);
+		void AddText(time_point_t timestamp, const std::array<float, 4>& color, const std::string_view& text);
+
+		std::string_view GetName(const ConsoleHistoryRecord& record) const;
+		std::string_view GetText(const ConsoleHistoryRecord& record) const;
+
+		// Appends the IDs of records at or after startID whose player name or text contains
+		// filter (ignoring case) to results, oldest first.
+		void Find(const std::string_view& filter, std::vector<uint64_t>& results, uint64_t startID = 0) const;
+
+	private:
+		ConsoleHistoryRecord& AddRecord(ConsoleHistoryRecordType type, time_point_t timestamp,
+			std::string_view name, std::string_view text);
+		void PopOldest();
+		std::string_view GetArenaView(uint64_t offset, size_t length) const;
+
+		std::vector<ConsoleHistoryRecord> m_Records;
+		size_t m_First = 0;
+		size_t m_Count = 0;
+		uint64_t m_NextID = 0;
+
+		std::vector<char> m_Arena;
+		uint64_t m_ArenaHead = 0;  // Total bytes ever written (including skipped bytes at the end of the arena)
+	};
+}
@@ -83,34 +83,34 @@ std::shared_ptr<ChatConsoleLine> ChatConsoleLine::TryParse(const std::string_vie
 #endif
 
 template<typename TTextFunc, typename TSameLineFunc>
-static void ProcessChatMessage(const ChatConsoleLine& msgLine, const Settings::Theme& theme,
+static void ProcessChatMessage(const ChatConsoleLine::MessageView& msgLine, const Settings::Theme& theme,
 	TTextFunc&& textFunc, TSameLineFunc&& sameLineFunc)
 {
 	auto& colorSettings = theme.m_Colors;
 	std::array<float, 4> colors{ 0.8f, 0.8f, 1.0f, 1.0f };
 
-	if (msgLine.IsSelf())
+	if (msgLine.m_IsSelf)
 		colors = colorSettings.m_ChatLogYouFG;
-	else if (msgLine.GetTeamShareResult() == TeamShareResult::SameTeams)
+	else if (msgLine.m_TeamShareResult == TeamShareResult::SameTeams)
 		colors = colorSettings.m_ChatLogFriendlyTeamFG;
-	else if (msgLine.GetTeamShareResult() == TeamShareResult::OppositeTeams)
+	else if (msgLine.m_TeamShareResult == TeamShareResult::OppositeTeams)
 		colors = colorSettings.m_ChatLogEnemyTeamFG;
 
 	const auto PrintLHS = [&](float alphaScale = 1.0f)
 	{
-		if (msgLine.IsDead())
+		if (msgLine.m_IsDead)
 		{
 			textFunc(ImVec4(0.5f, 0.5f, 0.5f, 1.0f * alphaScale), "*DEAD*");
 			sameLineFunc();
 		}
 
-		if (msgLine.IsTeam())
+		if (msgLine.m_IsTeam)
 		{
 			textFunc(ImVec4(colors[0], colors[1], colors[2], colors[3] * 0.75f * alphaScale), "(TEAM)");
 			sameLineFunc();
 		}
 
-		textFunc(ImVec4(colors[0], colors[1], colors[2], colors[3] * alphaScale), msgLine.GetPlayerName());
+		textFunc(ImVec4(colors[0], colors[1], colors[2], colors[3] * alphaScale), msgLine.m_PlayerName);
 		sameLineFunc();
 
 		textFunc(ImVec4(1, 1, 1, alphaScale), ": ");
@@ -119,7 +119,7 @@ static void ProcessChatMessage(const ChatConsoleLine& msgLine, const Settings::T
 
 	PrintLHS();
 
-	const auto& msg = msgLine.GetMessage();
+	const std::string_view msg = msgLine.m_Message;
 	const ImVec4 msgColor(0.8f, 0.8f, 0.8f, 1.0f);
 	if (msg.find('\n') == msg.npos)
 	{
@@ -158,13 +158,31 @@ static void ProcessChatMessage(const ChatConsoleLine& msgLine, const Settings::T
 	}
 }
 
+auto ChatConsoleLine::GetMessageView() const -> MessageView
+{
+	return MessageView
+	{
+		.m_PlayerName = m_PlayerName,
+		.m_Message = m_Message,
+		.m_PlayerSteamID = m_PlayerSteamID,
+		.m_TeamShareResult = m_TeamShareResult,
+		.m_IsDead = m_IsDead,
+		.m_IsTeam = m_IsTeam,
+		.m_IsSelf = m_IsSelf,
+	};
+}
+
 void ChatConsoleLine::Print(const PrintArgs& args) const
 {
 	ImGuiDesktop::ScopeGuards::ID id(this);
+	PrintMessage(GetMessageView(), args);
+}
 
+void ChatConsoleLine::PrintMessage(const MessageView& msg, const PrintArgs& args)
+{
 	ImGui::BeginGroup();
-	ProcessChatMessage(*this, args.m_Settings.m_Theme,
-		[](const ImVec4& color, const std::string_view& msg) { ImGui::TextFmt(color, msg); },
+	ProcessChatMessage(msg, args.m_Settings.m_Theme,
+		[](const ImVec4& color, const std::string_view& text) { ImGui::TextFmt(color, text); },
 		[] { ImGui::SameLine(); });
 	ImGui::EndGroup();
 
@@ -176,13 +194,13 @@ void ChatConsoleLine::Print(const PrintArgs& args) const
 		{
 			std::string fullText;
 
-			ProcessChatMessage(*this, args.m_Settings.m_Theme,
-				[&](const ImVec4&, const std::string_view& msg)
+			ProcessChatMessage(msg, args.m_Settings.m_Theme,
+				[&](const ImVec4&, const std::string_view& text)
 				{
 					if (!fullText.empty())
 						fullText += ' ';
 
-					fullText.append(msg);
+					fullText.append(text);
 				},
 				[] {});
 
@@ -191,7 +209,7 @@ void ChatConsoleLine::Print(const PrintArgs& args) const
 	}
 	else if (isHovered)
 	{
-		if (auto player = args.m_WorldState.FindPlayer(m_PlayerSteamID))
+		if (auto player = args.m_WorldState.FindPlayer(msg.m_PlayerSteamID))
 			args.m_MainWindow.DrawPlayerTooltip(*player);
 	}
 }
@@ -49,8 +49,23 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::Chat; }
 		void Print(const PrintArgs& args) const override;
 
+		// Everything needed to draw a chat message, so it can be drawn without keeping the line around
+		struct MessageView
+		{
+			std::string_view m_PlayerName;
+			std::string_view m_Message;
+			SteamID m_PlayerSteamID;
+			TeamShareResult m_TeamShareResult{};
+			bool m_IsDead = false;
+			bool m_IsTeam = false;
+			bool m_IsSelf = false;
+		};
+		MessageView GetMessageView() const;
+		static void PrintMessage(const MessageView& msg, const PrintArgs& args);
+
 		const std::string& GetPlayerName() const { return m_PlayerName; }
 		const std::string& GetMessage() const { return m_Message; }
+		const SteamID& GetPlayerSteamID() const { return m_PlayerSteamID; }
 		bool IsDead() const { return m_IsDead; }
 		bool IsTeam() const { return m_IsTeam; }
 		bool IsSelf() const { return m_IsSelf; }
@@ -2,6 +2,7 @@
 #include "Config/ChatWrappers.h"
 #include "ConsoleLog/ConsoleLineListener.h"
 #include "ConsoleLines.h"
+#include "EventJournal/EventJournal.h"
 #include "Log.h"
 #include "Util/RegexUtils.h"
 #include "Config/Settings.h"
@@ -246,6 +247,7 @@ void ConsoleLogParser::ParseChunk(striter& parseEnd, bool& linesProcessed, bool&
 			{
 				if (result == ParseLineResult::Success || result == ParseLineResult::Modified)
 				{
+					IEventJournal::GetInstance().RecordConsoleLine(*parsed, lineStr);
 					m_WorldState->GetConsoleLineListenerBroadcaster().OnConsoleLineParsed(*m_WorldState, *parsed);
 					consoleLinesUpdated = true;
 				}
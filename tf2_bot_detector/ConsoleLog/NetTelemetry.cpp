@@ -0,0 +1,150 @@
+#include "NetTelemetry.h"
+#include "NetworkStatus.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+using namespace tf2_bot_detector;
+
+void NetTelemetryBucket::AddSample(float value)
+{
+	m_Min = std::min(m_Min, value);
+	m_Max = std::max(m_Max, value);
+	m_Sum += value;
+	m_Count++;
+}
+
+void NetTelemetryBucket::Merge(const NetTelemetryBucket& other)
+{
+	m_Min = std::min(m_Min, other.m_Min);
+	m_Max = std::max(m_Max, other.m_Max);
+	m_Sum += other.m_Sum;
+	m_Count += other.m_Count;
+}
+
+NetTelemetry::NetTelemetry() :
+	m_Buckets(size_t(NetMetric::COUNT) * BUCKET_COUNT)
+{
+}
+
+bool NetTelemetry::Add(const IConsoleLine& line)
+{
+	const auto timestamp = line.GetTimestamp();
+
+	switch (line.GetType())
+	{
+	case ConsoleLineType::NetDataTotal:
+	{
+		auto& dataLine = static_cast<const NetDataTotalLine&>(line);
+		AddSample(NetMetric::InKBps, timestamp, dataLine.GetInKBps());
+		AddSample(NetMetric::OutKBps, timestamp, dataLine.GetOutKBps());
+		return true;
+	}
+	case ConsoleLineType::NetLatency:
+	{
+		auto& latencyLine = static_cast<const NetLatencyLine&>(line);
+		AddSample(NetMetric::InLatency, timestamp, latencyLine.GetInLatency());
+		AddSample(NetMetric::OutLatency, timestamp, latencyLine.GetOutLatency());
+		return true;
+	}
+	case ConsoleLineType::NetPacketsTotal:
+	{
+		auto& packetsLine = static_cast<const NetPacketsTotalLine&>(line);
+		AddSample(NetMetric::InPacketsPerSecond, timestamp, packetsLine.GetInPacketsPerSecond());
+		AddSample(NetMetric::OutPacketsPerSecond, timestamp, packetsLine.GetOutPacketsPerSecond());
+		return true;
+	}
+	case ConsoleLineType::NetLoss:
+	{
+		auto& lossLine = static_cast<const NetLossLine&>(line);
+		AddSample(NetMetric::InLossPercent, timestamp, lossLine.GetInLossPercent());
+		AddSample(NetMetric::OutLossPercent, timestamp, lossLine.GetOutLossPercent());
+		return true;
+	}
+
+	default:
+		return false;
+	}
+}
+
+void NetTelemetry::AddSample(NetMetric metric, time_point_t timestamp, float value)
+{
+	assert(metric < NetMetric::COUNT);
+
+	const int64_t index = GetBucketIndex(timestamp);
+	if (m_NewestBucket < 0)
+	{
+		m_NewestBucket = index;
+	}
+	else if (index > m_NewestBucket)
+	{
+		// Reset the buckets we are about to reuse. Never more than one trip around the ring,
+		// even if it's been a long time since the last sample.
+		const int64_t firstStale = std::max(m_NewestBucket + 1, index - int64_t(BUCKET_COUNT) + 1);
+		for (int64_t i = firstStale; i <= index; i++)
+		{
+			for (size_t m = 0; m < size_t(NetMetric::COUNT); m++)
+				GetBucket(NetMetric(m), i) = {};
+		}
+
+		m_NewestBucket = index;
+	}
+	else if (index <= (m_NewestBucket - int64_t(BUCKET_COUNT)))
+	{
+		return; // Fell off the end of the ring
+	}
+
+	GetBucket(metric, index).AddSample(value);
+}
+
+void NetTelemetry::clear()
+{
+	std::fill(m_Buckets.begin(), m_Buckets.end(), NetTelemetryBucket{});
+	m_NewestBucket = -1;
+}
+
+time_point_t NetTelemetry::GetNewestTime() const
+{
+	if (m_NewestBucket < 0)
+		return {};
+
+	return time_point_t{} + std::chrono::duration_cast<time_point_t::duration>(BUCKET_LENGTH * m_NewestBucket);
+}
+
+void NetTelemetry::Downsample(NetMetric metric, duration_t window, NetTelemetryBucket* output, size_t outputCount) const
+{
+	assert(metric < NetMetric::COUNT);
+
+	std::fill(output, output + outputCount, NetTelemetryBucket{});
+	if (m_NewestBucket < 0 || outputCount == 0)
+		return;
+
+	const int64_t windowBuckets = std::clamp<int64_t>(window / BUCKET_LENGTH, 1, BUCKET_COUNT);
+	const int64_t firstBucket = m_NewestBucket - windowBuckets + 1;
+
+	for (size_t i = 0; i < outputCount; i++)
+	{
+		const int64_t begin = firstBucket + (windowBuckets * int64_t(i)) / int64_t(outputCount);
+		const int64_t end = firstBucket + (windowBuckets * int64_t(i + 1)) / int64_t(outputCount);
+
+		for (int64_t b = std::max<int64_t>(begin, 0); b < end; b++)
+			output[i].Merge(GetBucket(metric, b));
+	}
+}
+
+int64_t NetTelemetry::GetBucketIndex(time_point_t timestamp) const
+{
+	return std::max<int64_t>(timestamp.time_since_epoch() / BUCKET_LENGTH, 0);
+}
+
+NetTelemetryBucket& NetTelemetry::GetBucket(NetMetric metric, int64_t bucketIndex)
+{
+	return const_cast<NetTelemetryBucket&>(std::as_const(*this).GetBucket(metric, bucketIndex));
+}
+
+const NetTelemetryBucket& NetTelemetry::GetBucket(NetMetric metric, int64_t bucketIndex) const
+{
+	assert(bucketIndex >= 0);
+	return m_Buckets[size_t(metric) * BUCKET_COUNT + size_t(bucketIndex % BUCKET_COUNT)];
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Clock.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	class IConsoleLine;
+
+	// Everything we get out of the net_status lines in NetworkStatus.h
+	enum class NetMetric : uint8_t
+	{
+		InKBps,
+		OutKBps,
+		InLatency,
+		OutLatency,
+		InPacketsPerSecond,
+		OutPacketsPerSecond,
+		InLossPercent,
+		OutLossPercent,
+
+		COUNT,
+	};
+
+	struct NetTelemetryBucket
+	{
+		float m_Min = std::numeric_limits<float>::max();
+		float m_Max = std::numeric_limits<float>::lowest();
+		float m_Sum = 0;
+		uint32_t m_Count = 0;
+
+		bool empty() const { return m_Count == 0; }
+		float GetAverage() const { return m_Count > 0 ? (m_Sum / m_Count) : 0; }
+
+		void AddSample(float value);
+		void Merge(const NetTelemetryBucket& other);
+	};
+
+	// Fixed size history of net_status samples, one ring of BUCKET_LENGTH wide buckets per metric.
+	// Adding a sample never allocates, and samples too old to fit in the ring are ignored.
+	class NetTelemetry final
+	{
+	public:
+		static constexpr duration_t BUCKET_LENGTH = std::chrono::milliseconds(100);
+		static constexpr size_t BUCKET_COUNT = 3000; // 5 minutes
+
+		NetTelemetry();
+
+		// Returns false if the line isn't a net_status line we keep track of
+		bool Add(const IConsoleLine& line);
+		void AddSample(NetMetric metric, time_point_t timestamp, float value);
+
+		void clear();
+
+		// Time covered by the newest bucket, or time_point_t{} if nothing has been added yet
+		time_point_t GetNewestTime() const;
+
+		// Splits the window ending at the newest bucket into outputCount equal pieces and merges the
+		// buckets in each one, oldest first. Pieces without any samples are left empty. Cost only depends
+		// on the size of the window, so this is cheap enough to call every frame.
+		void Downsample(NetMetric metric, duration_t window, NetTelemetryBucket* output, size_t outputCount) const;
+		void Downsample(NetMetric metric, duration_t window, std::vector<NetTelemetryBucket>& output) const
+		{
+			Downsample(metric, window, output.data(), output.size());
+		}
+
+	private:
+		int64_t GetBucketIndex(time_point_t timestamp) const;
+		NetTelemetryBucket& GetBucket(NetMetric metric, int64_t bucketIndex);
+		const NetTelemetryBucket& GetBucket(NetMetric metric, int64_t bucketIndex) const;
+
+		// BUCKET_COUNT buckets for each metric, one metric after the other
+		std::vector<NetTelemetryBucket> m_Buckets;
+
+		// Bucket indices count BUCKET_LENGTHs since the epoch, -1 means empty
+		int64_t m_NewestBucket = -1;
+	};
+}
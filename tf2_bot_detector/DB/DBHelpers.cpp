@@ -86,8 +86,7 @@ void tf2_bot_detector::DB::CreateTable(SQLite::Database& db, const TableDefiniti
 	return CreateTable(db, table.GetTableName(), cols.data(), cols.data() + cols.size(), flags);
 }
 
-void tf2_bot_detector::DB::InsertInto(SQLite::Database& db, const std::string_view& tableName, std::initializer_list<ColumnData> columns,
-	InsertIntoConstraintResolver resolver) try
+static std::string CreateInsertIntoPrefix(const std::string_view& tableName, InsertIntoConstraintResolver resolver)
 {
 	std::string query = "INSERT OR ";
 
@@ -111,6 +110,13 @@ void tf2_bot_detector::DB::InsertInto(SQLite::Database& db, const std::string_vi
 	}
 
 	query.append(" INTO \"").append(tableName).append("\" (");
+	return query;
+}
+
+void tf2_bot_detector::DB::InsertInto(SQLite::Database& db, const std::string_view& tableName, std::initializer_list<ColumnData> columns,
+	InsertIntoConstraintResolver resolver) try
+{
+	std::string query = CreateInsertIntoPrefix(tableName, resolver);
 
 	for (const ColumnData& column : columns)
 	{
@@ -170,6 +176,58 @@ void tf2_bot_detector::DB::ReplaceInto(SQLite::Database& db, const std::string_v
 	return InsertInto(db, tableName, columns, InsertIntoConstraintResolver::Replace);
 }
 
+std::string tf2_bot_detector::DB::CreateInsertIntoQuery(const TableDefinition& table, InsertIntoConstraintResolver resolver)
+{
+	std::string query = CreateInsertIntoPrefix(table.GetTableName(), resolver);
+
+	const auto& columns = table.GetColumns();
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		if (i != 0)
+			query.append(", ");
+
+		query.append("\"").append(columns[i].m_Name).append("\"");
+	}
+
+	query.append(") VALUES (");
+
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		if (i != 0)
+			query.append(", ");
+
+		query.append("$").append(columns[i].m_Name);
+	}
+
+	query.append(")");
+	return query;
+}
+
+std::string tf2_bot_detector::DB::CreateSelectWhereEqualsQuery(const TableDefinition& table, const ColumnDefinition& column)
+{
+	return mh::format("SELECT * FROM \"{0}\" WHERE (\"{1}\" == ${1})", table.GetTableName(), column.m_Name);
+}
+
+void tf2_bot_detector::DB::BindColumnData(SQLite::Statement& statement, std::initializer_list<ColumnData> columns)
+{
+	for (const ColumnData& column : columns)
+	{
+		const mh::fmtstr<64> paramName("${}", column.m_Column.get().m_Name);
+
+		std::visit([&](const auto& val)
+			{
+				using type = std::decay_t<decltype(val)>;
+				if constexpr (std::is_same_v<type, BlobData>)
+					statement.bind(paramName.c_str(), val.m_Data, static_cast<int>(val.m_Size));
+				else if constexpr (std::is_same_v<type, std::monostate>)
+					statement.bind(paramName.c_str());
+				else
+					statement.bind(paramName.c_str(), val);
+
+			}, column.m_Data);
+	}
+}
+
 ColumnData::ColumnData(const ColumnDefinition& column, uint32_t intData) :
 	ColumnData(column, int64_t(intData))
 {
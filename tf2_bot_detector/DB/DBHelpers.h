@@ -314,4 +314,11 @@ namespace tf2_bot_detector::DB
 	void InsertInto(SQLite::Database& db, const std::string_view& tableName, std::initializer_list<ColumnData> columns,
 		InsertIntoConstraintResolver resolver = InsertIntoConstraintResolver::Abort);
 	void ReplaceInto(SQLite::Database& db, const std::string_view& tableName, std::initializer_list<ColumnData> columns);
+
+	// Query text for statements that are prepared once and re-executed. Parameters are named after their
+	// columns ($ColumnName) and can be bound with BindColumnData.
+	std::string CreateInsertIntoQuery(const TableDefinition& table,
+		InsertIntoConstraintResolver resolver = InsertIntoConstraintResolver::Abort);
+	std::string CreateSelectWhereEqualsQuery(const TableDefinition& table, const ColumnDefinition& column);
+	void BindColumnData(SQLite::Statement& statement, std::initializer_list<ColumnData> columns);
 }
@@ -5,27 +5,95 @@
 #include "Filesystem.h"
 #include "SteamID.h"
 
+#include <mh/concurrency/thread_pool.hpp>
 #include <mh/error/ensure.hpp>
 #include <mh/concurrency/thread_sentinel.hpp>
 #include <mh/types/enum_class_bit_ops.hpp>
 #include <sqlite3.h>
 #include <SQLiteCpp/SQLiteCpp.h>
 
+#include <array>
 #include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
 
 using namespace tf2_bot_detector;
 using namespace tf2_bot_detector::DB;
 
 namespace
 {
+	enum class CachedStatement
+	{
+		AccountAgesStore,
+		AccountAgesTryGet,
+		LogsTFStore,
+		LogsTFTryGet,
+		InventorySizeStore,
+		InventorySizeTryGet,
+
+		COUNT,
+	};
+
+	// A cached statement that's in use. Resets it when it goes out of scope, otherwise a SELECT
+	// that stopped after its first row keeps its read transaction open, which pins that
+	// connection to an old snapshot of the database and blocks checkpoints.
+	class StatementLease final
+	{
+	public:
+		explicit StatementLease(Statement2& statement) : m_Statement(statement) {}
+		StatementLease(const StatementLease&) = delete;
+		StatementLease& operator=(const StatementLease&) = delete;
+		~StatementLease()
+		{
+			try
+			{
+				m_Statement.reset();
+			}
+			catch (...)
+			{
+				// Errors from the last step were already thrown to whoever ran the statement
+			}
+		}
+
+		Statement2& operator*() const { return m_Statement; }
+
+	private:
+		Statement2& m_Statement;
+	};
+
+	// A sqlite connection and the statements that have been prepared on it. Only ever used
+	// by one thread at a time.
+	class Connection final
+	{
+	public:
+		Connection(const std::string& path, int flags) : m_DB(path, flags) {}
+		Connection(const Connection&) = delete;
+		Connection& operator=(const Connection&) = delete;
+
+		// Returns the statement reset and with cleared bindings. It is reset again once the
+		// returned lease goes away.
+		[[nodiscard]] StatementLease GetStatement(CachedStatement statement);
+
+		SQLite::Database m_DB;
+
+	private:
+		std::array<std::optional<Statement2>, size_t(CachedStatement::COUNT)> m_Statements;
+	};
+
 	class TempDB final : public ITempDB
 	{
 	public:
 		TempDB();
+		~TempDB();
 
 		void Store(const AccountAgeInfo& info) override;
 		bool TryGet(AccountAgeInfo& info) const override;
-		void GetNearestAccountAgeInfos(SteamID id, std::optional<AccountAgeInfo>& lower, std::optional<AccountAgeInfo>& upper) const override;
+		void ForEachAccountAgeInfo(const std::function<void(const AccountAgeInfo&)>& func) const override;
 
 		void Store(const LogsTFCacheInfo& info) override;
 		bool TryGet(LogsTFCacheInfo& info) const override;
@@ -33,13 +101,61 @@ namespace
 		void Store(const AccountInventorySizeInfo& info) override;
 		bool TryGet(AccountInventorySizeInfo& info) const override;
 
+		mh::task<bool> TryGetAsync(AccountAgeInfo& info) const override { return TryGetOnReaderAsync(info); }
+		mh::task<bool> TryGetAsync(LogsTFCacheInfo& info) const override { return TryGetOnReaderAsync(info); }
+		mh::task<bool> TryGetAsync(AccountInventorySizeInfo& info) const override { return TryGetOnReaderAsync(info); }
+
+		mh::task<> StoreAsync(const AccountAgeInfo& info) override { Store(info); co_return; }
+		mh::task<> StoreAsync(const LogsTFCacheInfo& info) override { Store(info); co_return; }
+		mh::task<> StoreAsync(const AccountInventorySizeInfo& info) override { Store(info); co_return; }
+
 	private:
 		static constexpr size_t DB_VERSION = 4;
 		void Connect();
 
-		std::optional<SQLite::Database> m_Connection;
+		// The read/write connection. Only touched by m_DBThread once the constructor is done.
+		std::optional<Connection> m_Connection;
+
+		// Writes are queued and committed in batches inside a single transaction. Synchronous reads are
+		// queued behind them (so they always see previous writes) and block the caller until they complete.
+		static constexpr size_t MAX_WRITE_BATCH_SIZE = 512;
+		static constexpr duration_t WRITE_BATCH_DELAY = std::chrono::milliseconds(100);
+
+		struct QueuedOperation
+		{
+			std::function<void()> m_Func;
+			bool m_IsWrite;
+		};
+
+		void QueueWrite(std::function<void(Connection&)> func);
+		template<typename TFunc> auto RunRead(TFunc&& func) const;
+
+		void DBThreadFunc();
+		void RunBatch(std::deque<QueuedOperation>& batch);
+
+		mutable std::mutex m_QueueMutex;
+		mutable std::condition_variable m_QueueCV;
+		mutable std::deque<QueuedOperation> m_Queue;
+		mutable size_t m_QueuedReadCount = 0;
+		bool m_ShutdownRequested = false;
+		std::thread m_DBThread;
+
+		// Async reads run on their own read-only connections (one per reader thread), which WAL mode lets
+		// run in parallel with each other and with the writer. They only see committed writes.
+		static constexpr size_t READER_THREAD_COUNT = 2;
+
+		template<typename TInfo> mh::task<bool> TryGetOnReaderAsync(TInfo& info) const;
+		Connection& GetReaderConnection() const;
+
+		mutable std::mutex m_ReaderConnectionsMutex;
+		mutable std::map<std::thread::id, std::unique_ptr<Connection>> m_ReaderConnections;
+		mutable mh::thread_pool m_ReaderPool{ READER_THREAD_COUNT }; // Must be destroyed before m_ReaderConnections
 	};
 
+#ifdef _DEBUG
+	static thread_local uint32_t s_DisallowDBAccessCount = 0;
+#endif
+
 	static std::string CreateDBPath()
 	{
 		const auto folderPath = IFilesystem::Get().ResolvePath("temp/db", PathUsage::WriteLocal);
@@ -91,21 +207,23 @@ namespace
 		Connect();
 
 		// Delete and recreate the DB if its an old version
-		if (const auto currentUserVersion = m_Connection->execAndGet(mh::format("PRAGMA user_version")).getInt();
+		if (const auto currentUserVersion = m_Connection->m_DB.execAndGet(mh::format("PRAGMA user_version")).getInt();
 			currentUserVersion != DB_VERSION)
 		{
 			LogWarning("Current {} version = {}. Deleting and recreating...", CreateDBPath(), currentUserVersion);
 			m_Connection.reset();
 			std::filesystem::remove(CreateDBPath());
 			Connect();
-			m_Connection->exec(mh::format("PRAGMA user_version = {}", DB_VERSION)); // TODO check current user_version and delete if different
+			m_Connection->m_DB.exec(mh::format("PRAGMA user_version = {}", DB_VERSION)); // TODO check current user_version and delete if different
 		}
 
-		m_Connection->exec("PRAGMA journal_mode = WAL;");
+		m_Connection->m_DB.exec("PRAGMA journal_mode = WAL;");
 
-		CreateTable(m_Connection.value(), s_TableAccountAges, CreateTableFlags::IfNotExists);
-		CreateTable(m_Connection.value(), s_TableLogsTFCache, CreateTableFlags::IfNotExists);
-		CreateTable(m_Connection.value(), s_TableInventorySize, CreateTableFlags::IfNotExists);
+		CreateTable(m_Connection->m_DB, s_TableAccountAges, CreateTableFlags::IfNotExists);
+		CreateTable(m_Connection->m_DB, s_TableLogsTFCache, CreateTableFlags::IfNotExists);
+		CreateTable(m_Connection->m_DB, s_TableInventorySize, CreateTableFlags::IfNotExists);
+
+		m_DBThread = std::thread(&TempDB::DBThreadFunc, this);
 	}
 	catch (...)
 	{
@@ -144,15 +262,84 @@ namespace tf2_bot_detector::DB
 	};
 }
 
+void tf2_bot_detector::DB::detail::AssertDBAccessAllowed(const mh::source_location& location)
+{
+#ifdef _DEBUG
+	if (s_DisallowDBAccessCount > 0)
+	{
+		LogError(location, "Database access from a thread/scope where it is not allowed (ScopedDisallowDBAccess)");
+		assert(!"Database access from a thread/scope where it is not allowed (ScopedDisallowDBAccess)");
+	}
+#endif
+}
+
+#ifdef _DEBUG
+ScopedDisallowDBAccess::ScopedDisallowDBAccess()
+{
+	s_DisallowDBAccessCount++;
+}
+
+ScopedDisallowDBAccess::~ScopedDisallowDBAccess()
+{
+	s_DisallowDBAccessCount--;
+}
+#endif
+
 namespace
 {
-	void TempDB::Store(const AccountAgeInfo& info) try
+	StatementLease Connection::GetStatement(CachedStatement statement)
+	{
+		detail::AssertDBAccessAllowed();
+
+		auto& cached = m_Statements.at(size_t(statement));
+		if (cached)
+		{
+			cached->reset();
+			cached->clearBindings();
+			return StatementLease(*cached);
+		}
+
+		std::string queryStr;
+		switch (statement)
+		{
+		case CachedStatement::AccountAgesStore:
+			queryStr = CreateInsertIntoQuery(s_TableAccountAges, InsertIntoConstraintResolver::Replace);
+			break;
+		case CachedStatement::AccountAgesTryGet:
+			queryStr = CreateSelectWhereEqualsQuery(s_TableAccountAges, s_TableAccountAges.COL_ACCOUNT_ID);
+			break;
+		case CachedStatement::LogsTFStore:
+			queryStr = CreateInsertIntoQuery(s_TableLogsTFCache, InsertIntoConstraintResolver::Replace);
+			break;
+		case CachedStatement::LogsTFTryGet:
+			queryStr = CreateSelectWhereEqualsQuery(s_TableLogsTFCache, s_TableLogsTFCache.COL_ACCOUNT_ID);
+			break;
+		case CachedStatement::InventorySizeStore:
+			queryStr = CreateInsertIntoQuery(s_TableInventorySize, InsertIntoConstraintResolver::Replace);
+			break;
+		case CachedStatement::InventorySizeTryGet:
+			queryStr = CreateSelectWhereEqualsQuery(s_TableInventorySize, s_TableInventorySize.COL_ACCOUNT_ID);
+			break;
+
+		default:
+			throw std::invalid_argument(mh::format("Unknown CachedStatement {}", int(statement)));
+		}
+
+		return StatementLease(cached.emplace(SQLite::Statement(m_DB, queryStr)));
+	}
+
+	// The actual queries, shared between the DB thread and the async readers
+
+	static void StoreImpl(Connection& connection, const AccountAgeInfo& info) try
 	{
-		ReplaceInto(m_Connection.value(), s_TableAccountAges.GetTableName(),
+		const auto statementLease = connection.GetStatement(CachedStatement::AccountAgesStore);
+		auto& statement = *statementLease;
+		BindColumnData(statement,
 			{
 				{ s_TableAccountAges.COL_ACCOUNT_ID, info.m_SteamID },
 				{ s_TableAccountAges.COL_CREATION_TIME, info.m_CreationTime },
 			});
+		statement.exec();
 	}
 	catch (...)
 	{
@@ -160,13 +347,11 @@ namespace
 		throw;
 	}
 
-	bool TempDB::TryGet(AccountAgeInfo& info) const try
+	static bool TryGetImpl(Connection& connection, AccountAgeInfo& info) try
 	{
-		auto& db = const_cast<SQLite::Database&>(m_Connection.value());
-
-		auto query = SelectStatementBuilder(s_TableAccountAges.GetTableName())
-			.Where(s_TableAccountAges.COL_ACCOUNT_ID == info.m_SteamID)
-			.Run(db);
+		const auto queryLease = connection.GetStatement(CachedStatement::AccountAgesTryGet);
+		auto& query = *queryLease;
+		BindColumnData(query, { { s_TableAccountAges.COL_ACCOUNT_ID, info.m_SteamID } });
 
 		if (query.executeStep())
 		{
@@ -182,61 +367,17 @@ namespace
 		throw;
 	}
 
-	void TempDB::GetNearestAccountAgeInfos(SteamID id, std::optional<AccountAgeInfo>& lower, std::optional<AccountAgeInfo>& upper) const
-	{
-		auto queryStr = mh::format(R"SQL(
-SELECT max({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_AccountAges} WHERE {col_AccountID} <= $steamID
-UNION ALL
-SELECT min({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_AccountAges} WHERE {col_AccountID} >= $steamID)SQL",
-
-			mh::fmtarg("col_AccountID", s_TableAccountAges.COL_ACCOUNT_ID.m_Name),
-			mh::fmtarg("col_CreationTime", s_TableAccountAges.COL_CREATION_TIME.m_Name),
-			mh::fmtarg("tbl_AccountAges", s_TableAccountAges.GetTableName()));
-
-		Statement2 query(SQLite::Statement(const_cast<SQLite::Database&>(m_Connection.value()), queryStr));
-		query.bind("$steamID", id.GetAccountID());
-
-		const auto DeserializeAccountInfo = [&]()
-		{
-			AccountAgeInfo info;
-			info.m_SteamID = query.getColumn(s_TableAccountAges.COL_ACCOUNT_ID);
-			info.m_CreationTime = query.getColumn(s_TableAccountAges.COL_CREATION_TIME);
-			return info;
-		};
-
-		while (query.executeStep())
-		{
-			assert(!lower.has_value() || !upper.has_value());
-
-			auto info = DeserializeAccountInfo();
-			if (info.m_SteamID == id)
-			{
-				lower = info;
-				upper = info;
-				return;
-			}
-
-			if (info.m_SteamID.GetAccountID() < id.GetAccountID())
-				lower = info;
-			else
-				upper = info;
-		}
-	}
-
-	void TempDB::Connect()
+	static void StoreImpl(Connection& connection, const LogsTFCacheInfo& info) try
 	{
-		assert(!m_Connection.has_value());
-		m_Connection.emplace(CreateDBPath(), SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE | SQLite::OPEN_FULLMUTEX);
-	}
-
-	void TempDB::Store(const LogsTFCacheInfo& info) try
-	{
-		ReplaceInto(m_Connection.value(), s_TableLogsTFCache.GetTableName(),
+		const auto statementLease = connection.GetStatement(CachedStatement::LogsTFStore);
+		auto& statement = *statementLease;
+		BindColumnData(statement,
 			{
 				{ s_TableLogsTFCache.COL_ACCOUNT_ID, info.GetSteamID() },
 				{ s_TableLogsTFCache.COL_LAST_UPDATE_TIME, info.m_LastCacheUpdateTime },
 				{ s_TableLogsTFCache.COL_LOG_COUNT, info.m_LogsCount }
 			});
+		statement.exec();
 	}
 	catch (...)
 	{
@@ -244,11 +385,11 @@ SELECT min({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_Acc
 		throw;
 	}
 
-	bool TempDB::TryGet(LogsTFCacheInfo& info) const
+	static bool TryGetImpl(Connection& connection, LogsTFCacheInfo& info)
 	{
-		auto query = SelectStatementBuilder(s_TableLogsTFCache.GetTableName())
-			.Where(s_TableLogsTFCache.COL_ACCOUNT_ID == info.m_ID)
-			.Run(m_Connection.value());
+		const auto queryLease = connection.GetStatement(CachedStatement::LogsTFTryGet);
+		auto& query = *queryLease;
+		BindColumnData(query, { { s_TableLogsTFCache.COL_ACCOUNT_ID, info.m_ID } });
 
 		if (query.executeStep())
 		{
@@ -260,15 +401,18 @@ SELECT min({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_Acc
 		return false;
 	}
 
-	void TempDB::Store(const AccountInventorySizeInfo& info) try
+	static void StoreImpl(Connection& connection, const AccountInventorySizeInfo& info) try
 	{
-		ReplaceInto(m_Connection.value(), s_TableInventorySize.GetTableName(),
+		const auto statementLease = connection.GetStatement(CachedStatement::InventorySizeStore);
+		auto& statement = *statementLease;
+		BindColumnData(statement,
 			{
 				{ s_TableInventorySize.COL_ACCOUNT_ID, info.GetSteamID() },
 				{ s_TableInventorySize.COL_LAST_UPDATE_TIME, info.m_LastCacheUpdateTime },
 				{ s_TableInventorySize.COL_ITEM_COUNT, info.m_Items },
 				{ s_TableInventorySize.COL_SLOT_COUNT, info.m_Slots },
 			});
+		statement.exec();
 	}
 	catch (...)
 	{
@@ -276,11 +420,11 @@ SELECT min({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_Acc
 		throw;
 	}
 
-	bool TempDB::TryGet(AccountInventorySizeInfo& info) const
+	static bool TryGetImpl(Connection& connection, AccountInventorySizeInfo& info)
 	{
-		auto query = SelectStatementBuilder(s_TableInventorySize.GetTableName())
-			.Where(s_TableInventorySize.COL_ACCOUNT_ID == info.GetSteamID())
-			.Run(m_Connection.value());
+		const auto queryLease = connection.GetStatement(CachedStatement::InventorySizeTryGet);
+		auto& query = *queryLease;
+		BindColumnData(query, { { s_TableInventorySize.COL_ACCOUNT_ID, info.GetSteamID() } });
 
 		if (query.executeStep())
 		{
@@ -292,6 +436,197 @@ SELECT min({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_Acc
 
 		return false;
 	}
+
+	TempDB::~TempDB()
+	{
+		{
+			std::lock_guard lock(m_QueueMutex);
+			m_ShutdownRequested = true;
+		}
+		m_QueueCV.notify_all();
+
+		if (m_DBThread.joinable())
+			m_DBThread.join(); // Commits anything still queued
+	}
+
+	void TempDB::Connect()
+	{
+		assert(!m_Connection.has_value());
+		m_Connection.emplace(CreateDBPath(), SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE | SQLite::OPEN_FULLMUTEX);
+	}
+
+	void TempDB::QueueWrite(std::function<void(Connection&)> func)
+	{
+		{
+			std::lock_guard lock(m_QueueMutex);
+			m_Queue.push_back({ [this, func = std::move(func)] { func(m_Connection.value()); }, true });
+		}
+		m_QueueCV.notify_one();
+	}
+
+	template<typename TFunc>
+	auto TempDB::RunRead(TFunc&& func) const
+	{
+		assert(std::this_thread::get_id() != m_DBThread.get_id());
+		detail::AssertDBAccessAllowed();
+
+		using result_t = std::invoke_result_t<TFunc, Connection&>;
+		auto task = std::make_shared<std::packaged_task<result_t(Connection&)>>(std::forward<TFunc>(func));
+		auto future = task->get_future();
+
+		{
+			std::lock_guard lock(m_QueueMutex);
+			m_Queue.push_back({ [this, task] { (*task)(const_cast<Connection&>(m_Connection.value())); }, false });
+			m_QueuedReadCount++;
+		}
+		m_QueueCV.notify_one();
+
+		return future.get();
+	}
+
+	void TempDB::DBThreadFunc()
+	{
+		std::deque<QueuedOperation> batch;
+
+		while (true)
+		{
+			{
+				std::unique_lock lock(m_QueueMutex);
+				m_QueueCV.wait(lock, [&] { return m_ShutdownRequested || !m_Queue.empty(); });
+
+				if (m_Queue.empty())
+					break; // Shutdown requested and nothing left to do
+
+				// Give writes a moment to pile up so they share a transaction. Reads (someone is
+				// blocked waiting on us) and shutdown cut the wait short.
+				m_QueueCV.wait_for(lock, WRITE_BATCH_DELAY, [&]
+					{
+						return m_ShutdownRequested || m_QueuedReadCount > 0 || m_Queue.size() >= MAX_WRITE_BATCH_SIZE;
+					});
+
+				batch.swap(m_Queue);
+				m_QueuedReadCount = 0;
+			}
+
+			RunBatch(batch);
+			batch.clear();
+		}
+	}
+
+	void TempDB::RunBatch(std::deque<QueuedOperation>& batch)
+	{
+		std::optional<SQLite::Transaction> transaction;
+		const auto CommitTransaction = [&]
+		{
+			if (!transaction)
+				return;
+
+			try
+			{
+				transaction->commit();
+			}
+			catch (...)
+			{
+				LogException("Failed to commit {} transaction", CreateDBPath());
+			}
+
+			transaction.reset();
+		};
+
+		for (QueuedOperation& op : batch)
+		{
+			if (op.m_IsWrite)
+			{
+				if (!transaction)
+					transaction.emplace(m_Connection->m_DB);
+
+				try
+				{
+					op.m_Func();
+				}
+				catch (...)
+				{
+					// Already logged by StoreImpl, don't let one bad row lose the whole batch
+				}
+			}
+			else
+			{
+				// Don't make readers wait on the rest of the batch
+				CommitTransaction();
+				op.m_Func(); // exceptions are captured by the packaged_task
+			}
+		}
+
+		CommitTransaction();
+	}
+
+	Connection& TempDB::GetReaderConnection() const
+	{
+		std::lock_guard lock(m_ReaderConnectionsMutex);
+
+		auto& connection = m_ReaderConnections[std::this_thread::get_id()];
+		if (!connection)
+			connection = std::make_unique<Connection>(CreateDBPath(), SQLite::OPEN_READONLY | SQLite::OPEN_NOMUTEX);
+
+		return *connection;
+	}
+
+	template<typename TInfo>
+	mh::task<bool> TempDB::TryGetOnReaderAsync(TInfo& info) const
+	{
+		co_await m_ReaderPool.co_add_task();
+		co_return TryGetImpl(GetReaderConnection(), info);
+	}
+
+	void TempDB::Store(const AccountAgeInfo& info)
+	{
+		QueueWrite([info](Connection& connection) { StoreImpl(connection, info); });
+	}
+
+	bool TempDB::TryGet(AccountAgeInfo& info) const
+	{
+		return RunRead([&](Connection& connection) { return TryGetImpl(connection, info); });
+	}
+
+	void TempDB::ForEachAccountAgeInfo(const std::function<void(const AccountAgeInfo&)>& func) const
+	{
+		RunRead([&](Connection& connection)
+			{
+				// One-off query, not worth caching
+				SQLite::Statement query(connection.m_DB, mh::format(
+					"SELECT \"{0}\", \"{1}\" FROM \"{2}\" ORDER BY \"{0}\" ASC",
+					s_TableAccountAges.COL_ACCOUNT_ID.m_Name, s_TableAccountAges.COL_CREATION_TIME.m_Name,
+					s_TableAccountAges.GetTableName()));
+
+				AccountAgeInfo info;
+				while (query.executeStep())
+				{
+					info.m_SteamID = Column2(query.getColumn(0));
+					info.m_CreationTime = Column2(query.getColumn(1));
+					func(info);
+				}
+			});
+	}
+
+	void TempDB::Store(const LogsTFCacheInfo& info)
+	{
+		QueueWrite([info](Connection& connection) { StoreImpl(connection, info); });
+	}
+
+	bool TempDB::TryGet(LogsTFCacheInfo& info) const
+	{
+		return RunRead([&](Connection& connection) { return TryGetImpl(connection, info); });
+	}
+
+	void TempDB::Store(const AccountInventorySizeInfo& info)
+	{
+		QueueWrite([info](Connection& connection) { StoreImpl(connection, info); });
+	}
+
+	bool TempDB::TryGet(AccountInventorySizeInfo& info) const
+	{
+		return RunRead([&](Connection& connection) { return TryGetImpl(connection, info); });
+	}
 }
 
 std::unique_ptr<ITempDB> tf2_bot_detector::DB::ITempDB::Create()
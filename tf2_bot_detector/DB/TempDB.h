@@ -7,8 +7,10 @@
 
 #include <mh/coroutine/task.hpp>
 #include <mh/memory/stack_info.hpp>
+#include <mh/source_location.hpp>
 
 #include <cassert>
+#include <functional>
 #include <optional>
 
 namespace tf2_bot_detector::DB
@@ -36,8 +38,26 @@ namespace tf2_bot_detector::DB
 			virtual duration_t GetCacheLiveTime() const = 0;
 			time_point_t m_LastCacheUpdateTime;
 		};
+
+		void AssertDBAccessAllowed(MH_SOURCE_LOCATION_AUTO(location));
 	}
 
+	// While one of these is alive, any synchronous database access from the current thread asserts
+	// (debug builds only). Used to keep sqlite off of latency sensitive paths like the UI draw.
+	class ScopedDisallowDBAccess final
+	{
+	public:
+#ifdef _DEBUG
+		ScopedDisallowDBAccess();
+		~ScopedDisallowDBAccess();
+#else
+		ScopedDisallowDBAccess() {}
+		~ScopedDisallowDBAccess() {}
+#endif
+		ScopedDisallowDBAccess(const ScopedDisallowDBAccess&) = delete;
+		ScopedDisallowDBAccess& operator=(const ScopedDisallowDBAccess&) = delete;
+	};
+
 	struct AccountAgeInfo final : detail::BaseCacheInfo_SteamID
 	{
 		time_point_t m_CreationTime{};
@@ -73,7 +93,8 @@ namespace tf2_bot_detector::DB
 
 		virtual void Store(const AccountAgeInfo& info) = 0;
 		[[nodiscard]] virtual bool TryGet(AccountAgeInfo& info) const = 0;
-		virtual void GetNearestAccountAgeInfos(SteamID id, std::optional<AccountAgeInfo>& lower, std::optional<AccountAgeInfo>& upper) const = 0;
+		// Visits every stored account age in ascending AccountID order. func is invoked on the DB thread.
+		virtual void ForEachAccountAgeInfo(const std::function<void(const AccountAgeInfo&)>& func) const = 0;
 
 		virtual void Store(const LogsTFCacheInfo& info) = 0;
 		[[nodiscard]] virtual bool TryGet(LogsTFCacheInfo& info) const = 0;
@@ -81,6 +102,16 @@ namespace tf2_bot_detector::DB
 		virtual void Store(const AccountInventorySizeInfo& info) = 0;
 		[[nodiscard]] virtual bool TryGet(AccountInventorySizeInfo& info) const = 0;
 
+		// Async variants. Lookups run on a pool of read-only connections and never block the calling
+		// thread, but only see writes that have already been committed. Stores complete once queued.
+		// The returned tasks may resume on a DB worker thread.
+		[[nodiscard]] virtual mh::task<bool> TryGetAsync(AccountAgeInfo& info) const = 0;
+		[[nodiscard]] virtual mh::task<bool> TryGetAsync(LogsTFCacheInfo& info) const = 0;
+		[[nodiscard]] virtual mh::task<bool> TryGetAsync(AccountInventorySizeInfo& info) const = 0;
+		virtual mh::task<> StoreAsync(const AccountAgeInfo& info) = 0;
+		virtual mh::task<> StoreAsync(const LogsTFCacheInfo& info) = 0;
+		virtual mh::task<> StoreAsync(const AccountInventorySizeInfo& info) = 0;
+
 		template<typename TInfo, typename TUpdateFunc>
 		mh::task<> GetOrUpdateAsync(TInfo& info, TUpdateFunc&& updateFunc)
 		{
@@ -90,7 +121,7 @@ namespace tf2_bot_detector::DB
 			constexpr bool HAS_EXPIRATION = std::is_base_of_v<detail::BaseCacheInfo_Expiration, TInfo>;
 
 			bool wantsRefresh = true;
-			if (TryGet(info))
+			if (co_await TryGetAsync(info))
 			{
 				if constexpr (HAS_EXPIRATION)
 				{
@@ -111,7 +142,7 @@ namespace tf2_bot_detector::DB
 				if constexpr (HAS_EXPIRATION)
 					info.m_LastCacheUpdateTime = tfbd_clock_t::now();
 
-				Store(info);
+				co_await StoreAsync(info);
 			}
 		}
 	};
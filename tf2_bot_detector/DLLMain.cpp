@@ -1,6 +1,7 @@
 #include "DLLMain.h"
 
 #include "Application.h"
+#include "Networking/HTTPTransport.h"
 #include "Tests/Tests.h"
 #include "UI/MainWindow.h"
 #include "Util/TextUtils.h"
@@ -74,19 +75,25 @@ TF2_BOT_DETECTOR_EXPORT int tf2_bot_detector::RunProgram(int argc, const char**
 
 		for (int i = 1; i < argc; i++)
 		{
-#ifdef _DEBUG
-			if (!strcmp(argv[i], "--static-seed") && (i + 1) < argc)
-				tf2_bot_detector::g_StaticRandomSeed = atoi(argv[i + 1]);
-			else if (!strcmp(argv[i], "--allow-open-tf2"))
-				tf2_bot_detector::g_SkipOpenTF2Check = true;
-			else if (!strcmp(argv[i], "--run-tests"))
+			if (!strcmp(argv[i], "--run-tests"))
 			{
 #ifdef TF2BD_ENABLE_TESTS
-				return tf2_bot_detector::RunTests();
+				// Everything after --run-tests is for Catch2, like a test spec: --run-tests "[benchmark]"
+				return tf2_bot_detector::RunTests(argc - i, argv + i);
 #else
 				LogError("--run-tests was on the command line, but tests were not compiled in");
 #endif
 			}
+
+#ifdef _DEBUG
+			if (!strcmp(argv[i], "--static-seed") && (i + 1) < argc)
+				tf2_bot_detector::g_StaticRandomSeed = atoi(argv[i + 1]);
+			else if (!strcmp(argv[i], "--allow-open-tf2"))
+				tf2_bot_detector::g_SkipOpenTF2Check = true;
+			else if (!strcmp(argv[i], "--http-record") && (i + 1) < argc)
+				IHTTPTransport::SetDefaultOverride(IHTTPTransport::CreateRecording(IHTTPTransport::Create(), argv[++i]));
+			else if (!strcmp(argv[i], "--http-replay") && (i + 1) < argc)
+				IHTTPTransport::SetDefaultOverride(IHTTPTransport::CreateReplay(argv[++i]));
 #endif
 		}
 
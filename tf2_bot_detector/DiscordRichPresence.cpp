@@ -21,8 +21,12 @@
 #include <cryptopp/sha.h>
 
 #include <array>
+#include <atomic>
 #include <cassert>
-#include <compare>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 #undef min
 #undef max
@@ -31,58 +35,12 @@ using namespace std::chrono_literals;
 using namespace std::string_literals;
 using namespace tf2_bot_detector;
 
-namespace mh
-{
-	template<typename T>
-	class property
-	{
-	public:
-		constexpr property() = default;
-		constexpr explicit property(const T& value) : m_Value(value) {}
-		constexpr explicit property(T&& value) : m_Value(std::move(value)) {}
-
-		constexpr const T& get() const { return m_Value; }
-		constexpr operator const T& () const { return get(); }
-
-		constexpr property& operator=(const property& rhs) { return set(rhs); }
-		constexpr property& operator=(const T& rhs) { return set(rhs); }
-		constexpr property& operator=(T&& rhs) { return set(std::move(rhs)); }
-
-		constexpr property& set(const T& newValue)
-		{
-			if (newValue != m_Value && OnChange(newValue))
-				m_Value = newValue;
-
-			return *this;
-		}
-		constexpr property& set(T&& newValue)
-		{
-			if (newValue != m_Value && OnChange(newValue))
-				m_Value = std::move(newValue);
-
-			return *this;
-		}
-
-		constexpr auto operator<=>(const property&) const = default;
-
-	protected:
-		virtual bool OnChange(const T& newValue) const { return true; }
-
-	private:
-		T m_Value;
-	};
-
-	template<typename T> constexpr auto operator<=>(const property<T>& lhs, const T& rhs) { return lhs.get() <=> rhs; }
-	template<typename T> constexpr auto operator<=>(const T& lhs, const property<T>& rhs) { return lhs <=> rhs.get(); }
-	template<typename T> constexpr auto operator==(const property<T>& lhs, const T& rhs) { return lhs.get() == rhs; }
-	template<typename T> constexpr bool operator==(const T& lhs, const property<T>& rhs) { return lhs == rhs.get(); }
-}
-
 static constexpr const char DEFAULT_LARGE_IMAGE_KEY[] = "tf2_1x1";
 
 static constexpr LogMessageColor DISCORD_LOG_COLOR{ 117 / 255.0f, 136 / 255.0f, 215 / 255.0f };
 
-static bool s_DiscordDebugLogEnabled = true;
+// Read from the discord thread, set from the main thread
+static std::atomic_bool s_DiscordDebugLogEnabled = true;
 
 template<typename... TArgs>
 static auto DiscordDebugLog(const std::string_view& fmtStr, const TArgs&... args) ->
@@ -183,97 +141,60 @@ MH_ENUM_REFLECT_BEGIN(ConnectionState)
 	MH_ENUM_REFLECT_VALUE(Nonlocal)
 MH_ENUM_REFLECT_END()
 
-static std::strong_ordering strcmp3(const char* lhs, const char* rhs)
-{
-	const auto result = strcmp(lhs, rhs);
-	if (result < 0)
-		return std::strong_ordering::less;
-	else if (result == 0)
-		return std::strong_ordering::equal;
-	else //if (result > 0)
-		return std::strong_ordering::greater;
-}
-
-static std::strong_ordering operator<=>(const discord::ActivityTimestamps& lhs, const discord::ActivityTimestamps& rhs)
-{
-	if (auto result = lhs.GetStart() <=> rhs.GetStart(); result != 0)
-		return result;
-	if (auto result = lhs.GetEnd() <=> rhs.GetEnd(); result != 0)
-		return result;
-
-	return std::strong_ordering::equal;
-}
-
-static std::strong_ordering operator<=>(const discord::ActivityAssets& lhs, const discord::ActivityAssets& rhs)
+namespace
 {
-	if (auto result = strcmp3(lhs.GetLargeImage(), rhs.GetLargeImage()); result != 0)
-		return result;
-	if (auto result = strcmp3(lhs.GetLargeText(), rhs.GetLargeText()); result != 0)
-		return result;
-	if (auto result = strcmp3(lhs.GetSmallImage(), rhs.GetSmallImage()); result != 0)
-		return result;
-	if (auto result = strcmp3(lhs.GetSmallText(), rhs.GetSmallText()); result != 0)
-		return result;
-
-	return std::strong_ordering::equal;
+	// Everything we put in a discord::Activity, in a form that is cheap to copy and compare
+	struct DiscordActivityState
+	{
+		std::string m_State;
+		std::string m_Details;
+		std::string m_LargeImage;
+		std::string m_SmallImage;
+		std::string m_SmallText;
+		discord::Timestamp m_StartTime{};
+		std::string m_PartyID;
+		int32_t m_PartySize{};
+		int32_t m_PartyMaxSize{};
+
+		bool operator==(const DiscordActivityState&) const = default;
+
+		discord::Activity ToActivity() const;
+	};
 }
 
-static std::strong_ordering operator<=>(const discord::PartySize& lhs, const discord::PartySize& rhs)
+discord::Activity DiscordActivityState::ToActivity() const
 {
-	if (auto result = lhs.GetCurrentSize() <=> rhs.GetCurrentSize(); result != 0)
-		return result;
-	if (auto result = lhs.GetMaxSize() <=> rhs.GetMaxSize(); result != 0)
-		return result;
+	discord::Activity retVal{};
+	retVal.SetState(m_State.c_str());
+	retVal.SetDetails(m_Details.c_str());
 
-	return std::strong_ordering::equal;
-}
+	if (m_StartTime != discord::Timestamp{})
+		retVal.GetTimestamps().SetStart(m_StartTime);
 
-static std::strong_ordering operator<=>(const discord::ActivityParty& lhs, const discord::ActivityParty& rhs)
-{
-	if (auto result = strcmp3(lhs.GetId(), rhs.GetId()); result != 0)
-		return result;
-	if (auto result = lhs.GetSize() <=> rhs.GetSize(); result != 0)
-		return result;
+	auto& assets = retVal.GetAssets();
+	assets.SetLargeImage(m_LargeImage.c_str());
+	assets.SetSmallImage(m_SmallImage.c_str());
+	assets.SetSmallText(m_SmallText.c_str());
 
-	return std::strong_ordering::equal;
-}
+	if (!m_PartyID.empty())
+	{
+		auto& party = retVal.GetParty();
+		party.SetId(m_PartyID.c_str());
+		party.GetSize().SetCurrentSize(m_PartySize);
+		party.GetSize().SetMaxSize(m_PartyMaxSize);
 
-static std::strong_ordering operator<=>(const discord::ActivitySecrets& lhs, const discord::ActivitySecrets& rhs)
-{
-	if (auto result = strcmp3(lhs.GetMatch(), rhs.GetMatch()); result != 0)
-		return result;
-	if (auto result = strcmp3(lhs.GetJoin(), rhs.GetJoin()); result != 0)
-		return result;
-	if (auto result = strcmp3(lhs.GetSpectate(), rhs.GetSpectate()); result != 0)
-		return result;
-
-	return std::strong_ordering::equal;
-}
+#ifdef _DEBUG
+		// In case discord changes their max party id string length in the future or something
+		{
+			const char* setPartyID = party.GetId();
+			assert(setPartyID);
+			if (setPartyID)
+				assert(!strncmp(m_PartyID.c_str(), setPartyID, m_PartyID.size()));
+		}
+#endif
+	}
 
-static std::strong_ordering operator<=>(const discord::Activity& lhs, const discord::Activity& rhs)
-{
-	if (auto result = lhs.GetType() <=> rhs.GetType(); result != 0)
-		return result;
-	if (auto result = lhs.GetApplicationId() <=> rhs.GetApplicationId(); result != 0)
-		return result;
-	if (auto result = strcmp3(lhs.GetName(), rhs.GetName()); result != 0)
-		return result;
-	if (auto result = strcmp3(lhs.GetState(), rhs.GetState()); result != 0)
-		return result;
-	if (auto result = strcmp3(lhs.GetDetails(), rhs.GetDetails()); result != 0)
-		return result;
-	if (auto result = lhs.GetTimestamps() <=> rhs.GetTimestamps(); result != 0)
-		return result;
-	if (auto result = lhs.GetAssets() <=> rhs.GetAssets(); result != 0)
-		return result;
-	if (auto result = lhs.GetParty() <=> rhs.GetParty(); result != 0)
-		return result;
-	if (auto result = lhs.GetSecrets() <=> rhs.GetSecrets(); result != 0)
-		return result;
-	if (auto result = lhs.GetInstance() <=> rhs.GetInstance(); result != 0)
-		return result;
-
-	return std::strong_ordering::equal;
+	return retVal;
 }
 
 namespace discord
@@ -367,7 +288,12 @@ namespace
 	{
 		DiscordGameState(const Settings& settings, const DRPInfo& drpInfo) : m_Settings(&settings), m_DRPInfo(&drpInfo) {}
 
-		discord::Activity ConstructActivity() const;
+		DiscordActivityState ConstructActivity() const;
+
+		// Set whenever something that ends up in the activity changes
+		bool IsDirty() const { return m_Dirty; }
+		void MarkDirty() { m_Dirty = true; }
+		void ClearDirty() { m_Dirty = false; }
 
 		void OnQueueStateChange(TFMatchGroup queueType, TFQueueStateChange state);
 		void OnQueueStatusUpdate(TFMatchGroup queueType, time_point_t queueStartTime);
@@ -392,6 +318,16 @@ namespace
 		const Settings* m_Settings = nullptr;
 		const DRPInfo* m_DRPInfo = nullptr;
 
+		bool m_Dirty = true;
+		template<typename T, typename TValue> void SetValue(T& variable, TValue&& value)
+		{
+			if (variable != value)
+			{
+				variable = std::forward<TValue>(value);
+				m_Dirty = true;
+			}
+		}
+
 		struct QueueState
 		{
 			bool m_Active = false;
@@ -410,20 +346,17 @@ namespace
 		bool m_InLobby = false;
 		time_point_t m_LastStatusTimestamp;
 
-		PartyInfo m_PartyInfo;
-
-		struct : public mh::property<ConnectionState>
-		{
-			using BaseClass = mh::property<ConnectionState>;
-			using BaseClass::operator=;
+		// Map lookups only happen when the map (or whether the DRP info has loaded) changes
+		mutable std::string m_CachedMapName;
+		mutable bool m_CachedMapDRPInfoLoaded = false;
+		mutable std::string m_CachedMapLargeImage;
+		const std::string& GetMapLargeImage() const;
 
-			bool OnChange(const ConnectionState& newValue) const override
-			{
-				DiscordDebugLog(mh::format("ConnectionState {} -> {}", mh::enum_fmt(get()), mh::enum_fmt(newValue)));
-				return true;
-			}
+		PartyInfo m_PartyInfo;
+		void SetPartyInfo(const PartyInfo& partyInfo);
 
-		} m_ConnectionState;
+		ConnectionState m_ConnectionState = ConnectionState::Disconnected;
+		void SetConnectionState(ConnectionState state);
 	};
 }
 
@@ -467,7 +400,7 @@ std::optional<time_point_t> DiscordGameState::GetEarliestActiveQueueStartTime()
 	return retVal;
 }
 
-static void SetHashedPartyId(discord::ActivityParty& discordParty, const DiscordGameState::PartyInfo& gameParty)
+static std::string GetHashedPartyId(const DiscordGameState::PartyInfo& gameParty)
 {
 	// I'm not 100% sure that discord exposes the party id to clients, but rather than
 	// find out the hard way that its possible to annoy people in parties, we hash the
@@ -497,37 +430,41 @@ static void SetHashedPartyId(discord::ActivityParty& discordParty, const Discord
 	for (CryptoPP::byte byte : digestBufRaw)
 		digestStr.sprintf("%02x", byte);
 
-	discordParty.SetId(digestStr.c_str());
+	return std::string(digestStr.c_str());
+}
 
-#ifdef _DEBUG
-	// In case discord changes their max party id string length in the future or something
+const std::string& DiscordGameState::GetMapLargeImage() const
+{
+	const bool drpInfoLoaded = m_DRPInfo->IsLoaded();
+	if (m_CachedMapName != m_MapName || m_CachedMapDRPInfoLoaded != drpInfoLoaded)
 	{
-		const char* setPartyID = discordParty.GetId();
-		assert(setPartyID);
-		if (setPartyID)
-			assert(!strncmp(digestStr.c_str(), setPartyID, digestStr.size()));
+		m_CachedMapName = m_MapName;
+		m_CachedMapDRPInfoLoaded = drpInfoLoaded;
+
+		if (auto map = m_DRPInfo->FindMap(m_MapName))
+			m_CachedMapLargeImage = mh::format("map_{}", map->m_MapNames.at(0));
+		else
+			m_CachedMapLargeImage = "map_unknown";
 	}
-#endif
+
+	return m_CachedMapLargeImage;
 }
 
-discord::Activity DiscordGameState::ConstructActivity() const
+DiscordActivityState DiscordGameState::ConstructActivity() const
 {
-	discord::Activity retVal{};
+	DiscordActivityState retVal{};
 
-	std::string details;
+	std::string& details = retVal.m_Details;
 
 	if (m_ConnectionState != ConnectionState::Disconnected && !m_MapName.empty())
 	{
-		if (auto map = m_DRPInfo->FindMap(m_MapName))
-			retVal.GetAssets().SetLargeImage(mh::format("map_{}", map->m_MapNames.at(0)).c_str());
-		else
-			retVal.GetAssets().SetLargeImage("map_unknown");
+		retVal.m_LargeImage = GetMapLargeImage();
 
 		details = m_MapName;
 	}
 	else
 	{
-		retVal.GetAssets().SetLargeImage(DEFAULT_LARGE_IMAGE_KEY);
+		retVal.m_LargeImage = DEFAULT_LARGE_IMAGE_KEY;
 	}
 
 	const auto GetGameState = [&]
@@ -558,27 +495,27 @@ discord::Activity DiscordGameState::ConstructActivity() const
 		const bool isComp = IsAnyQueueActive(TFMatchGroupFlags::Competitive);
 
 		if (isCasual && isComp && isMVM)
-			retVal.SetState("Searching - Casual, Competitive, and MVM");
+			retVal.m_State = "Searching - Casual, Competitive, and MVM";
 		else if (isCasual && isComp)
-			retVal.SetState("Searching - Casual & Competitive");
+			retVal.m_State = "Searching - Casual & Competitive";
 		else if (isCasual && isMVM)
-			retVal.SetState("Searching - Casual & MVM");
+			retVal.m_State = "Searching - Casual & MVM";
 		else if (isCasual)
-			retVal.SetState("Searching - Casual");
+			retVal.m_State = "Searching - Casual";
 		else if (isComp && isMVM)
-			retVal.SetState("Searching - Competitive & MVM");
+			retVal.m_State = "Searching - Competitive & MVM";
 		else if (isComp)
-			retVal.SetState("Searching - Competitive");
+			retVal.m_State = "Searching - Competitive";
 		else if (isMVM)
-			retVal.SetState("Searching - MVM");
+			retVal.m_State = "Searching - MVM";
 		else
 		{
 			assert(!"Unknown combination of flags");
-			retVal.SetState("Searching");
+			retVal.m_State = "Searching";
 		}
 
 		if (auto startTime = GetEarliestActiveQueueStartTime())
-			retVal.GetTimestamps().SetStart(to_seconds<discord::Timestamp>(startTime->time_since_epoch()));
+			retVal.m_StartTime = to_seconds<discord::Timestamp>(startTime->time_since_epoch());
 
 		if (m_ConnectionState != ConnectionState::Disconnected)
 		{
@@ -590,58 +527,54 @@ discord::Activity DiscordGameState::ConstructActivity() const
 	}
 	else
 	{
-		retVal.SetState(GetGameState());
+		retVal.m_State = GetGameState();
 	}
 
 	if (m_PartyInfo.m_TFParty.m_MemberCount > 0)
 	{
 		// Party ID (so discord knows two people are in the same party)
-		SetHashedPartyId(retVal.GetParty(), m_PartyInfo);
+		retVal.m_PartyID = GetHashedPartyId(m_PartyInfo);
 
-		retVal.GetParty().GetSize().SetCurrentSize(m_PartyInfo.m_TFParty.m_MemberCount);
-		retVal.GetParty().GetSize().SetMaxSize(6);
+		retVal.m_PartySize = m_PartyInfo.m_TFParty.m_MemberCount;
+		retVal.m_PartyMaxSize = 6;
 	}
 
 	if (m_ConnectionState != ConnectionState::Disconnected)
 	{
-		auto& assets = retVal.GetAssets();
+		const auto SetClass = [&](const char* image, const char* text)
+		{
+			retVal.m_SmallImage = image;
+			retVal.m_SmallText = text;
+		};
+
 		switch (m_LastSpawnedClass)
 		{
 		case TFClassType::Demoman:
-			assets.SetSmallImage("leaderboard_class_demo");
-			assets.SetSmallText("Demo");
+			SetClass("leaderboard_class_demo", "Demo");
 			break;
 		case TFClassType::Engie:
-			assets.SetSmallImage("leaderboard_class_engineer");
-			assets.SetSmallText("Engineer");
+			SetClass("leaderboard_class_engineer", "Engineer");
 			break;
 		case TFClassType::Heavy:
-			assets.SetSmallImage("leaderboard_class_heavy");
-			assets.SetSmallText("Heavy");
+			SetClass("leaderboard_class_heavy", "Heavy");
 			break;
 		case TFClassType::Medic:
-			assets.SetSmallImage("leaderboard_class_medic");
-			assets.SetSmallText("Medic");
+			SetClass("leaderboard_class_medic", "Medic");
 			break;
 		case TFClassType::Pyro:
-			assets.SetSmallImage("leaderboard_class_pyro");
-			assets.SetSmallText("Pyro");
+			SetClass("leaderboard_class_pyro", "Pyro");
 			break;
 		case TFClassType::Scout:
-			assets.SetSmallImage("leaderboard_class_scout");
-			assets.SetSmallText("Scout");
+			SetClass("leaderboard_class_scout", "Scout");
 			break;
 		case TFClassType::Sniper:
-			assets.SetSmallImage("leaderboard_class_sniper");
-			assets.SetSmallText("Sniper");
+			SetClass("leaderboard_class_sniper", "Sniper");
 			break;
 		case TFClassType::Soldier:
-			assets.SetSmallImage("leaderboard_class_soldier");
-			assets.SetSmallText("Soldier");
+			SetClass("leaderboard_class_soldier", "Soldier");
 			break;
 		case TFClassType::Spy:
-			assets.SetSmallImage("leaderboard_class_spy");
-			assets.SetSmallText("Spy");
+			SetClass("leaderboard_class_spy", "Spy");
 			break;
 
 		case TFClassType::Undefined:
@@ -649,8 +582,6 @@ discord::Activity DiscordGameState::ConstructActivity() const
 		}
 	}
 
-	retVal.SetDetails(details.c_str());
-
 	return retVal;
 }
 
@@ -661,12 +592,12 @@ void DiscordGameState::OnQueueStateChange(TFMatchGroup queueType, TFQueueStateCh
 
 	if (state == TFQueueStateChange::Entered)
 	{
-		queue.m_Active = true;
-		queue.m_StartTime = tfbd_clock_t::now();
+		SetValue(queue.m_Active, true);
+		SetValue(queue.m_StartTime, tfbd_clock_t::now());
 	}
 	else if (state == TFQueueStateChange::Exited || state == TFQueueStateChange::RequestedExit)
 	{
-		queue.m_Active = false;
+		SetValue(queue.m_Active, false);
 	}
 }
 
@@ -674,8 +605,8 @@ void DiscordGameState::OnQueueStatusUpdate(TFMatchGroup queueType, time_point_t
 {
 	DiscordDebugLog(MH_SOURCE_LOCATION_CURRENT());
 	auto& queue = m_QueueStates.at(size_t(queueType));
-	queue.m_Active = true;
-	queue.m_StartTime = queueStartTime;
+	SetValue(queue.m_Active, true);
+	SetValue(queue.m_StartTime, queueStartTime);
 }
 
 void DiscordGameState::OnServerIPUpdate(const std::string_view& localIP)
@@ -688,7 +619,7 @@ void DiscordGameState::OnServerIPUpdate(const std::string_view& localIP)
 	else
 	{
 		SetInLocalServer(false);
-		m_ConnectionState = ConnectionState::Nonlocal;
+		SetConnectionState(ConnectionState::Nonlocal);
 	}
 }
 
@@ -696,9 +627,9 @@ void DiscordGameState::SetInLobby(bool inLobby)
 {
 	DiscordDebugLog(MH_SOURCE_LOCATION_CURRENT());
 	if (inLobby)
-		m_ConnectionState = ConnectionState::Nonlocal;
+		SetConnectionState(ConnectionState::Nonlocal);
 
-	m_InLobby = inLobby;
+	SetValue(m_InLobby, inLobby);
 }
 
 void DiscordGameState::SetInLocalServer(bool inLocalServer)
@@ -706,8 +637,8 @@ void DiscordGameState::SetInLocalServer(bool inLocalServer)
 	DiscordDebugLog(MH_SOURCE_LOCATION_CURRENT());
 	if (inLocalServer)
 	{
-		m_ConnectionState = ConnectionState::Local;
-		m_InLobby = false;
+		SetConnectionState(ConnectionState::Local);
+		SetValue(m_InLobby, false);
 	}
 }
 
@@ -717,23 +648,28 @@ void DiscordGameState::SetInParty(bool inParty)
 	if (inParty)
 	{
 		if (m_PartyInfo.m_TFParty.m_MemberCount < 1)
-			m_PartyInfo.m_TFParty.m_MemberCount = 1;
+			SetValue(m_PartyInfo.m_TFParty.m_MemberCount, uint8_t(1));
 	}
 	else
 	{
-		m_PartyInfo.m_TFParty =
-		{
-			.m_MemberCount = 0,
-		};
+		SetPartyInfo(PartyInfo
+			{
+				.m_TFParty =
+				{
+					.m_MemberCount = 0,
+				},
+				.m_CasualBanTime = m_PartyInfo.m_CasualBanTime,
+				.m_RankedBanTime = m_PartyInfo.m_RankedBanTime,
+			});
 	}
 }
 
 void DiscordGameState::SetMapName(std::string mapName)
 {
 	DiscordDebugLog(MH_SOURCE_LOCATION_CURRENT());
-	m_MapName = std::move(mapName);
+	SetValue(m_MapName, std::move(mapName));
 	if (m_MapName.empty())
-		m_LastSpawnedClass = TFClassType::Undefined;
+		SetValue(m_LastSpawnedClass, TFClassType::Undefined);
 }
 
 void DiscordGameState::UpdateParty(const TFParty& party)
@@ -742,7 +678,10 @@ void DiscordGameState::UpdateParty(const TFParty& party)
 	if (party.m_MemberCount > 0)
 	{
 		SetInParty(true);
-		m_PartyInfo.m_TFParty = party;
+
+		PartyInfo partyInfo = m_PartyInfo;
+		partyInfo.m_TFParty = party;
+		SetPartyInfo(partyInfo);
 	}
 }
 
@@ -752,10 +691,10 @@ void DiscordGameState::UpdatePartyMatchmakingBanTime(MatchmakingBannedTimeLine::
 	switch (ladderType)
 	{
 	case LadderType::Casual:
-		m_PartyInfo.m_CasualBanTime = banTime;
+		SetValue(m_PartyInfo.m_CasualBanTime, banTime);
 		return;
 	case LadderType::Competitive:
-		m_PartyInfo.m_RankedBanTime = banTime;
+		SetValue(m_PartyInfo.m_RankedBanTime, banTime);
 		return;
 	}
 
@@ -765,28 +704,72 @@ void DiscordGameState::UpdatePartyMatchmakingBanTime(MatchmakingBannedTimeLine::
 void DiscordGameState::OnLocalPlayerSpawned(TFClassType classType)
 {
 	DiscordDebugLog(MH_SOURCE_LOCATION_CURRENT());
-	m_LastSpawnedClass = classType;
+	SetValue(m_LastSpawnedClass, classType);
 }
 
 void DiscordGameState::OnConnectionCountUpdate(unsigned connectionCount)
 {
 	DiscordDebugLog(MH_SOURCE_LOCATION_CURRENT());
 	if (connectionCount < 1)
-		m_ConnectionState = ConnectionState::Disconnected;
+		SetConnectionState(ConnectionState::Disconnected);
+}
+
+void DiscordGameState::SetPartyInfo(const PartyInfo& partyInfo)
+{
+	if (m_PartyInfo.m_TFParty.m_PartyID != partyInfo.m_TFParty.m_PartyID ||
+		m_PartyInfo.m_TFParty.m_LeaderID != partyInfo.m_TFParty.m_LeaderID ||
+		m_PartyInfo.m_TFParty.m_MemberCount != partyInfo.m_TFParty.m_MemberCount ||
+		m_PartyInfo.m_CasualBanTime != partyInfo.m_CasualBanTime ||
+		m_PartyInfo.m_RankedBanTime != partyInfo.m_RankedBanTime)
+	{
+		m_PartyInfo = partyInfo;
+		m_Dirty = true;
+	}
+}
+
+void DiscordGameState::SetConnectionState(ConnectionState state)
+{
+	if (m_ConnectionState == state)
+		return;
+
+	DiscordDebugLog("ConnectionState {} -> {}", mh::enum_fmt(m_ConnectionState), mh::enum_fmt(state));
+	m_ConnectionState = state;
+	m_Dirty = true;
 }
 
 namespace
 {
-	class DiscordState final : public IDRPManager, AutoWorldEventListener, AutoConsoleLineListener
+	// Discord allows 5 activity updates per 20 seconds. Stay comfortably under that: at most
+	// 4 in any 20 second window.
+	class ActivityUpdateRateLimiter final
 	{
 	public:
-		static constexpr duration_t UPDATE_INTERVAL = 10s;
-		static_assert(UPDATE_INTERVAL >= (20s / 5), "Update interval too low");
+		static constexpr size_t MAX_UPDATES = 4;
+		static constexpr duration_t WINDOW = 20s;
+
+		bool CanUpdate(time_point_t now) const
+		{
+			const time_point_t oldest = m_UpdateTimes[m_NextIndex];
+			return oldest == time_point_t{} || (now - oldest) >= WINDOW;
+		}
+
+		void OnUpdate(time_point_t now)
+		{
+			m_UpdateTimes[m_NextIndex] = now;
+			m_NextIndex = (m_NextIndex + 1) % MAX_UPDATES;
+		}
 
+	private:
+		std::array<time_point_t, MAX_UPDATES> m_UpdateTimes{};
+		size_t m_NextIndex = 0;
+	};
+
+	class DiscordState final : public IDRPManager, AutoWorldEventListener, AutoConsoleLineListener
+	{
+	public:
 		DiscordState(const Settings& settings, IWorldState& world);
 		~DiscordState();
 
-		void QueueUpdate() { m_WantsUpdate = true; }
 		void Update() override;
 
 		void OnConsoleLineParsed(IWorldState& world, IConsoleLine& line) override;
@@ -795,9 +778,6 @@ namespace
 	private:
 		mh::thread_sentinel m_Sentinel;
 
-		std::unique_ptr<discord::Core> m_Core;
-		time_point_t m_LastDiscordInitializeTime{};
-
 		const Settings& GetSettings() const { return m_Settings; }
 		IWorldState& GetWorld() { return m_WorldState; }
 
@@ -805,10 +785,22 @@ namespace
 		IWorldState& m_WorldState;
 		DRPInfo m_DRPInfo;
 		DiscordGameState m_GameState;
+		bool m_DRPInfoLoaded = false;
+
+		// Last state handed to the discord thread, so we only wake it up for actual changes
+		std::optional<DiscordActivityState> m_LastQueuedState;
+
+		// The discord game sdk calls (including Core::Create) can block for a while, so they only
+		// ever happen on the discord thread. Everything below here is shared with it.
+		void DiscordThreadFunc();
+		static bool InitializeCore(std::unique_ptr<discord::Core>& core);
+
+		std::mutex m_DiscordMutex;
+		std::condition_variable m_DiscordCV;
+		std::optional<DiscordActivityState> m_PendingState;
+		bool m_ShutdownRequested = false;
 
-		bool m_WantsUpdate = false;
-		time_point_t m_LastUpdate{};
-		discord::Activity m_CurrentActivity{};
+		std::thread m_DiscordThread;  // Must be last
 	};
 }
 
@@ -820,11 +812,21 @@ DiscordState::DiscordState(const Settings& settings, IWorldState& world) :
 	m_GameState(settings, m_DRPInfo),
 	m_DRPInfo(settings)
 {
+	s_DiscordDebugLogEnabled = GetSettings().m_Logging.m_DiscordRichPresence;
+	m_DiscordThread = std::thread(&DiscordState::DiscordThreadFunc, this);
 }
 
 DiscordState::~DiscordState()
 {
 	DiscordDebugLog(MH_SOURCE_LOCATION_CURRENT());
+
+	{
+		std::lock_guard lock(m_DiscordMutex);
+		m_ShutdownRequested = true;
+	}
+
+	m_DiscordCV.notify_all();
+	m_DiscordThread.join();
 }
 
 void DiscordState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& line)
@@ -835,54 +837,46 @@ void DiscordState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& line)
 	{
 	case ConsoleLineType::PlayerStatusMapPosition:
 	{
-		QueueUpdate();
 		auto& statusLine = static_cast<const ServerStatusMapLine&>(line);
 		m_GameState.SetMapName(statusLine.GetMapName());
 		break;
 	}
 	case ConsoleLineType::PartyHeader:
 	{
-		QueueUpdate();
 		auto& partyLine = static_cast<const PartyHeaderLine&>(line);
 		m_GameState.UpdateParty(partyLine.GetParty());
 		break;
 	}
 	case ConsoleLineType::MatchmakingBannedTime:
 	{
-		QueueUpdate();
 		auto& banLine = static_cast<const MatchmakingBannedTimeLine&>(line);
 		m_GameState.UpdatePartyMatchmakingBanTime(banLine.GetLadderType(), banLine.GetBannedTime());
 		break;
 	}
 	case ConsoleLineType::LobbyHeader:
 	{
-		QueueUpdate();
 		m_GameState.SetInLobby(true);
 		break;
 	}
 	case ConsoleLineType::LobbyStatusFailed:
 	{
-		QueueUpdate();
 		m_GameState.SetInLobby(false);
 		break;
 	}
 	case ConsoleLineType::QueueStateChange:
 	{
-		QueueUpdate();
 		auto& queueLine = static_cast<const QueueStateChangeLine&>(line);
 		m_GameState.OnQueueStateChange(queueLine.GetQueueType(), queueLine.GetStateChange());
 		break;
 	}
 	case ConsoleLineType::InQueue:
 	{
-		QueueUpdate();
 		auto& queueLine = static_cast<const InQueueLine&>(line);
 		m_GameState.OnQueueStatusUpdate(queueLine.GetQueueType(), queueLine.GetQueueStartTime());
 		break;
 	}
 	case ConsoleLineType::LobbyChanged:
 	{
-		QueueUpdate();
 		auto& lobbyLine = static_cast<const LobbyChangedLine&>(line);
 		if (lobbyLine.GetChangeType() == LobbyChangeType::Destroyed)
 			m_GameState.SetMapName("");
@@ -891,7 +885,6 @@ void DiscordState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& line)
 	}
 	case ConsoleLineType::ServerJoin:
 	{
-		QueueUpdate();
 		auto& joinLine = static_cast<const ServerJoinLine&>(line);
 		m_GameState.SetMapName(joinLine.GetMapName());
 		// Not necessarily in a lobby at this point, but in-lobby state will be reapplied soon if we are in a lobby
@@ -900,34 +893,29 @@ void DiscordState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& line)
 	}
 	case ConsoleLineType::HostNewGame:
 	{
-		QueueUpdate();
 		m_GameState.SetInLocalServer(true);
 		break;
 	}
 	case ConsoleLineType::PlayerStatusIP:
 	{
-		QueueUpdate();
 		auto& ipLine = static_cast<const ServerStatusPlayerIPLine&>(line);
 		m_GameState.OnServerIPUpdate(ipLine.GetLocalIP());
 		break;
 	}
 	case ConsoleLineType::NetStatusConfig:
 	{
-		QueueUpdate();
 		auto& netLine = static_cast<const NetStatusConfigLine&>(line);
 		m_GameState.OnConnectionCountUpdate(netLine.GetConnectionCount());
 		break;
 	}
 	case ConsoleLineType::Connecting:
 	{
-		QueueUpdate();
 		auto& connLine = static_cast<const ConnectingLine&>(line);
 		m_GameState.OnServerIPUpdate(connLine.GetAddress());
 		break;
 	}
 	case ConsoleLineType::SVC_UserMessage:
 	{
-		QueueUpdate();
 		auto& umsgLine = static_cast<SVCUserMessageLine&>(line);
 		m_GameState.OnServerIPUpdate(umsgLine.GetAddress());
 		break;
@@ -941,8 +929,6 @@ void DiscordState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& line)
 void DiscordState::OnLocalPlayerSpawned(IWorldState& world, TFClassType classType)
 {
 	m_Sentinel.check();
-
-	QueueUpdate();
 	m_GameState.OnLocalPlayerSpawned(classType);
 }
 
@@ -975,88 +961,138 @@ void DiscordState::Update()
 
 	s_DiscordDebugLogEnabled = GetSettings().m_Logging.m_DiscordRichPresence;
 
-	// Initialize discord
-	const auto curTime = tfbd_clock_t::now();
-	if (!m_Core && (curTime - m_LastDiscordInitializeTime) > 10s)
+	// The map image depends on the DRP info, which shows up asynchronously
+	if (!m_DRPInfoLoaded && m_DRPInfo.IsLoaded())
 	{
-		m_LastDiscordInitializeTime = curTime;
+		m_DRPInfoLoaded = true;
+		m_GameState.MarkDirty();
+	}
 
-		discord::Core* core = nullptr;
-		if (auto result = discord::Core::Create(730945386390224976, DiscordCreateFlags_NoRequireDiscord, &core);
-			result != discord::Result::Ok)
-		{
-			DebugLogWarning("Failed to initialize Discord Game SDK: {}", mh::enum_fmt(result));
-		}
-		else
-		{
-			m_Core.reset(core);
+	if (!m_GameState.IsDirty())
+		return;
 
-			core->SetLogHook(discord::LogLevel::Debug, &DiscordLogHookFunc);
+	m_GameState.ClearDirty();
 
-			if (auto result = m_Core->ActivityManager().RegisterSteam(440); result != discord::Result::Ok)
-				DebugLogWarning("Failed to register discord integration as steam appid 440: {}", mh::enum_fmt(result));
-		}
+	auto nextState = m_GameState.ConstructActivity();
+	if (m_LastQueuedState == nextState)
+		return;
+
+	m_LastQueuedState = nextState;
+
+	{
+		std::lock_guard lock(m_DiscordMutex);
+		m_PendingState = std::move(nextState);
 	}
 
-	if (m_Core)
+	m_DiscordCV.notify_one();
+}
+
+bool DiscordState::InitializeCore(std::unique_ptr<discord::Core>& core)
+{
+	discord::Core* newCore = nullptr;
+	if (auto result = discord::Core::Create(730945386390224976, DiscordCreateFlags_NoRequireDiscord, &newCore);
+		result != discord::Result::Ok)
 	{
-		std::invoke([&]()
-			{
-				if (!m_WantsUpdate)
-					return;
+		DebugLogWarning("Failed to initialize Discord Game SDK: {}", mh::enum_fmt(result));
+		return false;
+	}
 
-				if ((curTime - m_LastUpdate) < UPDATE_INTERVAL)
-					return;
+	core.reset(newCore);
 
-				if (const auto nextActivity = m_GameState.ConstructActivity();
-					std::is_neq(nextActivity <=> m_CurrentActivity))
-				{
-					// Perform the update
-					m_Core->ActivityManager().UpdateActivity(nextActivity, [nextActivity](discord::Result result)
-						{
-							if (result == discord::Result::Ok)
-							{
-								DiscordDebugLog("Updated discord activity state: {}", nextActivity);
-							}
-							else
-							{
-								LogWarning(MH_SOURCE_LOCATION_CURRENT(),
-									"Failed to update discord activity state: {}", mh::enum_fmt(result));
-							}
-						});
-
-					m_CurrentActivity = nextActivity;
-					m_LastUpdate = curTime;
-				}
-				else
-				{
-					DiscordDebugLog(MH_SOURCE_LOCATION_CURRENT(), "Discord activity state unchanged");
-				}
+	core->SetLogHook(discord::LogLevel::Debug, &DiscordLogHookFunc);
 
-				// Update successful
-				m_WantsUpdate = false;
-			});
+	if (auto result = core->ActivityManager().RegisterSteam(440); result != discord::Result::Ok)
+		DebugLogWarning("Failed to register discord integration as steam appid 440: {}", mh::enum_fmt(result));
+
+	return true;
+}
 
-		// Run discord callbacks
-		if (auto result = m_Core->RunCallbacks(); result != discord::Result::Ok)
+void DiscordState::DiscordThreadFunc()
+{
+	constexpr duration_t CALLBACK_INTERVAL = 100ms;
+	constexpr duration_t INITIALIZE_RETRY_INTERVAL = 10s;
+
+	std::unique_ptr<discord::Core> core;
+	time_point_t lastInitializeTime{};
+	ActivityUpdateRateLimiter rateLimiter;
+
+	// What discord is currently showing (as far as we know), and the newest state from the main thread
+	std::optional<DiscordActivityState> currentState;
+	std::optional<DiscordActivityState> nextState;
+
+	std::unique_lock lock(m_DiscordMutex);
+	while (!m_ShutdownRequested)
+	{
+		// Only the newest state matters, anything queued in between is dropped
+		if (m_PendingState)
 		{
-			auto errMsg = mh::format("Failed to run discord callbacks: {}", mh::enum_fmt(result));
-			switch (result)
+			nextState = std::move(m_PendingState);
+			m_PendingState.reset();
+		}
+
+		lock.unlock();
+
+		const auto curTime = tfbd_clock_t::now();
+		if (!core && (curTime - lastInitializeTime) > INITIALIZE_RETRY_INTERVAL)
+		{
+			lastInitializeTime = curTime;
+			if (InitializeCore(core) && currentState)
 			{
-			case discord::Result::NotRunning:
-				DebugLogWarning(std::move(errMsg));
-				// Discord Game SDK will never recover from this state. Need to shutdown and try
-				// to reinitialize in a bit. Also set the last initialize time to now, so we don't
-				// try to reinitialize next frame (which will probably fail).
-				m_Core.reset();
-				m_LastDiscordInitializeTime = curTime;
-				break;
-
-			default:
-				LogError(std::move(errMsg));
-				break;
+				// Fresh connection, discord doesn't know about anything we sent before
+				if (!nextState)
+					nextState = std::move(currentState);
+
+				currentState.reset();
 			}
 		}
+
+		if (core)
+		{
+			if (nextState && nextState != currentState && rateLimiter.CanUpdate(curTime))
+			{
+				const discord::Activity activity = nextState->ToActivity();
+				DiscordDebugLog("Updating discord activity state: {}", activity);
+
+				core->ActivityManager().UpdateActivity(activity, [](discord::Result result)
+					{
+						if (result != discord::Result::Ok)
+						{
+							LogWarning(MH_SOURCE_LOCATION_CURRENT(),
+								"Failed to update discord activity state: {}", mh::enum_fmt(result));
+						}
+					});
+
+				rateLimiter.OnUpdate(curTime);
+				currentState = std::move(nextState);
+				nextState.reset();
+			}
+
+			// Run discord callbacks
+			if (auto result = core->RunCallbacks(); result != discord::Result::Ok)
+			{
+				auto errMsg = mh::format("Failed to run discord callbacks: {}", mh::enum_fmt(result));
+				switch (result)
+				{
+				case discord::Result::NotRunning:
+					DebugLogWarning(std::move(errMsg));
+					// Discord Game SDK will never recover from this state. Need to shutdown and try
+					// to reinitialize in a bit. Also set the last initialize time to now, so we don't
+					// try to reinitialize right away (which will probably fail).
+					core.reset();
+					lastInitializeTime = curTime;
+					break;
+
+				default:
+					LogError(std::move(errMsg));
+					break;
+				}
+			}
+		}
+
+		lock.lock();
+
+		// Wake up early for new states, but the discord callbacks still need to run regularly
+		m_DiscordCV.wait_for(lock, CALLBACK_INTERVAL, [&] { return m_ShutdownRequested || m_PendingState.has_value(); });
 	}
 }
 
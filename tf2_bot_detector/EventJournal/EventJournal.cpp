@@ -0,0 +1,218 @@
+#include "EventJournal.h"
+#include "ConsoleLog/ConsoleLines.h"
+#include "Filesystem.h"
+#include "Log.h"
+
+#include <mh/text/fmtstr.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	class EventJournal final : public IEventJournal
+	{
+	public:
+		EventJournal();
+		~EventJournal();
+
+		void SetEnabled(bool enabled) override { m_Enabled = enabled; }
+		bool IsEnabled() const override { return m_Enabled; }
+
+		void Record(JournalEventType type, SteamID steamID, std::string text, time_point_t timestamp) override;
+		void RecordConsoleLine(const IConsoleLine& line, const std::string_view& text) override;
+
+		void Flush() override;
+
+	private:
+		static constexpr duration_t SEGMENT_INTERVAL = 5s;
+		static constexpr size_t SEGMENT_MAX_RECORDS = 2048;
+		static constexpr size_t SEGMENT_MAX_BYTES = 256 * 1024;
+
+		std::atomic_bool m_Enabled = false;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_WriterCV;
+		std::condition_variable m_FlushedCV;
+		std::vector<JournalRecord> m_Pending;
+		size_t m_PendingBytes = 0;
+		uint64_t m_RecordedCount = 0;  // Total records ever added to m_Pending
+		uint64_t m_WrittenCount = 0;   // Total records that have hit the disk (or failed to)
+		bool m_FlushRequested = false;
+		bool m_ShutdownRequested = false;
+		bool m_WriterStopped = false;
+
+		// Only touched by the writer thread
+		std::ofstream m_File;
+		bool m_WriteFailed = false;
+		void WriteSegment(const std::vector<JournalRecord>& records);
+
+		void WriterThreadFunc();
+		std::thread m_WriterThread; // Must be last
+	};
+
+	int64_t ToJournalTimestamp(time_point_t timestamp)
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count();
+	}
+}
+
+IEventJournal& IEventJournal::GetInstance()
+{
+	static EventJournal s_Journal;
+	return s_Journal;
+}
+
+EventJournal::EventJournal()
+{
+	m_WriterThread = std::thread(&EventJournal::WriterThreadFunc, this);
+}
+
+EventJournal::~EventJournal()
+{
+	{
+		std::lock_guard lock(m_Mutex);
+		m_ShutdownRequested = true;
+	}
+	m_WriterCV.notify_one();
+
+	if (m_WriterThread.joinable())
+		m_WriterThread.join();
+}
+
+void EventJournal::Record(JournalEventType type, SteamID steamID, std::string text, time_point_t timestamp)
+{
+	if (!m_Enabled)
+		return;
+
+	bool segmentFull;
+	{
+		std::lock_guard lock(m_Mutex);
+		m_PendingBytes += text.size();
+		m_Pending.push_back(JournalRecord
+			{
+				.m_Type = type,
+				.m_Timestamp = ToJournalTimestamp(timestamp),
+				.m_SteamID64 = steamID.ID64,
+				.m_Text = std::move(text),
+			});
+		m_RecordedCount++;
+
+		segmentFull = m_Pending.size() >= SEGMENT_MAX_RECORDS || m_PendingBytes >= SEGMENT_MAX_BYTES;
+	}
+
+	if (segmentFull)
+		m_WriterCV.notify_one();
+}
+
+void EventJournal::RecordConsoleLine(const IConsoleLine& line, const std::string_view& text)
+{
+	if (!m_Enabled)
+		return;
+
+	SteamID steamID;
+	switch (line.GetType())
+	{
+	case ConsoleLineType::Chat:
+		steamID = static_cast<const ChatConsoleLine&>(line).GetPlayerSteamID();
+		break;
+	case ConsoleLineType::PlayerStatus:
+		steamID = static_cast<const ServerStatusPlayerLine&>(line).GetPlayerStatus().m_SteamID;
+		break;
+	default:
+		break;
+	}
+
+	Record(JournalEventType::ConsoleLine, steamID, std::string(text), line.GetTimestamp());
+}
+
+void EventJournal::Flush()
+{
+	std::unique_lock lock(m_Mutex);
+	const auto target = m_RecordedCount;
+	m_FlushRequested = true;
+	m_WriterCV.notify_one();
+	m_FlushedCV.wait(lock, [&] { return m_WrittenCount >= target || m_WriterStopped; });
+}
+
+void EventJournal::WriterThreadFunc()
+{
+	std::vector<JournalRecord> records;
+
+	std::unique_lock lock(m_Mutex);
+	while (true)
+	{
+		m_WriterCV.wait_for(lock, SEGMENT_INTERVAL, [&]
+			{
+				return m_ShutdownRequested || m_FlushRequested ||
+					m_Pending.size() >= SEGMENT_MAX_RECORDS || m_PendingBytes >= SEGMENT_MAX_BYTES;
+			});
+
+		// Whether we woke up because of a timeout, a full segment or a flush, write out whatever we have
+		const bool shutdown = m_ShutdownRequested;
+		m_FlushRequested = false;
+		records.swap(m_Pending);
+		m_PendingBytes = 0;
+
+		if (!records.empty())
+		{
+			lock.unlock();
+			WriteSegment(records);
+			lock.lock();
+
+			m_WrittenCount += records.size();
+			records.clear();
+		}
+
+		m_FlushedCV.notify_all();
+
+		if (shutdown)
+			break;
+	}
+
+	m_WriterStopped = true;
+	m_FlushedCV.notify_all();
+}
+
+void EventJournal::WriteSegment(const std::vector<JournalRecord>& records) try
+{
+	if (m_WriteFailed)
+		return;
+
+	if (!m_File.is_open())
+	{
+		const auto dir = IFilesystem::Get().GetLogsDir() / "journal";
+		std::filesystem::create_directories(dir);
+
+		const auto t = ToTM(tfbd_clock_t::now());
+		const auto path = dir / mh::fmtstr<128>("journal_{}{}", std::put_time(&t, "%Y-%m-%d_%H-%M-%S"), JOURNAL_FILE_EXTENSION).view();
+
+		m_File.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!m_File.good())
+		{
+			m_WriteFailed = true;
+			LogError("Failed to open event journal file {}, event journal disabled for this session", path);
+			return;
+		}
+
+		m_File.write(JOURNAL_FILE_MAGIC.data(), JOURNAL_FILE_MAGIC.size());
+		DebugLog("Writing event journal to {}", path);
+	}
+
+	const std::string segment = EncodeJournalSegment(records);
+	m_File.write(segment.data(), segment.size());
+	m_File.flush();
+}
+catch (...)
+{
+	m_WriteFailed = true;
+	LogException("Failed to write event journal segment, event journal disabled for this session");
+}
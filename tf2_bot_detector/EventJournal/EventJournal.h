@@ -0,0 +1,37 @@
+#pragma once
+
+#include "EventJournalFormat.h"
+#include "Clock.h"
+#include "SteamID.h"
+
+#include <string>
+#include <string_view>
+
+namespace tf2_bot_detector
+{
+	class IConsoleLine;
+
+	// Optional compact binary record of everything moderation-relevant that happened, for
+	// after-the-fact auditing with tf2bd_logq. Records are buffered in memory and written out
+	// in compressed segments by a background thread.
+	class IEventJournal
+	{
+	public:
+		virtual ~IEventJournal() = default;
+
+		static IEventJournal& GetInstance();
+
+		// Disabled by default. Records submitted while disabled are thrown away.
+		virtual void SetEnabled(bool enabled) = 0;
+		virtual bool IsEnabled() const = 0;
+
+		virtual void Record(JournalEventType type, SteamID steamID, std::string text,
+			time_point_t timestamp = clock_t::now()) = 0;
+
+		// Picks the most relevant steamid out of the line, if there is one.
+		virtual void RecordConsoleLine(const IConsoleLine& line, const std::string_view& text) = 0;
+
+		// Blocks until everything recorded so far has been written to disk.
+		virtual void Flush() = 0;
+	};
+}
@@ -0,0 +1,348 @@
+#include "EventJournalFormat.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <limits>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	static constexpr size_t RECORD_FIXED_SIZE = sizeof(uint8_t) + sizeof(int64_t) + sizeof(uint64_t);
+
+	template<typename T>
+	void WriteLE(std::string& out, T value)
+	{
+		static_assert(std::is_integral_v<T>);
+		for (size_t i = 0; i < sizeof(T); i++)
+			out.push_back(char(uint8_t(uint64_t(value) >> (i * 8))));
+	}
+
+	template<typename T>
+	T ReadLE(const char*& data)
+	{
+		static_assert(std::is_integral_v<T>);
+		uint64_t value = 0;
+		for (size_t i = 0; i < sizeof(T); i++)
+			value |= uint64_t(uint8_t(data[i])) << (i * 8);
+
+		data += sizeof(T);
+		return T(value);
+	}
+
+	// Two independent 8-bit indices into the 256 bit filter from one good 64 bit mix
+	std::array<uint8_t, 2> GetBloomBits(uint64_t steamID64)
+	{
+		uint64_t x = steamID64 + 0x9e3779b97f4a7c15ull;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+		x = x ^ (x >> 31);
+		return { uint8_t(x), uint8_t(x >> 32) };
+	}
+
+	uint32_t CalcCRC32(const std::string_view& data)
+	{
+		return uint32_t(crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(data.data()), uInt(data.size())));
+	}
+}
+
+const char* tf2_bot_detector::ToString(JournalEventType type)
+{
+	switch (type)
+	{
+	case JournalEventType::ConsoleLine:     return "ConsoleLine";
+	case JournalEventType::RuleMatch:       return "RuleMatch";
+	case JournalEventType::PlayerMarked:    return "PlayerMarked";
+	case JournalEventType::PlayerUnmarked:  return "PlayerUnmarked";
+	case JournalEventType::Votekick:        return "Votekick";
+	case JournalEventType::APIFetch:        return "APIFetch";
+
+	case JournalEventType::COUNT:
+		break;
+	}
+
+	return "Unknown";
+}
+
+std::optional<JournalEventType> tf2_bot_detector::JournalEventTypeFromString(const std::string_view& str)
+{
+	const auto EqualsI = [](const std::string_view& a, const std::string_view& b)
+	{
+		return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+			[](char x, char y) { return std::tolower((unsigned char)x) == std::tolower((unsigned char)y); });
+	};
+
+	for (uint8_t i = 0; i < uint8_t(JournalEventType::COUNT); i++)
+	{
+		if (EqualsI(str, ToString(JournalEventType(i))))
+			return JournalEventType(i);
+	}
+
+	return std::nullopt;
+}
+
+bool JournalSegmentHeader::MayContainSteamID(uint64_t steamID64) const
+{
+	for (uint8_t bit : GetBloomBits(steamID64))
+	{
+		if (!(m_SteamIDBloom[bit / 64] & (1ull << (bit % 64))))
+			return false;
+	}
+
+	return true;
+}
+
+void JournalSegmentHeader::AddSteamID(uint64_t steamID64)
+{
+	for (uint8_t bit : GetBloomBits(steamID64))
+		m_SteamIDBloom[bit / 64] |= (1ull << (bit % 64));
+}
+
+std::string tf2_bot_detector::EncodeJournalSegment(const std::vector<JournalRecord>& records, JournalCompression compression)
+{
+	JournalSegmentHeader header;
+	header.m_Compression = compression;
+	header.m_RecordCount = uint32_t(records.size());
+	header.m_MinTimestamp = std::numeric_limits<int64_t>::max();
+	header.m_MaxTimestamp = std::numeric_limits<int64_t>::min();
+
+	std::string raw;
+	for (const JournalRecord& record : records)
+	{
+		WriteLE(raw, uint32_t(RECORD_FIXED_SIZE + record.m_Text.size()));
+		WriteLE(raw, uint8_t(record.m_Type));
+		WriteLE(raw, record.m_Timestamp);
+		WriteLE(raw, record.m_SteamID64);
+		raw.append(record.m_Text);
+
+		header.m_EventTypeMask |= 1u << uint32_t(record.m_Type);
+		header.m_MinTimestamp = std::min(header.m_MinTimestamp, record.m_Timestamp);
+		header.m_MaxTimestamp = std::max(header.m_MaxTimestamp, record.m_Timestamp);
+		if (record.m_SteamID64 != 0)
+			header.AddSteamID(record.m_SteamID64);
+	}
+
+	if (records.empty())
+		header.m_MinTimestamp = header.m_MaxTimestamp = 0;
+
+	header.m_UncompressedSize = uint32_t(raw.size());
+	header.m_CRC32 = CalcCRC32(raw);
+
+	std::string payload;
+	if (compression == JournalCompression::Zlib)
+	{
+		uLongf compressedSize = compressBound(uLong(raw.size()));
+		payload.resize(compressedSize);
+		if (const int result = compress2(reinterpret_cast<Bytef*>(payload.data()), &compressedSize,
+			reinterpret_cast<const Bytef*>(raw.data()), uLong(raw.size()), Z_DEFAULT_COMPRESSION); result != Z_OK)
+		{
+			throw JournalFormatError("zlib compress2() failed with error " + std::to_string(result));
+		}
+
+		payload.resize(compressedSize);
+	}
+	else
+	{
+		payload = std::move(raw);
+	}
+
+	header.m_CompressedSize = uint32_t(payload.size());
+
+	std::string retVal;
+	retVal.reserve(JournalSegmentHeader::SIZE + payload.size());
+	WriteLE(retVal, JournalSegmentHeader::MAGIC);
+	WriteLE(retVal, header.m_HeaderSize);
+	WriteLE(retVal, uint8_t(header.m_Compression));
+	WriteLE(retVal, uint8_t(0)); // reserved
+	WriteLE(retVal, header.m_RecordCount);
+	WriteLE(retVal, header.m_EventTypeMask);
+	WriteLE(retVal, header.m_MinTimestamp);
+	WriteLE(retVal, header.m_MaxTimestamp);
+	for (uint64_t bloom : header.m_SteamIDBloom)
+		WriteLE(retVal, bloom);
+	WriteLE(retVal, header.m_CompressedSize);
+	WriteLE(retVal, header.m_UncompressedSize);
+	WriteLE(retVal, header.m_CRC32);
+	assert(retVal.size() == JournalSegmentHeader::SIZE);
+
+	retVal.append(payload);
+	return retVal;
+}
+
+bool JournalQuery::MayMatch(const JournalSegmentHeader& header) const
+{
+	if (!(header.m_EventTypeMask & m_EventTypeMask))
+		return false;
+	if (m_MinTimestamp && header.m_MaxTimestamp < *m_MinTimestamp)
+		return false;
+	if (m_MaxTimestamp && header.m_MinTimestamp > *m_MaxTimestamp)
+		return false;
+	if (m_SteamID64 && !header.MayContainSteamID(*m_SteamID64))
+		return false;
+
+	return true;
+}
+
+bool JournalQuery::Matches(const JournalRecord& record) const
+{
+	if (!(m_EventTypeMask & (1u << uint32_t(record.m_Type))))
+		return false;
+	if (m_MinTimestamp && record.m_Timestamp < *m_MinTimestamp)
+		return false;
+	if (m_MaxTimestamp && record.m_Timestamp > *m_MaxTimestamp)
+		return false;
+	if (m_SteamID64 && record.m_SteamID64 != *m_SteamID64)
+		return false;
+
+	return true;
+}
+
+JournalFileReader::JournalFileReader(const std::filesystem::path& path) :
+	m_File(path, std::ios::in | std::ios::binary),
+	m_Path(path)
+{
+	if (!m_File.good())
+		throw JournalFormatError("Failed to open " + path.string());
+
+	m_FileSize = std::filesystem::file_size(path);
+
+	char magic[JOURNAL_FILE_MAGIC.size()]{};
+	if (!m_File.read(magic, sizeof(magic)) || std::string_view(magic, sizeof(magic)) != JOURNAL_FILE_MAGIC)
+		throw JournalFormatError(path.string() + " is not an event journal file");
+}
+
+bool JournalFileReader::ReadNextHeader(JournalSegmentHeader& header)
+{
+	char buf[JournalSegmentHeader::SIZE];
+
+	const auto startPos = uint64_t(m_File.tellg());
+	if (startPos + sizeof(buf) > m_FileSize)
+		return false;
+
+	if (!m_File.read(buf, sizeof(buf)))
+		return false;
+
+	const char* data = buf;
+	if (ReadLE<uint32_t>(data) != JournalSegmentHeader::MAGIC)
+		throw JournalFormatError("Bad segment magic at offset " + std::to_string(startPos) + " in " + m_Path.string());
+
+	header.m_HeaderSize = ReadLE<uint16_t>(data);
+	header.m_Compression = JournalCompression(ReadLE<uint8_t>(data));
+	ReadLE<uint8_t>(data); // reserved
+	header.m_RecordCount = ReadLE<uint32_t>(data);
+	header.m_EventTypeMask = ReadLE<uint32_t>(data);
+	header.m_MinTimestamp = ReadLE<int64_t>(data);
+	header.m_MaxTimestamp = ReadLE<int64_t>(data);
+	for (uint64_t& bloom : header.m_SteamIDBloom)
+		bloom = ReadLE<uint64_t>(data);
+	header.m_CompressedSize = ReadLE<uint32_t>(data);
+	header.m_UncompressedSize = ReadLE<uint32_t>(data);
+	header.m_CRC32 = ReadLE<uint32_t>(data);
+
+	if (header.m_HeaderSize < JournalSegmentHeader::SIZE)
+		throw JournalFormatError("Segment header too small at offset " + std::to_string(startPos) + " in " + m_Path.string());
+
+	// Newer versions may append fields to the header
+	m_File.seekg(header.m_HeaderSize - JournalSegmentHeader::SIZE, std::ios::cur);
+
+	if (startPos + header.m_HeaderSize + header.m_CompressedSize > m_FileSize)
+		return false; // Truncated
+
+	return true;
+}
+
+void JournalFileReader::SkipPayload(const JournalSegmentHeader& header)
+{
+	m_File.seekg(header.m_CompressedSize, std::ios::cur);
+	m_Stats.m_SegmentsSkipped++;
+}
+
+std::vector<JournalRecord> JournalFileReader::ReadPayload(const JournalSegmentHeader& header)
+{
+	std::string payload(header.m_CompressedSize, '\0');
+	if (!m_File.read(payload.data(), payload.size()))
+		throw JournalFormatError("Failed to read segment payload from " + m_Path.string());
+
+	m_Stats.m_SegmentsRead++;
+
+	std::string raw;
+	switch (header.m_Compression)
+	{
+	case JournalCompression::None:
+		raw = std::move(payload);
+		break;
+
+	case JournalCompression::Zlib:
+	{
+		raw.resize(header.m_UncompressedSize);
+		uLongf rawSize = uLongf(raw.size());
+		if (const int result = uncompress(reinterpret_cast<Bytef*>(raw.data()), &rawSize,
+			reinterpret_cast<const Bytef*>(payload.data()), uLong(payload.size())); result != Z_OK)
+		{
+			throw JournalFormatError("zlib uncompress() failed with error " + std::to_string(result) + " in " + m_Path.string());
+		}
+
+		raw.resize(rawSize);
+		break;
+	}
+
+	default:
+		throw JournalFormatError("Unknown segment compression " + std::to_string(int(header.m_Compression)) + " in " + m_Path.string());
+	}
+
+	if (raw.size() != header.m_UncompressedSize || CalcCRC32(raw) != header.m_CRC32)
+		throw JournalFormatError("Segment checksum mismatch in " + m_Path.string());
+
+	std::vector<JournalRecord> retVal;
+	retVal.reserve(header.m_RecordCount);
+
+	const char* data = raw.data();
+	const char* const end = raw.data() + raw.size();
+	while (data != end)
+	{
+		if (size_t(end - data) < sizeof(uint32_t))
+			throw JournalFormatError("Truncated record in " + m_Path.string());
+
+		const auto length = ReadLE<uint32_t>(data);
+		if (length < RECORD_FIXED_SIZE || size_t(end - data) < length)
+			throw JournalFormatError("Bad record length in " + m_Path.string());
+
+		const char* const recordEnd = data + length;
+
+		JournalRecord& record = retVal.emplace_back();
+		record.m_Type = JournalEventType(ReadLE<uint8_t>(data));
+		record.m_Timestamp = ReadLE<int64_t>(data);
+		record.m_SteamID64 = ReadLE<uint64_t>(data);
+		record.m_Text.assign(data, recordEnd);
+		data = recordEnd;
+	}
+
+	return retVal;
+}
+
+std::vector<JournalRecord> JournalFileReader::Query(const JournalQuery& query)
+{
+	std::vector<JournalRecord> retVal;
+
+	JournalSegmentHeader header;
+	while (ReadNextHeader(header))
+	{
+		if (!query.MayMatch(header))
+		{
+			SkipPayload(header);
+			continue;
+		}
+
+		for (JournalRecord& record : ReadPayload(header))
+		{
+			if (query.Matches(record))
+				retVal.push_back(std::move(record));
+		}
+	}
+
+	return retVal;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+// On-disk format of the event journal. Deliberately only depends on the standard library and zlib,
+// so that the offline query tool (tf2bd_logq) can be built without the rest of the application.
+//
+// File layout:
+//   "TF2BDJ01"
+//   segment*
+//
+// Segment layout:
+//   JournalSegmentHeader (little endian, m_HeaderSize bytes)
+//   payload (m_CompressedSize bytes): zlib stream (or raw bytes) of m_UncompressedSize bytes of records
+//
+// Record layout (little endian):
+//   u32 length of everything after this field
+//   u8  JournalEventType
+//   i64 timestamp, milliseconds since unix epoch
+//   u64 steamid64 (0 if the event isn't about a specific player)
+//   text (utf-8, not null terminated)
+//
+// Segment headers contain enough information (time range, event types, a bloom filter of the
+// steamids) that readers can skip over the payloads of segments that can't contain anything
+// they're interested in, without decompressing them.
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	enum class JournalEventType : uint8_t
+	{
+		ConsoleLine,
+		RuleMatch,
+		PlayerMarked,
+		PlayerUnmarked,
+		Votekick,
+		APIFetch,
+
+		COUNT,
+	};
+
+	const char* ToString(JournalEventType type);
+	std::optional<JournalEventType> JournalEventTypeFromString(const std::string_view& str);
+
+	enum class JournalCompression : uint8_t
+	{
+		None,
+		Zlib,
+	};
+
+	struct JournalRecord
+	{
+		JournalEventType m_Type{};
+		int64_t m_Timestamp = 0; // Milliseconds since unix epoch
+		uint64_t m_SteamID64 = 0;
+		std::string m_Text;
+	};
+
+	class JournalFormatError : public std::runtime_error
+	{
+	public:
+		using std::runtime_error::runtime_error;
+	};
+
+	struct JournalSegmentHeader
+	{
+		static constexpr uint32_t MAGIC = 0x31474553; // "SEG1"
+		static constexpr uint16_t SIZE = 76;
+
+		uint16_t m_HeaderSize = SIZE;
+		JournalCompression m_Compression = JournalCompression::None;
+		uint32_t m_RecordCount = 0;
+		uint32_t m_EventTypeMask = 0;
+		int64_t m_MinTimestamp = 0;
+		int64_t m_MaxTimestamp = 0;
+		std::array<uint64_t, 4> m_SteamIDBloom{};
+		uint32_t m_CompressedSize = 0;
+		uint32_t m_UncompressedSize = 0;
+		uint32_t m_CRC32 = 0; // Of the uncompressed records
+
+		bool HasEventType(JournalEventType type) const { return m_EventTypeMask & (1u << uint32_t(type)); }
+
+		// False positives are possible, false negatives are not. 0 is never added to the filter.
+		bool MayContainSteamID(uint64_t steamID64) const;
+		void AddSteamID(uint64_t steamID64);
+	};
+
+	// Encodes a batch of records into a complete segment (header + payload).
+	std::string EncodeJournalSegment(const std::vector<JournalRecord>& records,
+		JournalCompression compression = JournalCompression::Zlib);
+
+	struct JournalQuery
+	{
+		std::optional<uint64_t> m_SteamID64;
+		std::optional<int64_t> m_MinTimestamp;
+		std::optional<int64_t> m_MaxTimestamp;
+		uint32_t m_EventTypeMask = ~uint32_t(0);
+
+		// Could this segment contain a matching record?
+		bool MayMatch(const JournalSegmentHeader& header) const;
+		bool Matches(const JournalRecord& record) const;
+	};
+
+	inline constexpr std::string_view JOURNAL_FILE_MAGIC = "TF2BDJ01";
+	inline constexpr std::string_view JOURNAL_FILE_EXTENSION = ".tf2bdj";
+
+	class JournalFileReader final
+	{
+	public:
+		explicit JournalFileReader(const std::filesystem::path& path);
+
+		// Returns false at the end of the file. A partially written trailing segment (the app
+		// was killed mid-write) is treated as the end of the file.
+		bool ReadNextHeader(JournalSegmentHeader& header);
+
+		// Exactly one of these must be called after each successful ReadNextHeader().
+		void SkipPayload(const JournalSegmentHeader& header);
+		std::vector<JournalRecord> ReadPayload(const JournalSegmentHeader& header);
+
+		// Convenience for the common case. Segments are skipped whenever the query allows it.
+		std::vector<JournalRecord> Query(const JournalQuery& query);
+
+		struct Stats
+		{
+			size_t m_SegmentsRead = 0;
+			size_t m_SegmentsSkipped = 0;
+		};
+		const Stats& GetStats() const { return m_Stats; }
+
+	private:
+		std::ifstream m_File;
+		std::filesystem::path m_Path;
+		uint64_t m_FileSize = 0;
+		Stats m_Stats;
+	};
+}
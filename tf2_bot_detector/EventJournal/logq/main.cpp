@@ -0,0 +1,275 @@
+// tf2bd_logq: offline query tool for event journal files written by the tool.
+//
+//   tf2bd_logq [--steamid <id>] [--from <time>] [--to <time>] [--type <type>[,<type>...]] [--stats] <file or dir>...
+//
+// Only links against the journal format code, so it can be run anywhere the journal files end up.
+
+#include "EventJournal/EventJournalFormat.h"
+
+#include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	void PrintUsage(std::ostream& str)
+	{
+		str << "Usage: tf2bd_logq [options] <journal file or directory>...\n"
+			"\n"
+			"Options:\n"
+			"  --steamid <id>        Only events about this player. SteamID64 or [U:1:1234] format.\n"
+			"  --from <time>         Only events at or after this time.\n"
+			"  --to <time>           Only events at or before this time.\n"
+			"                        Times are unix timestamps (seconds), or local YYYY-MM-DD[THH:MM:SS].\n"
+			"  --type <types>        Comma separated list of event types:\n"
+			"                        ";
+
+		for (uint8_t i = 0; i < uint8_t(JournalEventType::COUNT); i++)
+			str << (i ? ", " : "") << ToString(JournalEventType(i));
+
+		str << "\n"
+			"  --stats               Print how many segments were read/skipped to stderr.\n";
+	}
+
+	template<typename T>
+	bool ParseInt(const std::string_view& str, T& value)
+	{
+		const auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+		return result.ec == std::errc{} && result.ptr == str.data() + str.size();
+	}
+
+	std::optional<uint64_t> ParseSteamID64(const std::string_view& str)
+	{
+		if (uint64_t id64; ParseInt(str, id64))
+			return id64;
+
+		// [U:1:1234], individual accounts in the public universe only
+		constexpr std::string_view PREFIX = "[U:1:";
+		if (str.starts_with(PREFIX) && str.ends_with(']'))
+		{
+			if (uint32_t accountID; ParseInt(str.substr(PREFIX.size(), str.size() - PREFIX.size() - 1), accountID))
+				return 76561197960265728ull + accountID;
+		}
+
+		return std::nullopt;
+	}
+
+	std::optional<int64_t> ParseTimestamp(const std::string_view& str)
+	{
+		if (int64_t seconds; ParseInt(str, seconds))
+			return seconds * 1000;
+
+		std::tm tm{};
+		tm.tm_isdst = -1;
+		std::istringstream stream{ std::string(str) };
+		stream >> std::get_time(&tm, "%Y-%m-%d");
+		if (stream.fail())
+			return std::nullopt;
+
+		if (!stream.eof())
+		{
+			stream >> std::get_time(&tm, "T%H:%M:%S");
+			if (stream.fail() || stream.peek() != std::char_traits<char>::eof())
+				return std::nullopt;
+		}
+
+		const auto t = std::mktime(&tm);
+		if (t == -1)
+			return std::nullopt;
+
+		return int64_t(t) * 1000;
+	}
+
+	bool ParseEventTypes(std::string_view str, uint32_t& mask)
+	{
+		mask = 0;
+		while (!str.empty())
+		{
+			const auto comma = str.find(',');
+			const auto type = JournalEventTypeFromString(str.substr(0, comma));
+			if (!type)
+				return false;
+
+			mask |= 1u << uint32_t(*type);
+			str = comma == str.npos ? std::string_view{} : str.substr(comma + 1);
+		}
+
+		return mask != 0;
+	}
+
+	void PrintRecord(const JournalRecord& record)
+	{
+		const std::time_t seconds = std::time_t(record.m_Timestamp / 1000);
+		std::tm tm{};
+#ifdef _WIN32
+		localtime_s(&tm, &seconds);
+#else
+		localtime_r(&seconds, &tm);
+#endif
+
+		std::cout << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << '.'
+			<< std::setw(3) << std::setfill('0') << (record.m_Timestamp % 1000) << std::setfill(' ')
+			<< ' ' << std::left << std::setw(15) << ToString(record.m_Type) << std::right;
+
+		if (record.m_SteamID64 >= 76561197960265728ull)
+			std::cout << " [U:1:" << (record.m_SteamID64 - 76561197960265728ull) << ']';
+
+		std::cout << ' ' << record.m_Text << '\n';
+	}
+
+	std::vector<std::filesystem::path> ExpandInputs(const std::vector<std::filesystem::path>& inputs)
+	{
+		std::vector<std::filesystem::path> retVal;
+		for (const auto& input : inputs)
+		{
+			if (!std::filesystem::is_directory(input))
+			{
+				retVal.push_back(input);
+				continue;
+			}
+
+			// Journal file names are timestamps, so sorting them puts them in chronological order
+			std::vector<std::filesystem::path> files;
+			for (const auto& entry : std::filesystem::directory_iterator(input))
+			{
+				if (entry.is_regular_file() && entry.path().extension() == JOURNAL_FILE_EXTENSION)
+					files.push_back(entry.path());
+			}
+
+			std::sort(files.begin(), files.end());
+			retVal.insert(retVal.end(), files.begin(), files.end());
+		}
+
+		return retVal;
+	}
+}
+
+int main(int argc, char** argv) try
+{
+	JournalQuery query;
+	bool printStats = false;
+	std::vector<std::filesystem::path> inputs;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view arg = argv[i];
+		const auto GetValue = [&]() -> std::string_view
+		{
+			if ((i + 1) >= argc)
+				throw std::invalid_argument(std::string(arg) + " requires a value");
+
+			return argv[++i];
+		};
+
+		if (arg == "--help"sv || arg == "-h"sv)
+		{
+			PrintUsage(std::cout);
+			return 0;
+		}
+		else if (arg == "--steamid"sv)
+		{
+			const auto value = GetValue();
+			if (!(query.m_SteamID64 = ParseSteamID64(value)))
+				throw std::invalid_argument("Invalid steamid " + std::string(value));
+		}
+		else if (arg == "--from"sv || arg == "--to"sv)
+		{
+			const auto value = GetValue();
+			const auto timestamp = ParseTimestamp(value);
+			if (!timestamp)
+				throw std::invalid_argument("Invalid time " + std::string(value));
+
+			(arg == "--from"sv ? query.m_MinTimestamp : query.m_MaxTimestamp) = timestamp;
+		}
+		else if (arg == "--type"sv)
+		{
+			const auto value = GetValue();
+			if (!ParseEventTypes(value, query.m_EventTypeMask))
+				throw std::invalid_argument("Invalid event type list " + std::string(value));
+		}
+		else if (arg == "--stats"sv)
+		{
+			printStats = true;
+		}
+		else if (arg.starts_with("--"))
+		{
+			throw std::invalid_argument("Unknown option " + std::string(arg));
+		}
+		else
+		{
+			inputs.push_back(argv[i]);
+		}
+	}
+
+	if (inputs.empty())
+	{
+		PrintUsage(std::cerr);
+		return 1;
+	}
+
+	JournalFileReader::Stats totalStats;
+	size_t matchCount = 0;
+	for (const auto& path : ExpandInputs(inputs))
+	{
+		try
+		{
+			JournalFileReader reader(path);
+
+			try
+			{
+				// Stream rather than Query(), so everything before a corrupt segment still gets printed
+				JournalSegmentHeader header;
+				while (reader.ReadNextHeader(header))
+				{
+					if (!query.MayMatch(header))
+					{
+						reader.SkipPayload(header);
+						continue;
+					}
+
+					for (const JournalRecord& record : reader.ReadPayload(header))
+					{
+						if (query.Matches(record))
+						{
+							PrintRecord(record);
+							matchCount++;
+						}
+					}
+				}
+			}
+			catch (const JournalFormatError& e)
+			{
+				std::cerr << "Warning: " << e.what() << '\n';
+			}
+
+			totalStats.m_SegmentsRead += reader.GetStats().m_SegmentsRead;
+			totalStats.m_SegmentsSkipped += reader.GetStats().m_SegmentsSkipped;
+		}
+		catch (const JournalFormatError& e)
+		{
+			std::cerr << "Warning: " << e.what() << '\n';
+		}
+	}
+
+	if (printStats)
+	{
+		std::cerr << matchCount << " matching events. Segments decompressed: " << totalStats.m_SegmentsRead
+			<< ", skipped using segment headers: " << totalStats.m_SegmentsSkipped << '\n';
+	}
+
+	return 0;
+}
+catch (const std::exception& e)
+{
+	std::cerr << "Error: " << e.what() << "\n\n";
+	PrintUsage(std::cerr);
+	return 1;
+}
@@ -1,5 +1,7 @@
 #include "Log.h"
+#include "Util/MPSCRingBuffer.h"
 #include "Util/PathUtils.h"
+#include "Util/SecretScrubber.h"
 #include "Filesystem.h"
 
 #include <imgui.h>
@@ -12,13 +14,16 @@
 #include <mh/text/stringops.hpp>
 #include <SDL2/SDL_messagebox.h>
 
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <mutex>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #ifdef _WIN32
@@ -38,47 +43,87 @@ namespace
 	class LogManager final : public ILogManager
 	{
 	public:
+		LogManager();
+		~LogManager();
+
 		void Init() override;
 
 		void Log(std::string msg, const LogMessageColor& color, LogSeverity severity,
 			LogVisibility visibility = LogVisibility::Default, time_point_t timestamp = tfbd_clock_t::now()) override;
-		void LogToStream(std::string msg, std::ostream& output, time_point_t timestamp = tfbd_clock_t::now(), bool skipScrub = false) const;
 
 		const std::filesystem::path& GetFileName() const override { return m_FileName; }
 		mh::generator<const LogMessage&> GetVisibleMsgs() const override;
 		void ClearVisibleMsgs() override;
 
-		std::ostream& GetLogStream();
-
 		void LogConsoleOutput(const std::string_view& consoleOutput) override;
 
 		void CleanupLogFiles() override;
 
 		void AddSecret(std::string value, std::string replace) override;
 
+		void Flush() override;
+		QueueStats GetQueueStats() const override;
+
 	private:
 		bool m_IsInit = false;
 		void EnsureInit(MH_SOURCE_LOCATION_AUTO(location)) const;
 
 		std::filesystem::path m_FileName;
-		std::optional<std::stringstream> m_TempLogs = std::stringstream();   // Logs before we have been initialized
-		std::optional<std::ofstream> m_File;
 		mutable std::recursive_mutex m_LogMutex;
 		std::deque<LogMessage> m_LogMessages;
 		size_t m_VisibleLogMessagesStart = 0;
 
-		struct Secret
-		{
-			std::string m_Value;
-			std::string m_Replacement;
-		};
-		std::vector<Secret> m_Secrets;
+		// Rebuilt by AddSecret, so scrubbing only needs to hold m_LogMutex long enough to grab it
+		std::shared_ptr<const SecretScrubber> m_SecretScrubber = std::make_shared<SecretScrubber>();
 		void ReplaceSecrets(std::string& str) const;
 
 		static constexpr size_t MAX_LOG_MESSAGES = 500;
 
-		mutable std::recursive_mutex m_ConsoleLogMutex;
+		// All file/stdout output happens on m_WriterThread. Callers only pay for scrubbing secrets
+		// and a push onto m_WriteQueue.
+		struct QueuedWrite
+		{
+			enum class Target : uint8_t
+			{
+				Log,
+				ConsoleLog,
+			};
+
+			std::string m_Text;
+			time_point_t m_Timestamp{};
+			Target m_Target = Target::Log;
+		};
+
+		static constexpr size_t WRITE_QUEUE_SIZE = 8192;
+		static constexpr duration_t WRITER_INTERVAL = std::chrono::milliseconds(50);
+		static constexpr duration_t FLUSH_INTERVAL = std::chrono::milliseconds(500);
+		static constexpr size_t FLUSH_BYTES_THRESHOLD = 64 * 1024;
+
+		// Debug messages are dropped if the queue is full, everything else waits for room
+		void QueueWrite(QueuedWrite&& write, LogVisibility visibility);
+		void WriterThreadFunc();
+		void WriteImpl(const QueuedWrite& write); // m_OutputMutex must be held
+		void FlushStreams();                      // m_OutputMutex must be held
+
+		MPSCRingBuffer<QueuedWrite, WRITE_QUEUE_SIZE> m_WriteQueue;
+		std::atomic<uint64_t> m_DroppedCount = 0;
+		std::atomic<uint64_t> m_BackpressuredCount = 0;
+
+		// Guards m_File, m_TempLogs, m_ConsoleLogFile. Never log while holding this.
+		std::mutex m_OutputMutex;
+		std::optional<std::stringstream> m_TempLogs = std::stringstream();   // Logs before we have been initialized
+		std::optional<std::ofstream> m_File;
 		std::ofstream m_ConsoleLogFile;
+		std::ostream& GetLogStream();
+
+		std::mutex m_WriterMutex;
+		std::condition_variable m_WriterCV;
+		std::condition_variable m_FlushedCV;
+		size_t m_FlushTarget = 0;   // Flush() waiting for this many messages to hit the disk
+		size_t m_FlushedCount = 0;  // Messages written and flushed so far
+		bool m_ShutdownRequested = false;
+		std::atomic_bool m_WriterStopped = false;
+		std::thread m_WriterThread; // Must be last
 	};
 
 	static LogManager& GetLogState()
@@ -97,6 +142,174 @@ static constexpr LogMessageColor COLOR_DEFAULT = { 1, 1, 1, 1 };
 static constexpr LogMessageColor COLOR_WARNING = { 1, 0.5, 0, 1 };
 static constexpr LogMessageColor COLOR_ERROR = { 1, 0.25, 0, 1 };
 
+LogManager::LogManager()
+{
+	m_WriterThread = std::thread(&LogManager::WriterThreadFunc, this);
+}
+
+LogManager::~LogManager()
+{
+	{
+		std::lock_guard lock(m_WriterMutex);
+		m_ShutdownRequested = true;
+	}
+	m_WriterCV.notify_one();
+
+	if (m_WriterThread.joinable())
+		m_WriterThread.join();
+}
+
+void LogManager::QueueWrite(QueuedWrite&& write, LogVisibility visibility)
+{
+	if (m_WriteQueue.TryPush(std::move(write)))
+		return;
+
+	if (visibility == LogVisibility::Debug)
+	{
+		++m_DroppedCount;
+		return;
+	}
+
+	++m_BackpressuredCount;
+	m_WriterCV.notify_one();
+
+	while (!m_WriteQueue.TryPush(std::move(write)))
+	{
+		if (m_WriterStopped)
+		{
+			// Too late to hand it off to anyone (static destruction)
+			std::lock_guard lock(m_OutputMutex);
+			WriteImpl(write);
+			FlushStreams();
+			return;
+		}
+
+		std::this_thread::yield();
+	}
+}
+
+void LogManager::WriteImpl(const QueuedWrite& write)
+{
+	if (write.m_Target == QueuedWrite::Target::ConsoleLog)
+	{
+		m_ConsoleLogFile << write.m_Text;
+		return;
+	}
+
+	tm t = ToTM(write.m_Timestamp);
+	const auto WriteToStream = [&](std::ostream& str)
+	{
+		str << '[' << std::put_time(&t, "%T") << "] " << write.m_Text << '\n';
+	};
+
+	std::ostream& output = GetLogStream();
+	WriteToStream(output);
+	if (&output != &std::cout)
+		WriteToStream(std::cout);
+
+#ifdef _WIN32
+	OutputDebugStringA(mh::format("Log: {}\n", write.m_Text).c_str());
+#endif
+}
+
+void LogManager::FlushStreams()
+{
+	GetLogStream().flush();
+	std::cout.flush();
+	m_ConsoleLogFile.flush();
+}
+
+void LogManager::WriterThreadFunc()
+{
+	QueuedWrite write;
+	size_t unflushedBytes = 0;
+	size_t unflushedCount = 0;
+	auto lastFlushTime = tfbd_clock_t::now();
+	uint64_t reportedDroppedCount = 0;
+
+	while (true)
+	{
+		bool shutdown;
+		bool flushRequested;
+		{
+			std::unique_lock lock(m_WriterMutex);
+			m_WriterCV.wait_for(lock, WRITER_INTERVAL, [&] { return m_ShutdownRequested || m_FlushTarget > m_FlushedCount; });
+			shutdown = m_ShutdownRequested;
+			flushRequested = m_FlushTarget > m_FlushedCount;
+		}
+
+		bool flushed = false;
+		{
+			std::lock_guard lock(m_OutputMutex);
+
+			if (const uint64_t dropped = m_DroppedCount; dropped != reportedDroppedCount)
+			{
+				WriteImpl({ mh::format("[LogManager] Log queue was full, dropped {} debug messages", dropped - reportedDroppedCount),
+					tfbd_clock_t::now() });
+				reportedDroppedCount = dropped;
+			}
+
+			while (m_WriteQueue.TryPop(write))
+			{
+				WriteImpl(write);
+				unflushedBytes += write.m_Text.size();
+				unflushedCount++;
+			}
+
+			if (unflushedCount > 0 && (flushRequested || shutdown || unflushedBytes >= FLUSH_BYTES_THRESHOLD ||
+				(tfbd_clock_t::now() - lastFlushTime) >= FLUSH_INTERVAL))
+			{
+				FlushStreams();
+				flushed = true;
+				lastFlushTime = tfbd_clock_t::now();
+			}
+		}
+
+		if (flushed || flushRequested)
+		{
+			{
+				std::lock_guard lock(m_WriterMutex);
+				m_FlushedCount += unflushedCount;
+			}
+			m_FlushedCV.notify_all();
+
+			unflushedBytes = 0;
+			unflushedCount = 0;
+		}
+
+		if (shutdown)
+			break;
+
+		if (flushRequested)
+			std::this_thread::yield(); // A producer was probably still mid-push, don't sleep on it
+	}
+
+	m_WriterStopped = true;
+	m_FlushedCV.notify_all();
+}
+
+void LogManager::Flush()
+{
+	if (std::this_thread::get_id() == m_WriterThread.get_id())
+		return;
+
+	const size_t target = m_WriteQueue.GetPushedCount();
+
+	std::unique_lock lock(m_WriterMutex);
+	m_FlushTarget = std::max(m_FlushTarget, target);
+	m_WriterCV.notify_one();
+	m_FlushedCV.wait(lock, [&] { return m_FlushedCount >= target || m_WriterStopped; });
+}
+
+auto LogManager::GetQueueStats() const -> QueueStats
+{
+	return QueueStats
+	{
+		.m_Dropped = m_DroppedCount,
+		.m_Backpressured = m_BackpressuredCount,
+	};
+}
+
 void LogManager::Init()
 {
 	assert(!m_IsInit);
@@ -129,16 +342,21 @@ void LogManager::Init()
 		// Try open file
 		if (!m_FileName.empty())
 		{
-			m_File = std::ofstream(m_FileName, std::ofstream::ate | std::ofstream::app | std::ofstream::out | std::ofstream::binary);
-			if (!m_File->good())
+			std::ofstream file(m_FileName, std::ofstream::ate | std::ofstream::app | std::ofstream::out | std::ofstream::binary);
+			if (!file.good())
 			{
 				::LogWarning("Failed to open log file {}. Log output will go to stdout only.", m_FileName);
 			}
 			else
 			{
-				// Dump all log messages being held in memory to the file, if it was successfully opened
-				m_File.value() << m_TempLogs.value().str();
-				m_TempLogs.reset();
+				// Dump all log messages being held in memory to the file, if it was successfully opened.
+				// Anything still queued lands in the file after them.
+				{
+					std::lock_guard outputLock(m_OutputMutex);
+					file << m_TempLogs.value().str();
+					m_TempLogs.reset();
+					m_File = std::move(file);
+				}
 
 				::DebugLog("Dumped all pending log messages to {}.", m_FileName);
 			}
@@ -156,9 +374,16 @@ void LogManager::Init()
 			else
 			{
 				auto logPath = logDir / mh::fmtstr<128>("console_{}.log", timestampStr).view();
-				m_ConsoleLogFile = std::ofstream(logPath, std::ofstream::ate | std::ofstream::binary);
-				if (!m_ConsoleLogFile.good())
+				std::ofstream file(logPath, std::ofstream::ate | std::ofstream::binary);
+				if (!file.good())
+				{
 					::LogWarning("Failed to open console log file {}. Console output will not be logged.", logPath);
+				}
+				else
+				{
+					std::lock_guard outputLock(m_OutputMutex);
+					m_ConsoleLogFile = std::move(file);
+				}
 			}
 		}
 
@@ -166,28 +391,6 @@ void LogManager::Init()
 	}
 }
 
-void LogManager::LogToStream(std::string msg, std::ostream& output, time_point_t timestamp, bool skipScrub) const
-{
-	std::lock_guard lock(m_LogMutex);
-
-	if (!skipScrub)
-		ReplaceSecrets(msg);
-
-	tm t = ToTM(timestamp);
-	const auto WriteToStream = [&](std::ostream& str)
-	{
-		str << '[' << std::put_time(&t, "%T") << "] " << msg << std::endl;
-	};
-
-	WriteToStream(output);
-	if (&output != &std::cout)
-		WriteToStream(std::cout);
-
-#ifdef _WIN32
-	OutputDebugStringA(mh::format("Log: {}\n", msg).c_str());
-#endif
-}
-
 void LogManager::AddSecret(std::string value, std::string replace)
 {
 	EnsureInit();
@@ -196,40 +399,40 @@ void LogManager::AddSecret(std::string value, std::string replace)
 		return;
 
 	std::lock_guard lock(m_LogMutex);
-	for (auto& scrubbed : m_Secrets)
+
+	auto secrets = m_SecretScrubber->GetSecrets();
+	if (auto found = std::find_if(secrets.begin(), secrets.end(), [&](const SecretScrubber::Secret& s) { return s.m_Value == value; });
+		found != secrets.end())
 	{
-		if (scrubbed.m_Value == value)
-		{
-			scrubbed.m_Replacement = std::move(replace);
-			return;
-		}
+		found->m_Replacement = std::move(replace);
+	}
+	else
+	{
+		secrets.push_back(SecretScrubber::Secret
+			{
+				.m_Value = std::move(value),
+				.m_Replacement = std::move(replace)
+			});
 	}
 
-	m_Secrets.push_back(Secret
-		{
-			.m_Value = std::move(value),
-			.m_Replacement = std::move(replace)
-		});
+	m_SecretScrubber = std::make_shared<const SecretScrubber>(std::move(secrets));
 }
 
 void LogManager::ReplaceSecrets(std::string& msg) const
 {
-	std::lock_guard lock(m_LogMutex);
-	for (const auto& scrubbed : m_Secrets)
+	std::shared_ptr<const SecretScrubber> scrubber;
 	{
-		size_t index = msg.find(scrubbed.m_Value);
-		while (index != msg.npos)
-		{
-			msg.erase(index, scrubbed.m_Value.size());
-			msg.insert(index, scrubbed.m_Replacement);
-			index = msg.find(scrubbed.m_Value, index + scrubbed.m_Replacement.size());
-		}
+		std::lock_guard lock(m_LogMutex);
+		scrubber = m_SecretScrubber;
 	}
+
+	scrubber->Scrub(msg);
 }
 
 void tf2_bot_detector::LogFatalError(const mh::source_location& location, const std::string_view& msg)
 {
 	LogError(location, msg);
+	ILogManager::GetInstance().Flush(); // Make sure this makes it to disk even if we die in the message box
 
 	SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Fatal error",
 		mh::format(
@@ -306,14 +509,12 @@ void detail::log_h::LogImplBase(const LogMessageColor& color, LogSeverity severi
 void LogManager::Log(std::string msg, const LogMessageColor& color,
 	LogSeverity severity, LogVisibility visibility, time_point_t timestamp)
 {
-	std::lock_guard lock(m_LogMutex);
 	ReplaceSecrets(msg);
 
-	LogToStream(msg, GetLogStream(), timestamp, true);
-
 	if (!(visibility == LogVisibility::Debug && !mh::is_debug))
 	{
-		m_LogMessages.push_back({ timestamp, std::move(msg), { color.r, color.g, color.b, color.a } });
+		std::lock_guard lock(m_LogMutex);
+		m_LogMessages.push_back({ timestamp, msg, { color.r, color.g, color.b, color.a } });
 
 		if (m_IsInit && m_LogMessages.size() > MAX_LOG_MESSAGES)
 		{
@@ -321,6 +522,11 @@ void LogManager::Log(std::string msg, const LogMessageColor& color,
 				std::next(m_LogMessages.begin(), m_LogMessages.size() - MAX_LOG_MESSAGES));
 		}
 	}
+
+	QueueWrite({ std::move(msg), timestamp, QueuedWrite::Target::Log }, visibility);
+
+	if (severity == LogSeverity::Fatal)
+		Flush();
 }
 
 mh::generator<const LogMessage&> LogManager::GetVisibleMsgs() const
@@ -362,24 +568,18 @@ void LogManager::LogConsoleOutput(const std::string_view& consoleOutput)
 {
 	EnsureInit();
 
-	std::lock_guard lock(m_ConsoleLogMutex);
-	m_ConsoleLogFile << consoleOutput << std::flush;
+	QueueWrite({ std::string(consoleOutput), {}, QueuedWrite::Target::ConsoleLog }, LogVisibility::Default);
 }
 
 void LogManager::CleanupLogFiles() try
 {
 	EnsureInit();
 
+	// Only touches files from previous runs, so doesn't need to synchronize with the writer thread
 	constexpr auto MAX_LOG_LIFETIME = 24h * 7;
-	{
-		std::lock_guard lock(m_LogMutex);
-		DeleteOldFiles("logs", MAX_LOG_LIFETIME);
-	}
-
-	{
-		std::lock_guard lock(m_ConsoleLogMutex);
-		DeleteOldFiles("logs/console", MAX_LOG_LIFETIME);
-	}
+	DeleteOldFiles("logs", MAX_LOG_LIFETIME);
+	DeleteOldFiles("logs/console", MAX_LOG_LIFETIME);
+	DeleteOldFiles(IFilesystem::Get().GetLogsDir() / "journal", MAX_LOG_LIFETIME);
 }
 catch (const std::filesystem::filesystem_error& e)
 {
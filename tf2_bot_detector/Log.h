@@ -6,6 +6,7 @@
 #include <mh/text/format.hpp>
 #include <mh/source_location.hpp>
 
+#include <cstdint>
 #include <filesystem>
 #include <string>
 
@@ -94,6 +95,17 @@ namespace tf2_bot_detector
 		virtual void CleanupLogFiles() = 0;
 
 		virtual void AddSecret(std::string value, std::string replace) = 0;
+
+		// Log output is written to disk on a background thread. Blocks until everything logged
+		// before this call has been written and flushed. Called automatically for fatal errors.
+		virtual void Flush() = 0;
+
+		struct QueueStats
+		{
+			uint64_t m_Dropped;       // Debug messages thrown away because the queue was full
+			uint64_t m_Backpressured; // Messages that had to wait for room in the queue
+		};
+		virtual QueueStats GetQueueStats() const = 0;
 	};
 
 #pragma push_macro("NOINLINE")
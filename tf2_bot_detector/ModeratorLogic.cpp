@@ -7,6 +7,7 @@
 #include "ConsoleLog/ConsoleLineListener.h"
 #include "ConsoleLog/IConsoleLine.h"
 #include "ConsoleLog/ConsoleLines.h"
+#include "EventJournal/EventJournal.h"
 #include "GameData/UserMessageType.h"
 #include "IPlayer.h"
 #include "Log.h"
@@ -54,6 +55,7 @@ namespace
 		bool InitiateVotekick(const IPlayer& player, KickReason reason, const PlayerMarks* marks = nullptr) override;
 
 		bool SetPlayerAttribute(const IPlayer& id, PlayerAttribute markType, AttributePersistence persistence, bool set = true) override;
+		uint32_t GetPlayerAttributesGeneration() const override { return m_PlayerAttributesGeneration; }
 
 		std::optional<LobbyMemberTeam> TryGetMyTeam() const;
 		TeamShareResult GetTeamShareResult(const SteamID& id) const override;
@@ -103,6 +105,7 @@ namespace
 
 		void OnPlayerStatusUpdate(IWorldState& world, const IPlayer& player) override;
 		void OnChatMsg(IWorldState& world, IPlayer& player, const std::string_view& msg) override;
+		void OnPlayerVoiceReceived(IWorldState& world, IPlayer& player, time_point_t timestamp) override;
 
 		void OnRuleMatch(const ModerationRule& rule, const IPlayer& player);
 
@@ -135,6 +138,7 @@ namespace
 
 		PlayerListJSON m_PlayerList;
 		ModerationRules m_Rules;
+		uint32_t m_PlayerAttributesGeneration = 0;
 	};
 
 	template<typename CharT, typename Traits>
@@ -176,6 +180,8 @@ void ModeratorLogic::Update()
 
 void ModeratorLogic::OnRuleMatch(const ModerationRule& rule, const IPlayer& player)
 {
+	IEventJournal::GetInstance().Record(JournalEventType::RuleMatch, player.GetSteamID(), rule.m_Description);
+
 	for (PlayerAttribute attribute : rule.m_Actions.m_Mark)
 	{
 		if (SetPlayerAttribute(player, attribute, AttributePersistence::Saved))
@@ -210,6 +216,16 @@ void ModeratorLogic::OnPlayerStatusUpdate(IWorldState& world, const IPlayer& pla
 	}
 }
 
+void ModeratorLogic::OnPlayerVoiceReceived(IWorldState& world, IPlayer& player, time_point_t timestamp)
+{
+	auto& voice = player.GetOrCreateData<PlayerExtraData>().m_Voice;
+	if (voice.m_LastTransmission != timestamp)
+	{
+		voice.m_TotalTransmissions += 1s; // This is fine because we know the resolution of our timestamps is 1 second
+		voice.m_LastTransmission = timestamp;
+	}
+}
+
 static bool IsCheaterConnectedWarning(const std::string_view& msg)
 {
 	static const std::regex s_IngameWarning(
@@ -652,6 +668,13 @@ bool ModeratorLogic::SetPlayerAttribute(const IPlayer& player, PlayerAttribute a
 			return ModifyPlayerAction::Modified;
 		});
 
+	if (attributeChanged)
+	{
+		m_PlayerAttributesGeneration++;
+		IEventJournal::GetInstance().Record(set ? JournalEventType::PlayerMarked : JournalEventType::PlayerUnmarked,
+			player.GetSteamID(), mh::format("{:v} ({:v})", mh::enum_fmt(attribute), mh::enum_fmt(persistence)));
+	}
+
 	return attributeChanged;
 }
 
@@ -733,6 +756,7 @@ void ModeratorLogic::ReloadConfigFiles()
 {
 	m_PlayerList.LoadFiles();
 	m_Rules.LoadFiles();
+	m_PlayerAttributesGeneration++;
 }
 
 ModeratorLogic::ModeratorLogic(IWorldState& world, const Settings& settings, IRCONActionManager& actionManager) :
@@ -771,6 +795,7 @@ bool ModeratorLogic::InitiateVotekick(const IPlayer& player, KickReason reason,
 		if (marks)
 			mh::format_to_container(logMsg, ", in playerlist(s){}", *marks);
 
+		IEventJournal::GetInstance().Record(JournalEventType::Votekick, player.GetSteamID(), logMsg);
 		Log(std::move(logMsg));
 
 		m_LastVoteCallTime = tfbd_clock_t::now();
@@ -54,6 +54,9 @@ namespace tf2_bot_detector
 			AttributePersistence persistence = AttributePersistence::Any) const = 0;
 		virtual bool SetPlayerAttribute(const IPlayer& player, PlayerAttribute markType, AttributePersistence persistence, bool set = true) = 0;
 
+		// Changes whenever a player's marks may have changed, for caching anything derived from GetPlayerAttributes().
+		virtual uint32_t GetPlayerAttributesGeneration() const = 0;
+
 		virtual TeamShareResult GetTeamShareResult(const SteamID& id) const = 0;
 
 		virtual const IPlayer* GetBotLeader() const = 0;
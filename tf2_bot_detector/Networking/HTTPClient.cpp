@@ -6,14 +6,11 @@
 #include <mh/error/error_code_exception.hpp>
 #include <mh/text/case_insensitive_string.hpp>
 
+#include "EventJournal/EventJournal.h"
 #include "GlobalDispatcher.h"
 #include "HTTPClient.h"
 #include "HTTPHelpers.h"
-
-#pragma warning(push, 1)
-#include <cpprest/http_client.h>
-#include <pplawait.h>
-#pragma warning(pop)
+#include "HTTPTransport.h"
 
 using namespace std::chrono_literals;
 using namespace std::string_literals;
@@ -24,15 +21,15 @@ namespace
 	class HTTPClientImpl final : public IHTTPClient
 	{
 	public:
+		HTTPClientImpl(std::shared_ptr<IHTTPTransport> transport) : m_Transport(std::move(transport)) {}
+
 		std::string GetString(const URL& url) const override;
 		mh::task<std::string> GetStringAsync(URL url) const override;
 
 		RequestCounts GetRequestCounts() const override;
 
 	private:
-		mutable std::mutex m_InnerClientMutex;
-		mutable std::map<std::string, std::shared_ptr<web::http::client::http_client>> m_InnerClients;
-		std::shared_ptr<web::http::client::http_client> GetInnerClient(const URL& url) const;
+		const std::shared_ptr<IHTTPTransport> m_Transport;
 
 		mutable std::atomic_uint32_t m_TotalRequestCount = 0;
 		mutable std::atomic_uint32_t m_FailedRequestCount = 0;
@@ -52,22 +49,6 @@ std::string HTTPClientImpl::GetString(const URL& url) const
 	return std::move(task.get());
 }
 
-std::shared_ptr<web::http::client::http_client> HTTPClientImpl::GetInnerClient(const URL& url) const
-{
-	std::lock_guard lock(m_InnerClientMutex);
-
-	const std::string schemeHostPort = url.GetSchemeHostPort();
-	if (auto found = m_InnerClients.find(schemeHostPort); found != m_InnerClients.end())
-	{
-		return found->second;
-	}
-	else
-	{
-		auto newClient = std::make_shared<web::http::client::http_client>(utility::conversions::to_string_t(schemeHostPort));
-		return m_InnerClients.emplace(schemeHostPort, newClient).first->second;
-	}
-}
-
 static duration_t GetMinRequestInterval(const URL& url)
 {
 	if (url.m_Host.ends_with("akamaihd.net") ||
@@ -159,21 +140,25 @@ mh::task<std::string> HTTPClientImpl::GetStringAsync(URL url) const try
 			{
 				auto requestIndex = ++m_TotalRequestCount;
 
-				auto client = GetInnerClient(url);
-
 				const auto startTime = tfbd_clock_t::now();
 
-				auto response = co_await client->request(web::http::methods::GET, utility::conversions::to_string_t(url.m_Path));
-
-				if (response.status_code() >= 400 && response.status_code() < 600)
-					throw http_error((HTTPResponseCode)response.status_code(), mh::format("Failed to HTTP GET {}", url));
+				HTTPResponse response = co_await m_Transport->GetAsync(url);
 
-				std::string stringResponse = co_await response.extract_utf8string(true);
+				if (int(response.m_StatusCode) >= 400 && int(response.m_StatusCode) < 600)
+					throw http_error(response.m_StatusCode, mh::format("Failed to HTTP GET {}", url));
 
 				const auto duration = tfbd_clock_t::now() - startTime;
 				DebugLog("[{}ms] HTTP GET #{}: {}", std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(), requestIndex, url);
 
-				co_return std::move(stringResponse);
+				if (auto& journal = IEventJournal::GetInstance(); journal.IsEnabled())
+				{
+					// Query strings are left out, they contain api keys
+					const std::string_view path = std::string_view(url.m_Path).substr(0, url.m_Path.find('?'));
+					journal.Record(JournalEventType::APIFetch, {}, mh::format("{} {}ms {}{}", int(response.m_StatusCode),
+						std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(), url.m_Host, path));
+				}
+
+				co_return std::move(response.m_Body);
 			}
 			catch (...)
 			{
@@ -208,7 +193,7 @@ mh::task<std::string> HTTPClientImpl::GetStringAsync(URL url) const try
 				throw; // give up
 			}
 		}
-		catch (const web::http::http_exception&)
+		catch (const http_transport_error&)
 		{
 			if (retryCount > 3)
 			{
@@ -249,7 +234,12 @@ auto HTTPClientImpl::GetRequestCounts() const -> RequestCounts
 	};
 }
 
-std::shared_ptr<IHTTPClient> tf2_bot_detector::IHTTPClient::Create()
+std::shared_ptr<IHTTPClient> tf2_bot_detector::IHTTPClient::Create(std::shared_ptr<IHTTPTransport> transport)
 {
-	return std::make_shared<HTTPClientImpl>();
+	if (!transport)
+		transport = IHTTPTransport::GetDefaultOverride();
+	if (!transport)
+		transport = IHTTPTransport::Create();
+
+	return std::make_shared<HTTPClientImpl>(std::move(transport));
 }
@@ -7,6 +7,7 @@
 
 namespace tf2_bot_detector
 {
+	class IHTTPTransport;
 	class URL;
 
 	// Only intended to be stored if you are doing something async
@@ -15,7 +16,8 @@ namespace tf2_bot_detector
 	public:
 		virtual ~IHTTPClient() = default;
 
-		static std::shared_ptr<IHTTPClient> Create();
+		// If transport is nullptr, IHTTPTransport::GetDefaultOverride() is used, falling back to IHTTPTransport::Create().
+		static std::shared_ptr<IHTTPClient> Create(std::shared_ptr<IHTTPTransport> transport = nullptr);
 
 		virtual std::string GetString(const URL& url) const = 0;
 		virtual mh::task<std::string> GetStringAsync(URL url) const = 0;
@@ -0,0 +1,215 @@
+#include "HTTPTransport.h"
+#include "Log.h"
+
+#include <mh/text/fmtstr.hpp>
+#include <mh/text/format.hpp>
+#include <nlohmann/json.hpp>
+
+#pragma warning(push, 1)
+#include <cpprest/http_client.h>
+#include <pplawait.h>
+#pragma warning(pop)
+
+#include <fstream>
+#include <map>
+#include <mutex>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	class CppRestTransport final : public IHTTPTransport
+	{
+	public:
+		CppRestTransport() = default;
+		CppRestTransport(std::string baseURI) : m_BaseURIOverride(std::move(baseURI)) {}
+
+		mh::task<HTTPResponse> GetAsync(URL url) override;
+
+	private:
+		std::string m_BaseURIOverride;
+
+		std::mutex m_InnerClientMutex;
+		std::map<std::string, std::shared_ptr<web::http::client::http_client>> m_InnerClients;
+		std::shared_ptr<web::http::client::http_client> GetInnerClient(const URL& url);
+	};
+
+	std::shared_ptr<web::http::client::http_client> CppRestTransport::GetInnerClient(const URL& url)
+	{
+		std::lock_guard lock(m_InnerClientMutex);
+
+		const std::string schemeHostPort = m_BaseURIOverride.empty() ? url.GetSchemeHostPort() : m_BaseURIOverride;
+		if (auto found = m_InnerClients.find(schemeHostPort); found != m_InnerClients.end())
+		{
+			return found->second;
+		}
+		else
+		{
+			auto newClient = std::make_shared<web::http::client::http_client>(utility::conversions::to_string_t(schemeHostPort));
+			return m_InnerClients.emplace(schemeHostPort, newClient).first->second;
+		}
+	}
+
+	mh::task<HTTPResponse> CppRestTransport::GetAsync(URL url)
+	{
+		auto client = GetInnerClient(url);
+
+		HTTPResponse retVal;
+		try
+		{
+			auto response = co_await client->request(web::http::methods::GET, utility::conversions::to_string_t(url.m_Path));
+			retVal.m_StatusCode = HTTPResponseCode(response.status_code());
+			retVal.m_Body = co_await response.extract_utf8string(true);
+		}
+		catch (const web::http::http_exception& e)
+		{
+			throw http_transport_error(mh::format("{}: {}", url, e.what()));
+		}
+
+		co_return retVal;
+	}
+
+	// Strips the steam api key out of recorded URLs so recordings can be shared
+	static std::string GetRecordingKey(const URL& url)
+	{
+		std::string retVal = url.m_Host + url.m_Path;
+
+		if (auto keyStart = retVal.find("key="); keyStart != retVal.npos)
+		{
+			auto keyEnd = retVal.find('&', keyStart);
+			retVal.erase(keyStart, keyEnd == retVal.npos ? retVal.npos : (keyEnd - keyStart + 1));
+		}
+
+		return retVal;
+	}
+
+	// FNV-1a, stable across runs/platforms unlike std::hash
+	static uint64_t HashRecordingKey(const std::string_view& key)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : key)
+		{
+			hash ^= uint8_t(c);
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	static std::filesystem::path GetRecordingPath(const std::filesystem::path& directory, const std::string& key)
+	{
+		return directory / mh::fmtstr<64>("{:016x}.json", HashRecordingKey(key)).view();
+	}
+
+	class RecordingTransport final : public IHTTPTransport
+	{
+	public:
+		RecordingTransport(std::shared_ptr<IHTTPTransport> inner, std::filesystem::path directory) :
+			m_Inner(std::move(inner)), m_Directory(std::move(directory))
+		{
+			std::filesystem::create_directories(m_Directory);
+		}
+
+		mh::task<HTTPResponse> GetAsync(URL url) override
+		{
+			HTTPResponse response = co_await m_Inner->GetAsync(url);
+
+			const std::string key = GetRecordingKey(url);
+			const nlohmann::json json =
+			{
+				{ "url", key },
+				{ "status", int(response.m_StatusCode) },
+				{ "body", response.m_Body },
+			};
+
+			{
+				std::lock_guard lock(m_WriteMutex);
+				std::ofstream file(GetRecordingPath(m_Directory, key), std::ios::trunc | std::ios::binary);
+				file << json;
+			}
+
+			co_return response;
+		}
+
+	private:
+		std::shared_ptr<IHTTPTransport> m_Inner;
+		std::filesystem::path m_Directory;
+		std::mutex m_WriteMutex;
+	};
+
+	class ReplayTransport final : public IHTTPTransport
+	{
+	public:
+		ReplayTransport(std::filesystem::path directory) : m_Directory(std::move(directory)) {}
+
+		mh::task<HTTPResponse> GetAsync(URL url) override
+		{
+			const std::string key = GetRecordingKey(url);
+			const auto path = GetRecordingPath(m_Directory, key);
+
+			std::ifstream file(path, std::ios::binary);
+			if (!file.good())
+			{
+				DebugLogWarning("No recorded response for {}", key);
+				co_return HTTPResponse{ HTTPResponseCode::NotFound };
+			}
+
+			nlohmann::json json;
+			try
+			{
+				file >> json;
+			}
+			catch (...)
+			{
+				LogException("Failed to parse recorded response {}", path);
+				co_return HTTPResponse{ HTTPResponseCode::InternalServerError };
+			}
+
+			HTTPResponse response;
+			response.m_StatusCode = HTTPResponseCode(json.at("status").get<int>());
+			json.at("body").get_to(response.m_Body);
+			co_return response;
+		}
+
+	private:
+		std::filesystem::path m_Directory;
+	};
+
+	static std::mutex s_DefaultOverrideMutex;
+	static std::shared_ptr<IHTTPTransport> s_DefaultOverride;
+}
+
+std::shared_ptr<IHTTPTransport> IHTTPTransport::Create()
+{
+	return std::make_shared<CppRestTransport>();
+}
+
+std::shared_ptr<IHTTPTransport> IHTTPTransport::CreateRedirected(std::string baseURI)
+{
+	return std::make_shared<CppRestTransport>(std::move(baseURI));
+}
+
+std::shared_ptr<IHTTPTransport> IHTTPTransport::CreateRecording(std::shared_ptr<IHTTPTransport> inner,
+	std::filesystem::path directory)
+{
+	return std::make_shared<RecordingTransport>(std::move(inner), std::move(directory));
+}
+
+std::shared_ptr<IHTTPTransport> IHTTPTransport::CreateReplay(std::filesystem::path directory)
+{
+	return std::make_shared<ReplayTransport>(std::move(directory));
+}
+
+void IHTTPTransport::SetDefaultOverride(std::shared_ptr<IHTTPTransport> transport)
+{
+	std::lock_guard lock(s_DefaultOverrideMutex);
+	s_DefaultOverride = std::move(transport);
+}
+
+std::shared_ptr<IHTTPTransport> IHTTPTransport::GetDefaultOverride()
+{
+	std::lock_guard lock(s_DefaultOverrideMutex);
+	return s_DefaultOverride;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "HTTPHelpers.h"
+
+#include <mh/coroutine/task.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace tf2_bot_detector
+{
+	struct HTTPResponse
+	{
+		HTTPResponseCode m_StatusCode = HTTPResponseCode::OK;
+		std::string m_Body;
+	};
+
+	// Thrown by transports when no HTTP response could be obtained at all (socket errors, timeouts, etc)
+	class http_transport_error : public std::runtime_error
+	{
+	public:
+		using std::runtime_error::runtime_error;
+	};
+
+	// The layer underneath IHTTPClient that actually puts bytes on the wire. IHTTPClient owns
+	// throttling and retry policy, transports just perform a single request.
+	class IHTTPTransport
+	{
+	public:
+		virtual ~IHTTPTransport() = default;
+
+		// cpprestsdk against the real endpoints
+		static std::shared_ptr<IHTTPTransport> Create();
+
+		// cpprestsdk, but every request is sent to baseURI (for example, a MockHTTPServer on loopback)
+		// instead of the host in the URL. The original path and query are preserved.
+		static std::shared_ptr<IHTTPTransport> CreateRedirected(std::string baseURI);
+
+		// Forwards to inner and writes every response to directory
+		static std::shared_ptr<IHTTPTransport> CreateRecording(std::shared_ptr<IHTTPTransport> inner,
+			std::filesystem::path directory);
+
+		// Serves responses previously written by a recording transport. Requests that were
+		// never recorded result in HTTP 404.
+		static std::shared_ptr<IHTTPTransport> CreateReplay(std::filesystem::path directory);
+
+		// Used by IHTTPClient::Create() when no explicit transport is given. Set from the command line
+		// with --http-record/--http-replay.
+		static void SetDefaultOverride(std::shared_ptr<IHTTPTransport> transport);
+		static std::shared_ptr<IHTTPTransport> GetDefaultOverride();
+
+		// Does not throw for HTTP error status codes, that is left up to the caller.
+		virtual mh::task<HTTPResponse> GetAsync(URL url) = 0;
+	};
+}
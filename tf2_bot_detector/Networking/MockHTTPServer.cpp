@@ -0,0 +1,178 @@
+#include "MockHTTPServer.h"
+#include "Log.h"
+
+#include <mh/text/format.hpp>
+
+#pragma warning(push, 1)
+#include <cpprest/http_listener.h>
+#pragma warning(pop)
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+
+using namespace std::string_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	class MockHTTPServer final : public IMockHTTPServer
+	{
+	public:
+		MockHTTPServer(uint16_t port);
+		~MockHTTPServer();
+
+		void SetRoute(std::string pathPrefix, RouteHandler handler) override;
+		void SetFaultSettings(const FaultSettings& settings) override;
+		RequestCounts GetRequestCounts() const override;
+		std::string GetBaseURI() const override { return m_BaseURI; }
+
+	private:
+		void HandleGet(web::http::http_request request);
+
+		// Returns the status code to inject, if any
+		std::optional<HTTPResponseCode> RollFault();
+
+		std::string m_BaseURI;
+		web::http::experimental::listener::http_listener m_Listener;
+
+		mutable std::mutex m_Mutex;
+		std::map<std::string, RouteHandler, std::greater<>> m_Routes;  // Reverse order, so longer prefixes are found first
+		FaultSettings m_FaultSettings;
+		std::mt19937 m_Random;
+
+		std::atomic_uint32_t m_TotalCount = 0;
+		std::atomic_uint32_t m_TooManyRequestsCount = 0;
+		std::atomic_uint32_t m_ServerErrorCount = 0;
+		std::atomic_uint32_t m_UnroutedCount = 0;
+	};
+
+	MockHTTPServer::MockHTTPServer(uint16_t port) :
+		m_BaseURI(mh::format("http://127.0.0.1:{}", port)),
+		m_Listener(utility::conversions::to_string_t(m_BaseURI)),
+		m_Random(m_FaultSettings.m_RandomSeed)
+	{
+		m_Listener.support(web::http::methods::GET, [this](web::http::http_request request) { HandleGet(std::move(request)); });
+		m_Listener.open().wait();
+		DebugLog("Mock HTTP server listening on {}", m_BaseURI);
+	}
+
+	MockHTTPServer::~MockHTTPServer()
+	{
+		try
+		{
+			m_Listener.close().wait();
+		}
+		catch (...)
+		{
+			LogException("Failed to shut down mock HTTP server");
+		}
+	}
+
+	void MockHTTPServer::SetRoute(std::string pathPrefix, RouteHandler handler)
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Routes.insert_or_assign(std::move(pathPrefix), std::move(handler));
+	}
+
+	void MockHTTPServer::SetFaultSettings(const FaultSettings& settings)
+	{
+		std::lock_guard lock(m_Mutex);
+		m_FaultSettings = settings;
+		m_Random.seed(settings.m_RandomSeed);
+	}
+
+	auto MockHTTPServer::GetRequestCounts() const -> RequestCounts
+	{
+		return RequestCounts
+		{
+			.m_Total = m_TotalCount,
+			.m_TooManyRequests = m_TooManyRequestsCount,
+			.m_ServerErrors = m_ServerErrorCount,
+			.m_Unrouted = m_UnroutedCount,
+		};
+	}
+
+	std::optional<HTTPResponseCode> MockHTTPServer::RollFault()
+	{
+		std::lock_guard lock(m_Mutex);
+		std::uniform_real_distribution<float> dist(0, 1);
+
+		if (dist(m_Random) < m_FaultSettings.m_TooManyRequestsRate)
+		{
+			++m_TooManyRequestsCount;
+			return HTTPResponseCode::TooManyRequests;
+		}
+
+		if (dist(m_Random) < m_FaultSettings.m_ServerErrorRate)
+		{
+			++m_ServerErrorCount;
+			return (m_Random() & 1) ? HTTPResponseCode::InternalServerError : HTTPResponseCode::ServiceUnavailable;
+		}
+
+		return std::nullopt;
+	}
+
+	void MockHTTPServer::HandleGet(web::http::http_request request)
+	{
+		++m_TotalCount;
+
+		const std::string pathAndQuery = utility::conversions::to_utf8string(request.relative_uri().to_string());
+
+		duration_t latency;
+		RouteHandler handler;
+		{
+			std::lock_guard lock(m_Mutex);
+			latency = m_FaultSettings.m_Latency;
+
+			for (const auto& [prefix, routeHandler] : m_Routes)
+			{
+				if (pathAndQuery.starts_with(prefix))
+				{
+					handler = routeHandler;
+					break;
+				}
+			}
+		}
+
+		// Don't hold up the listener thread while we "wait on the network"
+		pplx::create_task([this, request, pathAndQuery, latency, handler = std::move(handler)]() mutable
+			{
+				if (latency > duration_t{})
+					std::this_thread::sleep_for(latency);
+
+				HTTPResponse response;
+				if (auto fault = RollFault())
+				{
+					response.m_StatusCode = *fault;
+				}
+				else if (handler)
+				{
+					try
+					{
+						response = handler(pathAndQuery);
+					}
+					catch (...)
+					{
+						LogException("Mock HTTP route handler threw for {}", pathAndQuery);
+						response = HTTPResponse{ HTTPResponseCode::InternalServerError };
+					}
+				}
+				else
+				{
+					++m_UnroutedCount;
+					response.m_StatusCode = HTTPResponseCode::NotFound;
+				}
+
+				return request.reply(web::http::status_code(response.m_StatusCode), response.m_Body, "application/json");
+			});
+	}
+}
+
+std::unique_ptr<IMockHTTPServer> IMockHTTPServer::Create(uint16_t port)
+{
+	return std::make_unique<MockHTTPServer>(port);
+}
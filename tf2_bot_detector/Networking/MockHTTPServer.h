@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Clock.h"
+#include "HTTPTransport.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace tf2_bot_detector
+{
+	// A loopback HTTP server for exercising the networking code without touching the real endpoints.
+	// Point an IHTTPClient at it with IHTTPTransport::CreateRedirected(server->GetBaseURI()).
+	class IMockHTTPServer
+	{
+	public:
+		virtual ~IMockHTTPServer() = default;
+
+		static std::unique_ptr<IMockHTTPServer> Create(uint16_t port);
+
+		// pathAndQuery is everything after the host, ie "/ISteamUser/GetPlayerBans/v0001/?key=...&steamids=..."
+		using RouteHandler = std::function<HTTPResponse(const std::string_view& pathAndQuery)>;
+
+		// Routes are matched by the longest registered prefix of the request path
+		virtual void SetRoute(std::string pathPrefix, RouteHandler handler) = 0;
+
+		struct FaultSettings
+		{
+			duration_t m_Latency{};
+			float m_TooManyRequestsRate = 0;  // [0, 1] chance to respond with HTTP 429
+			float m_ServerErrorRate = 0;      // [0, 1] chance to respond with HTTP 500 or 503
+			uint32_t m_RandomSeed = 1;
+		};
+
+		virtual void SetFaultSettings(const FaultSettings& settings) = 0;
+
+		struct RequestCounts
+		{
+			uint32_t m_Total;
+			uint32_t m_TooManyRequests;  // Injected 429s
+			uint32_t m_ServerErrors;     // Injected 5xx
+			uint32_t m_Unrouted;         // Requests with no matching route (404)
+		};
+
+		virtual RequestCounts GetRequestCounts() const = 0;
+		virtual std::string GetBaseURI() const = 0;
+	};
+}
@@ -9,6 +9,7 @@
 
 #include <mh/concurrency/thread_pool.hpp>
 #include <mh/coroutine/future.hpp>
+#include <mh/text/charconv_helper.hpp>
 #include <mh/text/fmtstr.hpp>
 #include <mh/text/format.hpp>
 #include <mh/text/string_insertion.hpp>
@@ -16,6 +17,7 @@
 #include <nlohmann/json.hpp>
 #include <stb_image.h>
 
+#include <array>
 #include <fstream>
 #include <regex>
 
@@ -48,13 +50,24 @@ namespace
 		{
 			const std::filesystem::path cachedPath = m_CacheDir / mh::fmtstr<128>("{}.jpg", hash).view();
 
-			// See if we're already stored in the cache
+			// Decoding a full size avatar is slow enough to cause a visible hitch if a lot of them
+			// happen in a row on the (usually main) calling thread
+			co_await m_DecodePool.co_add_task();
+
+			// See if we're already stored in the cache. m_CacheMutex only covers looking in the cache
+			// and writing to it, so the decode pool can actually decode more than one avatar at a time.
+			bool isCached = false;
 			{
 				std::lock_guard lock(m_CacheMutex);
+				std::error_code ec;
+				isCached = std::filesystem::exists(cachedPath, ec);
+			}
+
+			if (isCached)
+			{
 				try
 				{
-					if (std::filesystem::exists(cachedPath))
-						co_return Bitmap(cachedPath);
+					co_return Bitmap(cachedPath);
 				}
 				catch (const std::exception& e)
 				{
@@ -69,11 +82,21 @@ namespace
 				// We're not stored in the cache, download now
 				std::string data = co_await clientPtr->GetStringAsync(url);
 
-				std::lock_guard lock(m_CacheMutex);
+				co_await m_DecodePool.co_add_task();
+
 				{
-					std::ofstream file(cachedPath, std::ios::trunc | std::ios::binary);
-					file << data;
+					std::lock_guard lock(m_CacheMutex);
+
+					// Someone else may have cached this avatar while we were downloading it, and could be
+					// decoding it right now. Only overwrite it if it's the one that just failed to decode.
+					std::error_code ec;
+					if (isCached || !std::filesystem::exists(cachedPath, ec))
+					{
+						std::ofstream file(cachedPath, std::ios::trunc | std::ios::binary);
+						file << data;
+					}
 				}
+
 				co_return Bitmap(cachedPath);
 			}
 
@@ -84,6 +107,7 @@ namespace
 	private:
 		std::filesystem::path m_CacheDir;
 		mutable std::mutex m_CacheMutex;
+		mutable mh::thread_pool m_DecodePool{ 2 };
 
 	};
 
@@ -218,6 +242,361 @@ static std::string GenerateSteamIDsQueryParam(const std::vector<SteamID>& steamI
 	return steamIDsString;
 }
 
+namespace
+{
+	// Base for schema-directed SAX decoders of the "array of players" steam api responses. Walks
+	// m_ArrayPath to find the array, then reports the scalar members of each entry to the derived class.
+	// Avoids building a json DOM and lets string values be moved straight into the output.
+	class PlayerArraySAXBase : public nlohmann::json_sax<nlohmann::json>
+	{
+	public:
+		PlayerArraySAXBase(std::initializer_list<std::string_view> arrayPath) :
+			m_ArrayPathLength(arrayPath.size())
+		{
+			assert(arrayPath.size() <= m_ArrayPath.size());
+			std::copy(arrayPath.begin(), arrayPath.end(), m_ArrayPath.begin());
+		}
+
+		bool HasParseError() const { return m_HasParseError; }
+		bool FoundArray() const { return m_FoundArray; }
+
+		bool null() override { return true; }
+		bool boolean(bool val) override { return !IsEntryMember() || OnBool(CurrentKey(), val); }
+		bool number_integer(number_integer_t val) override { return !IsEntryMember() || OnInteger(CurrentKey(), val); }
+		bool number_unsigned(number_unsigned_t val) override
+		{
+			return !IsEntryMember() || OnInteger(CurrentKey(), static_cast<int64_t>(val));
+		}
+		bool number_float(number_float_t, const string_t&) override { return true; }
+		bool string(string_t& val) override { return !IsEntryMember() || OnString(CurrentKey(), val); }
+		bool binary(binary_t&) override { return true; }
+
+		bool start_object(std::size_t) override
+		{
+			m_Depth++;
+			if (m_InArray && m_Depth == ArrayDepth() + 1)
+				OnEntryStart();
+
+			return true;
+		}
+		bool end_object() override
+		{
+			bool retVal = true;
+			if (m_InArray && m_Depth == ArrayDepth() + 1)
+				retVal = OnEntryEnd();
+
+			m_Depth--;
+			return retVal;
+		}
+
+		bool start_array(std::size_t) override
+		{
+			m_Depth++;
+			if (m_Depth == ArrayDepth() && IsOnArrayPath())
+			{
+				m_InArray = true;
+				m_FoundArray = true;
+			}
+
+			return true;
+		}
+		bool end_array() override
+		{
+			if (m_InArray && m_Depth == ArrayDepth())
+				m_InArray = false;
+
+			m_Depth--;
+			return true;
+		}
+
+		bool key(string_t& val) override
+		{
+			if (m_Depth < m_Keys.size())
+				m_Keys[m_Depth].assign(val); // Reuses capacity, these are all short enough for SSO anyway
+
+			return true;
+		}
+
+		bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override
+		{
+			m_HasParseError = true;
+			return false;
+		}
+
+	protected:
+		virtual void OnEntryStart() = 0;
+		virtual bool OnEntryEnd() = 0;
+		virtual bool OnString(const std::string_view& key, std::string& value) = 0;
+		virtual bool OnInteger(const std::string_view& key, int64_t value) = 0;
+		virtual bool OnBool(const std::string_view& key, bool value) = 0;
+
+	private:
+		// The array itself is one level deeper than the number of keys leading to it (the root object)
+		size_t ArrayDepth() const { return m_ArrayPathLength + 1; }
+		bool IsEntryMember() const { return m_InArray && m_Depth == ArrayDepth() + 1; }
+		std::string_view CurrentKey() const { return m_Keys[ArrayDepth() + 1]; }
+
+		bool IsOnArrayPath() const
+		{
+			for (size_t i = 0; i < m_ArrayPathLength; i++)
+			{
+				if (m_Keys[i + 1] != m_ArrayPath[i])
+					return false;
+			}
+
+			return true;
+		}
+
+		std::array<std::string_view, 2> m_ArrayPath;
+		size_t m_ArrayPathLength = 0;
+
+		std::array<std::string, 5> m_Keys;
+		size_t m_Depth = 0;
+		bool m_InArray = false;
+		bool m_FoundArray = false;
+		bool m_HasParseError = false;
+	};
+
+	static bool ParseSteamID64(const std::string_view& str, SteamID& id)
+	{
+		uint64_t id64;
+		if (!mh::from_chars(str, id64))
+			return false;
+
+		id = SteamID(id64);
+		return true;
+	}
+
+	class PlayerSummariesSAX final : public PlayerArraySAXBase
+	{
+	public:
+		PlayerSummariesSAX(std::vector<PlayerSummary>& output) :
+			PlayerArraySAXBase({ "response", "players" }), m_Output(output)
+		{
+		}
+
+	protected:
+		enum RequiredFields
+		{
+			Field_SteamID = (1 << 0),
+			Field_PersonaName = (1 << 1),
+			Field_PersonaState = (1 << 2),
+			Field_Visibility = (1 << 3),
+			Field_AvatarHash = (1 << 4),
+			Field_ProfileURL = (1 << 5),
+
+			Field_All = (1 << 6) - 1,
+		};
+
+		void OnEntryStart() override
+		{
+			m_Output.emplace_back();
+			m_SeenFields = 0;
+		}
+		bool OnEntryEnd() override
+		{
+			return m_SeenFields == Field_All;
+		}
+
+		bool OnString(const std::string_view& key, std::string& value) override
+		{
+			PlayerSummary& d = m_Output.back();
+			if (key == "steamid"sv)
+			{
+				m_SeenFields |= Field_SteamID;
+				return ParseSteamID64(value, d.m_SteamID);
+			}
+			else if (key == "personaname"sv)
+			{
+				m_SeenFields |= Field_PersonaName;
+				d.m_Nickname = std::move(value);
+			}
+			else if (key == "realname"sv)
+			{
+				d.m_RealName = std::move(value);
+			}
+			else if (key == "avatarhash"sv)
+			{
+				m_SeenFields |= Field_AvatarHash;
+				d.m_AvatarHash = std::move(value);
+			}
+			else if (key == "profileurl"sv)
+			{
+				m_SeenFields |= Field_ProfileURL;
+				d.m_ProfileURL = std::move(value);
+			}
+
+			return true;
+		}
+
+		bool OnInteger(const std::string_view& key, int64_t value) override
+		{
+			PlayerSummary& d = m_Output.back();
+			if (key == "personastate"sv)
+			{
+				m_SeenFields |= Field_PersonaState;
+				d.m_Status = PersonaState(value);
+			}
+			else if (key == "communityvisibilitystate"sv)
+			{
+				m_SeenFields |= Field_Visibility;
+				d.m_Visibility = CommunityVisibilityState(value);
+			}
+			else if (key == "lastlogoff"sv)
+			{
+				d.m_LastLogOff = std::chrono::system_clock::time_point(std::chrono::seconds(value));
+			}
+			else if (key == "profilestate"sv)
+			{
+				d.m_ProfileConfigured = value != 0;
+			}
+			else if (key == "commentpermission"sv)
+			{
+				d.m_CommentPermissions = value != 0;
+			}
+			else if (key == "timecreated"sv)
+			{
+				d.m_CreationTime = std::chrono::system_clock::time_point(std::chrono::seconds(value));
+			}
+
+			return true;
+		}
+
+		bool OnBool(const std::string_view&, bool) override { return true; }
+
+	private:
+		std::vector<PlayerSummary>& m_Output;
+		uint32_t m_SeenFields = 0;
+	};
+
+	class PlayerBansSAX final : public PlayerArraySAXBase
+	{
+	public:
+		PlayerBansSAX(std::vector<PlayerBans>& output) :
+			PlayerArraySAXBase({ "players" }), m_Output(output)
+		{
+		}
+
+	protected:
+		enum RequiredFields
+		{
+			Field_SteamID = (1 << 0),
+			Field_CommunityBanned = (1 << 1),
+			Field_VACBans = (1 << 2),
+			Field_GameBans = (1 << 3),
+			Field_DaysSinceLastBan = (1 << 4),
+			Field_EconomyBan = (1 << 5),
+
+			Field_All = (1 << 6) - 1,
+		};
+
+		void OnEntryStart() override
+		{
+			m_Output.emplace_back();
+			m_SeenFields = 0;
+		}
+		bool OnEntryEnd() override
+		{
+			return m_SeenFields == Field_All;
+		}
+
+		bool OnString(const std::string_view& key, std::string& value) override
+		{
+			PlayerBans& d = m_Output.back();
+			if (key == "SteamId"sv)
+			{
+				m_SeenFields |= Field_SteamID;
+				return ParseSteamID64(value, d.m_SteamID);
+			}
+			else if (key == "EconomyBan"sv)
+			{
+				m_SeenFields |= Field_EconomyBan;
+
+				if (value == "none"sv)
+					d.m_EconomyBan = PlayerEconomyBan::None;
+				else if (value == "banned"sv)
+					d.m_EconomyBan = PlayerEconomyBan::Banned;
+				else if (value == "probation"sv)
+					d.m_EconomyBan = PlayerEconomyBan::Probation;
+				else
+				{
+					LogError(MH_SOURCE_LOCATION_CURRENT(), "Unknown EconomyBan value "s << std::quoted(value));
+					d.m_EconomyBan = PlayerEconomyBan::Unknown;
+				}
+			}
+
+			return true;
+		}
+
+		bool OnInteger(const std::string_view& key, int64_t value) override
+		{
+			PlayerBans& d = m_Output.back();
+			if (key == "NumberOfVACBans"sv)
+			{
+				m_SeenFields |= Field_VACBans;
+				d.m_VACBanCount = static_cast<unsigned>(value);
+			}
+			else if (key == "NumberOfGameBans"sv)
+			{
+				m_SeenFields |= Field_GameBans;
+				d.m_GameBanCount = static_cast<unsigned>(value);
+			}
+			else if (key == "DaysSinceLastBan"sv)
+			{
+				m_SeenFields |= Field_DaysSinceLastBan;
+				d.m_TimeSinceLastBan = 24h * static_cast<uint32_t>(value);
+			}
+
+			return true;
+		}
+
+		bool OnBool(const std::string_view& key, bool value) override
+		{
+			if (key == "CommunityBanned"sv)
+			{
+				m_SeenFields |= Field_CommunityBanned;
+				m_Output.back().m_CommunityBanned = value;
+			}
+
+			return true;
+		}
+
+	private:
+		std::vector<PlayerBans>& m_Output;
+		uint32_t m_SeenFields = 0;
+	};
+
+	template<typename TSAX, typename TOutput>
+	static std::vector<TOutput> ParsePlayerArrayResponse(const std::string_view& response, size_t expectedCount)
+	{
+		std::vector<TOutput> retVal;
+		retVal.reserve(expectedCount);
+
+		TSAX sax(retVal);
+		if (!nlohmann::json::sax_parse(response.begin(), response.end(), &sax) || !sax.FoundArray())
+		{
+			if (sax.HasParseError())
+				throw SteamAPIError(ErrorCode::JSONParseError);
+			else
+				throw SteamAPIError(ErrorCode::JSONDeserializeError);
+		}
+
+		return retVal;
+	}
+}
+
+std::vector<PlayerSummary> tf2_bot_detector::SteamAPI::ParsePlayerSummariesResponse(
+	const std::string_view& response, size_t expectedCount)
+{
+	return ParsePlayerArrayResponse<PlayerSummariesSAX, PlayerSummary>(response, expectedCount);
+}
+
+std::vector<PlayerBans> tf2_bot_detector::SteamAPI::ParsePlayerBansResponse(
+	const std::string_view& response, size_t expectedCount)
+{
+	return ParsePlayerArrayResponse<PlayerBansSAX, PlayerBans>(response, expectedCount);
+}
+
 mh::task<std::vector<PlayerSummary>> tf2_bot_detector::SteamAPI::GetPlayerSummariesAsync(
 	const ISteamAPISettings& apiSettings, const std::vector<SteamID>& steamIDs, const HTTPClient& client)
 {
@@ -230,24 +609,7 @@ mh::task<std::vector<PlayerSummary>> tf2_bot_detector::SteamAPI::GetPlayerSummar
 	auto clientPtr = client.shared_from_this();
 	const std::string data = co_await clientPtr->GetStringAsync(url);
 
-	nlohmann::json json;
-	try
-	{
-		json = nlohmann::json::parse(data);
-	}
-	catch (...)
-	{
-		throw SteamAPIError(ErrorCode::JSONParseError);
-	}
-
-	try
-	{
-		co_return json.at("response").at("players").get<std::vector<PlayerSummary>>();
-	}
-	catch (...)
-	{
-		throw SteamAPIError(ErrorCode::JSONDeserializeError);
-	}
+	co_return ParsePlayerSummariesResponse(data, std::min<size_t>(steamIDs.size(), 100));
 }
 
 void tf2_bot_detector::SteamAPI::from_json(const nlohmann::json& j, PlayerBans& d)
@@ -293,24 +655,7 @@ mh::task<std::vector<PlayerBans>> tf2_bot_detector::SteamAPI::GetPlayerBansAsync
 		throw SteamAPIError(ErrorCode::GenericHttpError);
 	}
 
-	nlohmann::json json;
-	try
-	{
-		json = nlohmann::json::parse(response);
-	}
-	catch (const std::exception&)
-	{
-		throw SteamAPIError(ErrorCode::JSONParseError);
-	}
-
-	try
-	{
-		co_return json.at("players").get<std::vector<PlayerBans>>();
-	}
-	catch (...)
-	{
-		throw SteamAPIError(ErrorCode::JSONDeserializeError);
-	}
+	co_return ParsePlayerBansResponse(response, std::min<size_t>(steamIDs.size(), 100));
 }
 
 mh::task<duration_t> tf2_bot_detector::SteamAPI::GetTF2PlaytimeAsync(
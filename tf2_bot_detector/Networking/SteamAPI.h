@@ -104,6 +104,10 @@ namespace tf2_bot_detector::SteamAPI
 	};
 	void from_json(const nlohmann::json& j, PlayerSummary& d);
 
+	// Decodes a GetPlayerSummaries response in a single pass without building a json DOM.
+	// Throws SteamAPIError (JSONParseError/JSONDeserializeError) on failure.
+	std::vector<PlayerSummary> ParsePlayerSummariesResponse(const std::string_view& response, size_t expectedCount = 0);
+
 	mh::task<std::vector<PlayerSummary>> GetPlayerSummariesAsync(const ISteamAPISettings& apiSettings,
 		const std::vector<SteamID>& steamIDs, const IHTTPClient& client);
 
@@ -129,6 +133,10 @@ namespace tf2_bot_detector::SteamAPI
 	};
 	void from_json(const nlohmann::json& j, PlayerBans& d);
 
+	// Decodes a GetPlayerBans response in a single pass without building a json DOM.
+	// Throws SteamAPIError (JSONParseError/JSONDeserializeError) on failure.
+	std::vector<PlayerBans> ParsePlayerBansResponse(const std::string_view& response, size_t expectedCount = 0);
+
 	mh::task<std::vector<PlayerBans>> GetPlayerBansAsync(const ISteamAPISettings& apiSettings,
 		const std::vector<SteamID>& steamIDs, const IHTTPClient& client);
 
@@ -44,6 +44,7 @@ namespace
 		bool WantsContinueButton() const override { return false; }
 
 		ValidateSettingsResult ValidateSettings(const Settings& settings) const override;
+		bool GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const override;
 		void Init(const InitState& is) override {}
 		OnDrawResult OnDraw(const DrawState& ds) override;
 		bool CanCommit() const override { return true; }
@@ -97,6 +98,12 @@ namespace
 		return m_HasSetupAddons ? ValidateSettingsResult::Success : ValidateSettingsResult::TriggerOpen;
 	}
 
+	bool AddonManagerPage::GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const
+	{
+		inputs.AddValue(m_HasSetupAddons);
+		return true;
+	}
+
 	AddonManagerPage::OnDrawResult AddonManagerPage::OnDraw(const DrawState& ds)
 	{
 		ImGui::TextFmt("Setting up addons...");
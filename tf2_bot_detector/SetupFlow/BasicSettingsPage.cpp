@@ -25,6 +25,22 @@ auto BasicSettingsPage::ValidateSettings(const Settings& settings) const -> Vali
 	return InternalValidateSettings(settings) ? ValidateSettingsResult::Success : ValidateSettingsResult::TriggerOpen;
 }
 
+bool BasicSettingsPage::GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const
+{
+	// A couple of registry reads and stats, instead of FindTFDir() parsing libraryfolders.vdf and
+	// ValidateSteamDir()/ValidateTFDir() checking for each of the files they expect
+	const auto steamDir = settings.GetSteamDir();
+
+	inputs
+		.AddPath(steamDir)
+		.AddPath(steamDir / "steamapps")
+		.AddPath(steamDir / "steamapps" / "libraryfolders.vdf")
+		.AddPath(settings.m_TFDirOverride)
+		.AddValue(settings.GetLocalSteamID().ID64);
+
+	return true;
+}
+
 auto BasicSettingsPage::OnDraw(const DrawState& ds) -> OnDrawResult
 {
 	ImGui::TextFmt("Due to your configuration, some settings could not be automatically detected.");
@@ -24,6 +24,12 @@ auto ChatWrappersGeneratorPage::ValidateSettings(const Settings& settings) const
 		? ValidateSettingsResult::Success : ValidateSettingsResult::TriggerOpen;
 }
 
+bool ChatWrappersGeneratorPage::GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const
+{
+	inputs.AddValue(settings.m_Unsaved.m_ChatMsgWrappers.has_value());
+	return true;
+}
+
 auto ChatWrappersGeneratorPage::OnDraw(const DrawState& ds) -> OnDrawResult
 {
 	if (!m_ChatWrappersGenerated.valid())
@@ -20,6 +20,12 @@ auto ChatWrappersVerifyPage::ValidateSettings(const Settings& settings) const ->
 	return ValidateSettingsResult::Success;
 }
 
+bool ChatWrappersVerifyPage::GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const
+{
+	inputs.AddValue(m_Validation.valid());
+	return true;
+}
+
 auto ChatWrappersVerifyPage::OnDraw(const DrawState& ds) -> OnDrawResult
 {
 	if (!m_Validation.valid())
@@ -12,6 +12,7 @@ namespace tf2_bot_detector
 	{
 	public:
 		ValidateSettingsResult ValidateSettings(const Settings& settings) const override;
+		bool GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const override;
 		OnDrawResult OnDraw(const DrawState& ds) override;
 		void Init(const InitState& is) override;
 
@@ -12,6 +12,7 @@ namespace
 	{
 	public:
 		ValidateSettingsResult ValidateSettings(const Settings& settings) const override;
+		bool GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const override;
 
 		OnDrawResult OnDraw(const DrawState& ds) override;
 
@@ -36,6 +37,12 @@ namespace
 		return ValidateSettingsResult::Success;
 	}
 
+	bool CheckSteamOpenPage::GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const
+	{
+		inputs.AddValue(Platform::Processes::IsSteamRunning());
+		return true;
+	}
+
 	auto CheckSteamOpenPage::OnDraw(const DrawState& ds) -> OnDrawResult
 	{
 		ImGui::Text("Steam must be open to use TF2 Bot Detector.");
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "ValidationInputs.h"
+
 #undef DrawState
 
 namespace tf2_bot_detector
@@ -40,6 +42,15 @@ namespace tf2_bot_detector
 
 		[[nodiscard]] virtual ValidateSettingsResult ValidateSettings(const Settings& settings) const = 0;
 
+		// Adds everything ValidateSettings() depends on: settings fields, paths, process state, and the
+		// page's own state. SetupFlow reuses the last result of ValidateSettings() until these change, so
+		// this should be much cheaper than ValidateSettings() itself. Pages that return false are
+		// validated every time.
+		//
+		// When SetupFlow first runs, all pages are validated at once on separate threads. Reading the
+		// settings is fine, but neither this nor ValidateSettings() may modify anything another page uses.
+		[[nodiscard]] virtual bool GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const { return false; }
+
 		enum class OnDrawResult
 		{
 			// Draw again next frame unless the user clicks "Done"/"Next"
@@ -29,6 +29,15 @@ auto NetworkSettingsPage::ValidateSettings(const Settings& settings) const -> Va
 	return InternalValidateSettings(settings) ? ValidateSettingsResult::Success : ValidateSettingsResult::TriggerOpen;
 }
 
+bool NetworkSettingsPage::GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const
+{
+	inputs
+		.AddValue(settings.m_AllowInternetUsage.has_value())
+		.AddValue(settings.m_ReleaseChannel.has_value());
+
+	return true;
+}
+
 auto NetworkSettingsPage::OnDraw(const DrawState& ds) -> OnDrawResult
 {
 	ImGui::TextFmt("This tool can optionally connect to the internet to automatically update.");
@@ -18,6 +18,7 @@ namespace
 	{
 	public:
 		ValidateSettingsResult ValidateSettings(const Settings& settings) const override;
+		bool GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const override;
 
 		OnDrawResult OnDraw(const DrawState& ds) override
 		{
@@ -64,11 +65,13 @@ namespace
 
 	private:
 
-		ValidationState m_ValidationState = ValidationState::Unvalidated;
-		std::error_code m_ErrorCode;
-		std::string m_ValidationMessage;
+		// Filled in by the first ValidateSettings(), so the check runs alongside the other pages at
+		// launch, and this page only opens if it fails
+		mutable ValidationState m_ValidationState = ValidationState::Unvalidated;
+		mutable std::error_code m_ErrorCode;
+		mutable std::string m_ValidationMessage;
 
-		void Validate(const IFilesystem& fs) try
+		void Validate(const IFilesystem& fs) const try
 		{
 			assert(m_ValidationState == ValidationState::Unvalidated);
 			m_ValidationState = ValidationState::ValidationFailure;
@@ -155,6 +158,9 @@ MH_ENUM_REFLECT_END()
 
 auto PermissionsCheckPage::ValidateSettings(const Settings& settings) const -> ValidateSettingsResult
 {
+	if (m_ValidationState == ValidationState::Unvalidated)
+		Validate(IFilesystem::Get());
+
 	switch (m_ValidationState)
 	{
 	default:
@@ -169,6 +175,13 @@ auto PermissionsCheckPage::ValidateSettings(const Settings& settings) const -> V
 	}
 }
 
+bool PermissionsCheckPage::GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const
+{
+	// Only ever checked once
+	inputs.AddValue(m_ValidationState);
+	return true;
+}
+
 namespace tf2_bot_detector
 {
 	std::unique_ptr<ISetupFlowPage> CreatePermissionsCheckPage()
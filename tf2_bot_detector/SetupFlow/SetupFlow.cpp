@@ -14,6 +14,7 @@
 #include <mh/algorithm/algorithm.hpp>
 #include <mh/text/string_insertion.hpp>
 
+#include <future>
 #include <string_view>
 
 using namespace std::chrono_literals;
@@ -48,6 +49,8 @@ SetupFlow::SetupFlow()
 			assert(lhs->GetPage() != rhs->GetPage());
 			return lhs->GetPage() < rhs->GetPage();
 		});
+
+	m_ValidationCache.resize(m_Pages.size());
 }
 
 bool SetupFlow::OnUpdate(const Settings& settings)
@@ -55,19 +58,55 @@ bool SetupFlow::OnUpdate(const Settings& settings)
 	if (ShouldDraw())
 		return true;
 
+	if (!m_HasValidatedAllPages)
+	{
+		ValidateAllPages(settings);
+		m_HasValidatedAllPages = true;
+	}
+
 	size_t pageIndex = INVALID_PAGE;
 	bool dummy;
 	GetPageState(settings, pageIndex, dummy);
 	return m_ShouldDraw = pageIndex != INVALID_PAGE;
 }
 
-void SetupFlow::GetPageState(const Settings& settings, size_t& currentPage, bool& hasNextPage) const
+auto SetupFlow::ValidatePage(size_t index, const Settings& settings) -> ISetupFlowPage::ValidateSettingsResult
+{
+	const auto& page = m_Pages[index];
+
+	ValidationInputs inputs;
+	if (!page->GetValidationInputs(settings, inputs))
+		return page->ValidateSettings(settings);
+
+	auto& cached = m_ValidationCache[index];
+	if (cached.m_Inputs != inputs)
+	{
+		cached.m_Result = page->ValidateSettings(settings);
+		cached.m_Inputs = std::move(inputs);
+	}
+
+	return cached.m_Result;
+}
+
+void SetupFlow::ValidateAllPages(const Settings& settings)
+{
+	// None of the pages depend on each other, and some of them have to go to the disk or the registry,
+	// so don't make them wait in line. Each one only touches its own entry in m_ValidationCache.
+	std::vector<std::future<void>> validations;
+	for (size_t i = 0; i < m_Pages.size(); i++)
+		validations.push_back(std::async(std::launch::async, [this, i, &settings] { (void)ValidatePage(i, settings); }));
+
+	for (auto& validation : validations)
+		validation.get();
+}
+
+void SetupFlow::GetPageState(const Settings& settings, size_t& currentPage, bool& hasNextPage)
 {
 	hasNextPage = false;
 
 	for (size_t i = 0; i < m_Pages.size(); i++)
 	{
-		if (m_Pages[i]->ValidateSettings(settings) != ISetupFlowPage::ValidateSettingsResult::TriggerOpen)
+		if (ValidatePage(i, settings) != ISetupFlowPage::ValidateSettingsResult::TriggerOpen)
 			continue;
 
 		if (currentPage == INVALID_PAGE || i < currentPage)
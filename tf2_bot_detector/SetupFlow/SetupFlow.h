@@ -3,6 +3,7 @@
 #include "ISetupFlowPage.h"
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace tf2_bot_detector
@@ -26,7 +27,17 @@ namespace tf2_bot_detector
 		bool m_ShouldDraw = false;
 		std::vector<std::unique_ptr<ISetupFlowPage>> m_Pages;
 
-		void GetPageState(const Settings& settings, size_t& currentPage, bool& hasNextPage) const;
+		struct CachedValidation
+		{
+			std::optional<ValidationInputs> m_Inputs;
+			ISetupFlowPage::ValidateSettingsResult m_Result{};
+		};
+		std::vector<CachedValidation> m_ValidationCache; // Same order as m_Pages
+		bool m_HasValidatedAllPages = false;
+
+		ISetupFlowPage::ValidateSettingsResult ValidatePage(size_t index, const Settings& settings);
+		void ValidateAllPages(const Settings& settings);
+		void GetPageState(const Settings& settings, size_t& currentPage, bool& hasNextPage);
 
 		static constexpr size_t INVALID_PAGE = size_t(-1);
 		size_t m_ActivePage = INVALID_PAGE;
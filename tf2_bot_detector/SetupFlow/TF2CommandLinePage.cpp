@@ -77,6 +77,16 @@ auto TF2CommandLinePage::ValidateSettings(const Settings& settings) const -> Val
 	return ValidateSettingsResult::Success;
 }
 
+bool TF2CommandLinePage::GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const
+{
+	// Just looks for the window, the command line itself is only queried while this page is open
+	inputs
+		.AddValue(Processes::IsTF2Running())
+		.AddValue(m_Data.m_CommandLineArgs.has_value() && m_Data.m_CommandLineArgs->IsPopulated());
+
+	return true;
+}
+
 auto TF2CommandLinePage::TF2CommandLine::Parse(const std::string_view& cmdLine) -> TF2CommandLine
 {
 	const auto args = Shell::SplitCommandLineArgs(cmdLine);
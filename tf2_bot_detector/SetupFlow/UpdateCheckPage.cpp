@@ -17,6 +17,7 @@ namespace
 	{
 	public:
 		ValidateSettingsResult ValidateSettings(const Settings& settings) const override;
+		bool GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const override;
 		OnDrawResult OnDraw(const DrawState& ds) override;
 		void Init(const InitState& is) override;
 
@@ -76,6 +77,16 @@ namespace
 		return ValidateSettingsResult::Success;
 	}
 
+	bool UpdateCheckPage::GetValidationInputs(const Settings& settings, ValidationInputs& inputs) const
+	{
+		inputs
+			.AddValue(!!settings.GetHTTPClient())
+			.AddValue(m_StatusReader.get().m_Status)
+			.AddValue(m_DrawnOnce);
+
+		return true;
+	}
+
 	auto UpdateCheckPage::OnDraw(const DrawState& ds) -> OnDrawResult
 	{
 		if (!m_StatusReader.has_value())
@@ -0,0 +1,42 @@
+#include "ValidationInputs.h"
+
+using namespace tf2_bot_detector;
+
+ValidationInputs& ValidationInputs::AddValue(const std::string_view& value)
+{
+	Append('s', value);
+	return *this;
+}
+
+ValidationInputs& ValidationInputs::AddPath(const std::filesystem::path& path)
+{
+	std::error_code ec;
+	if (const auto lastWriteTime = std::filesystem::last_write_time(path, ec); !ec)
+	{
+		const auto ticks = lastWriteTime.time_since_epoch().count();
+		Append('t', std::string_view(reinterpret_cast<const char*>(&ticks), sizeof(ticks)));
+	}
+	else
+	{
+		Append('m', {}); // Missing, or we can't see it
+	}
+
+	const auto u8Path = path.u8string();
+	Append('p', std::string_view(reinterpret_cast<const char*>(u8Path.data()), u8Path.size()));
+	return *this;
+}
+
+ValidationInputs& ValidationInputs::AddInteger(int64_t value)
+{
+	Append('i', std::string_view(reinterpret_cast<const char*>(&value), sizeof(value)));
+	return *this;
+}
+
+void ValidationInputs::Append(char type, const std::string_view& data)
+{
+	// Length prefixed, so "ab" + "c" doesn't look the same as "a" + "bc"
+	const uint64_t size = data.size();
+	m_Key.push_back(type);
+	m_Key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+	m_Key.append(data);
+}
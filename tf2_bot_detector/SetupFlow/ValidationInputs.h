@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace tf2_bot_detector
+{
+	// Everything a setup flow page's validation result depends on. Two sets of inputs are equal if the
+	// same values were added in the same order, and every path added with AddPath() had the same
+	// modification time (or was missing both times).
+	class ValidationInputs final
+	{
+	public:
+		template<typename T, typename = std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>>
+		ValidationInputs& AddValue(T value) { return AddInteger(static_cast<int64_t>(value)); }
+		ValidationInputs& AddValue(const std::string_view& value);
+
+		// The path, and the modification time of the file or directory there. For a directory, that
+		// changes when something directly inside it is added, removed or renamed.
+		ValidationInputs& AddPath(const std::filesystem::path& path);
+
+		bool operator==(const ValidationInputs& other) const = default;
+
+	private:
+		ValidationInputs& AddInteger(int64_t value);
+		void Append(char type, const std::string_view& data);
+
+		std::string m_Key;
+	};
+}
@@ -70,8 +70,11 @@ namespace Catch
 	}
 }
 
-int tf2_bot_detector::RunTests()
+int tf2_bot_detector::RunTests(int argc, const char* const* argv)
 {
 	DebugLog(MH_SOURCE_LOCATION_CURRENT());
-	return Catch::Session().run();
+	if (argc < 1)
+		return Catch::Session().run();
+
+	return Catch::Session().run(argc, argv);
 }
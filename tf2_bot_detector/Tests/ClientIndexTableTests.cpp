@@ -0,0 +1,101 @@
+#include "Util/ClientIndexTable.h"
+
+#include <catch2/catch.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	struct TestPlayer
+	{
+		uint8_t m_ClientIndex = 0;
+		uint32_t m_VoiceLines = 0;
+	};
+}
+
+TEST_CASE("tf2bd_client_index_table", "[tf2bd]")
+{
+	ClientIndexTable<TestPlayer> table;
+	TestPlayer a, b;
+
+	REQUIRE(table.Find(0) == nullptr);
+	REQUIRE(table.Find(ClientIndexTable<TestPlayer>::MAX_CLIENTS) == nullptr);
+
+	REQUIRE(table.Set(1, &a) == nullptr);
+	REQUIRE(table.Set(ClientIndexTable<TestPlayer>::MAX_CLIENTS, &b) == nullptr);
+	REQUIRE(table.Find(1) == &a);
+	REQUIRE(table.Find(ClientIndexTable<TestPlayer>::MAX_CLIENTS) == &b);
+
+	// Out of range indices are ignored
+	REQUIRE(table.Set(0, &a) == nullptr);
+	REQUIRE(table.Set(ClientIndexTable<TestPlayer>::MAX_CLIENTS + 1, &a) == nullptr);
+	REQUIRE(table.Find(0) == nullptr);
+
+	// Taking over a slot returns the previous owner
+	REQUIRE(table.Set(1, &b) == &a);
+
+	// Only removes if the slot still belongs to the given value
+	table.Remove(1, &a);
+	REQUIRE(table.Find(1) == &b);
+	table.Remove(1, &b);
+	REQUIRE(table.Find(1) == nullptr);
+
+	table.clear();
+	REQUIRE(table.Find(ClientIndexTable<TestPlayer>::MAX_CLIENTS) == nullptr);
+}
+
+// Voice line lookups by entindex, old linear scan over the player map vs the table. Opt in with
+// --run-tests "[benchmark]"
+TEST_CASE("tf2bd_client_index_table_benchmark", "[tf2bd][.benchmark]")
+{
+	// A full 24 player server where 4 bots are mic spamming, which is what the voice lines look
+	// like most of the time: the same handful of entindices over and over.
+	constexpr size_t PLAYER_COUNT = 24;
+	std::unordered_map<uint64_t, TestPlayer> players;
+	ClientIndexTable<TestPlayer> table;
+	for (size_t i = 0; i < PLAYER_COUNT; i++)
+	{
+		auto& player = players[76561197960265728ull + i * 7919];
+		player.m_ClientIndex = uint8_t(i * 3 + 2);
+		table.Set(player.m_ClientIndex, &player);
+	}
+
+	std::vector<uint8_t> voiceEntIndices;
+	for (size_t i = 0; i < 4096; i++)
+		voiceEntIndices.push_back(uint8_t((PLAYER_COUNT - 1 - (i % 4)) * 3 + 1));
+
+	BENCHMARK("Scan every player")
+	{
+		uint32_t found = 0;
+		for (uint8_t entIndex : voiceEntIndices)
+		{
+			for (auto& player : players)
+			{
+				if (player.second.m_ClientIndex == (entIndex + 1))
+				{
+					player.second.m_VoiceLines++;
+					found++;
+					break;
+				}
+			}
+		}
+		return found;
+	};
+
+	BENCHMARK("ClientIndexTable")
+	{
+		uint32_t found = 0;
+		for (uint8_t entIndex : voiceEntIndices)
+		{
+			if (auto player = table.Find(uint8_t(entIndex + 1)))
+			{
+				player->m_VoiceLines++;
+				found++;
+			}
+		}
+		return found;
+	};
+}
@@ -0,0 +1,96 @@
+#include "ConsoleLog/ConsoleHistory.h"
+#include "WorldState.h"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+using namespace tf2_bot_detector;
+
+TEST_CASE("tf2bd_console_history", "[tf2bd]")
+{
+	const time_point_t timestamp{};
+
+	SECTION("Oldest records are dropped when full")
+	{
+		ConsoleHistory history(ConsoleHistory::MIN_CAPACITY);
+		for (size_t i = 0; i < ConsoleHistory::MIN_CAPACITY + 5; i++)
+			history.AddText(timestamp, { 1, 1, 1, 1 }, "line " + std::to_string(i));
+
+		REQUIRE(history.size() == ConsoleHistory::MIN_CAPACITY);
+		REQUIRE(history.GetFirstID() == 5);
+		REQUIRE(history.GetText(history[0]) == "line 5");
+		REQUIRE(history.GetText(history[history.size() - 1]) == "line 20");
+		REQUIRE(history.FindByID(4) == nullptr);
+		REQUIRE(history.FindByID(10)->m_ID == 10);
+	}
+
+	SECTION("Chat records")
+	{
+		ConsoleHistory history;
+		history.AddChat(timestamp, SteamID(76561197960265728ull + 1234), "Some Player", "hello there",
+			true, false, false, TeamShareResult::OppositeTeams);
+		history.AddSeparator(timestamp);
+
+		REQUIRE(history.size() == 2);
+		REQUIRE(history[0].m_Type == ConsoleHistoryRecordType::Chat);
+		REQUIRE(history.GetName(history[0]) == "Some Player");
+		REQUIRE(history.GetText(history[0]) == "hello there");
+		REQUIRE(history[0].m_IsDead);
+		REQUIRE(history[0].m_TeamShareResult == TeamShareResult::OppositeTeams);
+		REQUIRE(history[1].m_Type == ConsoleHistoryRecordType::Separator);
+		REQUIRE(history.GetText(history[1]).empty());
+	}
+
+	SECTION("Text arena wraps around")
+	{
+		ConsoleHistory history(ConsoleHistory::MIN_CAPACITY);
+
+		// Long enough that the text arena fills up before the record slots do
+		const std::string longText(ConsoleHistory::TEXT_BYTES_PER_RECORD * 3, 'x');
+		for (size_t i = 0; i < 100; i++)
+			history.AddText(timestamp, { 1, 1, 1, 1 }, std::to_string(i) + longText);
+
+		REQUIRE(history.size() < ConsoleHistory::MIN_CAPACITY);
+		REQUIRE(history[history.size() - 1].m_ID == 99);
+		for (size_t i = 0; i < history.size(); i++)
+			REQUIRE(history.GetText(history[i]) == std::to_string(history[i].m_ID) + longText);
+	}
+
+	SECTION("Search")
+	{
+		ConsoleHistory history;
+		history.AddChat(timestamp, {}, "Alice", "gg", false, false, false, TeamShareResult::SameTeams);
+		history.AddChat(timestamp, {}, "Bob", "BOT on red", false, false, false, TeamShareResult::SameTeams);
+		history.AddText(timestamp, { 1, 1, 1, 1 }, "Teams have been switched.");
+		history.AddChat(timestamp, {}, "Robot", "beep", false, false, false, TeamShareResult::SameTeams);
+
+		std::vector<uint64_t> results;
+		history.Find("bot", results);
+		REQUIRE(results == std::vector<uint64_t>{ 1, 3 });
+
+		// Only searches from startID onwards
+		history.AddChat(timestamp, {}, "Carol", "another bot", false, false, false, TeamShareResult::SameTeams);
+		history.Find("bot", results, 4);
+		REQUIRE(results == std::vector<uint64_t>{ 1, 3, 4 });
+	}
+
+	SECTION("Changing capacity keeps the newest records")
+	{
+		ConsoleHistory history(64);
+		for (size_t i = 0; i < 64; i++)
+			history.AddText(timestamp, { 1, 1, 1, 1 }, std::to_string(i));
+
+		history.SetCapacity(ConsoleHistory::MIN_CAPACITY);
+		REQUIRE(history.GetCapacity() == ConsoleHistory::MIN_CAPACITY);
+		REQUIRE(history.size() == ConsoleHistory::MIN_CAPACITY);
+		REQUIRE(history[0].m_ID == 64 - ConsoleHistory::MIN_CAPACITY);
+		REQUIRE(history.GetText(history[0]) == std::to_string(64 - ConsoleHistory::MIN_CAPACITY));
+
+		history.SetCapacity(1024);
+		history.AddText(timestamp, { 1, 1, 1, 1 }, "new");
+		REQUIRE(history.size() == ConsoleHistory::MIN_CAPACITY + 1);
+		REQUIRE(history.FindByID(64)->m_ID == 64);
+		REQUIRE(history.GetText(*history.FindByID(64)) == "new");
+	}
+}
@@ -97,6 +97,14 @@ namespace
 		{
 			throw mh::not_implemented_error();
 		}
+		virtual void FindPlayersUpdatedSince(time_point_t time, std::vector<IPlayer*>& players) override
+		{
+			throw mh::not_implemented_error();
+		}
+		virtual void SortPlayersByScore(std::vector<IPlayer*>& players) const override
+		{
+			throw mh::not_implemented_error();
+		}
 		virtual bool IsLocalPlayerInitialized() const override
 		{
 			throw mh::not_implemented_error();
@@ -109,6 +117,10 @@ namespace
 		{
 			throw mh::not_implemented_error();
 		}
+		virtual const NetTelemetry& GetNetTelemetry() const override
+		{
+			throw mh::not_implemented_error();
+		}
 
 	} static s_DummyWorldState;
 }
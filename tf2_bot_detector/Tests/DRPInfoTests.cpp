@@ -0,0 +1,154 @@
+#include "Config/DRPInfo.h"
+
+#include <catch2/catch.hpp>
+#include <nlohmann/json.hpp>
+
+#include <cctype>
+#include <fstream>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	std::vector<DRPInfo::Map> LoadStagingMaps()
+	{
+		std::ifstream file("cfg/discord_rich_presence.json");
+		REQUIRE(file.good());
+
+		const auto json = nlohmann::json::parse(file);
+		const auto& maps = json.at("maps");
+
+		std::vector<DRPInfo::Map> retVal;
+		for (auto it = maps.begin(); it != maps.end(); ++it)
+		{
+			auto& map = retVal.emplace_back();
+			map.m_MapNames.push_back(it.key());
+
+			if (auto found = it->find("map_name_aliases"); found != it->end())
+			{
+				for (const auto& alias : *found)
+					map.m_MapNames.push_back(alias);
+			}
+		}
+
+		REQUIRE(!retVal.empty());
+		return retVal;
+	}
+
+	std::string ToUpper(std::string str)
+	{
+		for (char& c : str)
+			c = char(std::toupper(static_cast<unsigned char>(c)));
+
+		return str;
+	}
+
+	// Map names from the config, plus a bunch of variations on them that real servers use
+	std::vector<std::string> GenerateMapNames(const std::vector<DRPInfo::Map>& maps)
+	{
+		static const std::string SUFFIXES[] =
+		{
+			"", "_rc3", "_FINAL2", "_b4", "_v2b", "_pro", "_b4fix", "_rc3_b4",
+		};
+
+		// Turns regex aliases into something they should match
+		static const std::regex ALIAS_EXPANSIONS(R"regex(\\d\+|\[(\w)\w*\])regex");
+
+		std::vector<std::string> retVal =
+		{
+			"", "_", "itemtest", "background01", "cp_", "ctf_2fort_invasion", "pl_", "koth",
+		};
+
+		for (const auto& map : maps)
+		{
+			for (const auto& name : map.m_MapNames)
+			{
+				const std::string expanded = std::regex_replace(name, ALIAS_EXPANSIONS, "$1");
+				for (const std::string& base : { expanded, expanded.substr(0, expanded.size() - 1) })
+				{
+					for (const auto& suffix : SUFFIXES)
+						retVal.push_back(base + suffix);
+				}
+
+				retVal.push_back(ToUpper(expanded));
+
+				// The digits that \d+ expands to got lost above
+				retVal.push_back(std::regex_replace(name, std::regex(R"regex(\\d\+)regex"), "12"));
+			}
+		}
+
+		return retVal;
+	}
+
+	size_t FindMapLinear(const std::vector<DRPInfo::Map>& maps, const std::string_view& name)
+	{
+		for (size_t i = 0; i < maps.size(); i++)
+		{
+			if (maps[i].Matches(name))
+				return i;
+		}
+
+		return DRPInfo::MapMatcher::npos;
+	}
+}
+
+TEST_CASE("tf2bd_drp_strip_version_suffix", "[tf2bd]")
+{
+	REQUIRE(DRPInfo::MapMatcher::StripVersionSuffix("pl_upward") == "pl_upward");
+	REQUIRE(DRPInfo::MapMatcher::StripVersionSuffix("pl_upward_rc3") == "pl_upward");
+	REQUIRE(DRPInfo::MapMatcher::StripVersionSuffix("pl_upward_final") == "pl_upward");
+	REQUIRE(DRPInfo::MapMatcher::StripVersionSuffix("pl_upward_final2") == "pl_upward");
+	REQUIRE(DRPInfo::MapMatcher::StripVersionSuffix("pl_upward_b4") == "pl_upward");
+	REQUIRE(DRPInfo::MapMatcher::StripVersionSuffix("pl_upward_v2b") == "pl_upward");
+	REQUIRE(DRPInfo::MapMatcher::StripVersionSuffix("pl_upward_a") == "pl_upward");
+	REQUIRE(DRPInfo::MapMatcher::StripVersionSuffix("pl_upward_b4fix") == "pl_upward_b4fix");
+	REQUIRE(DRPInfo::MapMatcher::StripVersionSuffix("pl_upward_pro") == "pl_upward_pro");
+	REQUIRE(DRPInfo::MapMatcher::StripVersionSuffix("pl_upward_") == "pl_upward_");
+	REQUIRE(DRPInfo::MapMatcher::StripVersionSuffix("itemtest") == "itemtest");
+}
+
+TEST_CASE("tf2bd_drp_map_matcher", "[tf2bd]")
+{
+	const auto maps = LoadStagingMaps();
+	const DRPInfo::MapMatcher matcher(maps);
+
+	for (const auto& name : GenerateMapNames(maps))
+	{
+		INFO("Map name: " << name);
+		REQUIRE(matcher.Find(name) == FindMapLinear(maps, name));
+	}
+
+	// Every map should at least be able to find itself
+	for (size_t i = 0; i < maps.size(); i++)
+		REQUIRE(matcher.Find(maps[i].m_MapNames.at(0)) == i);
+}
+
+// Matching map names against the real staging rich presence config, one Map::Matches per map
+// vs the prebuilt MapMatcher. Only runs when selected, e.g. --run-tests "[benchmark]"
+TEST_CASE("tf2bd_drp_map_matcher_benchmark", "[tf2bd][.benchmark]")
+{
+	const auto maps = LoadStagingMaps();
+	const auto names = GenerateMapNames(maps);
+
+	BENCHMARK("Map::Matches")
+	{
+		size_t found = 0;
+		for (const auto& name : names)
+			found += FindMapLinear(maps, name) != DRPInfo::MapMatcher::npos;
+
+		return found;
+	};
+
+	const DRPInfo::MapMatcher matcher(maps);
+	BENCHMARK("MapMatcher")
+	{
+		size_t found = 0;
+		for (const auto& name : names)
+			found += matcher.Find(name) != DRPInfo::MapMatcher::npos;
+
+		return found;
+	};
+}
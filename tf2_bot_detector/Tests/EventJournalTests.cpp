@@ -0,0 +1,103 @@
+#include "EventJournal/EventJournalFormat.h"
+
+#include <catch2/catch.hpp>
+
+#include <fstream>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	constexpr uint64_t STEAMID_A = 76561197960265728ull + 1234;
+	constexpr uint64_t STEAMID_B = 76561197960265728ull + 5678;
+
+	std::vector<JournalRecord> MakeRecords(int64_t startTime, size_t count, uint64_t steamID, JournalEventType type)
+	{
+		std::vector<JournalRecord> retVal;
+		for (size_t i = 0; i < count; i++)
+		{
+			retVal.push_back(JournalRecord
+				{
+					.m_Type = type,
+					.m_Timestamp = startTime + int64_t(i),
+					.m_SteamID64 = (i % 2) ? steamID : 0,
+					.m_Text = "record " + std::to_string(i),
+				});
+		}
+
+		return retVal;
+	}
+
+	void WriteJournal(const std::filesystem::path& path, const std::vector<std::vector<JournalRecord>>& segments)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(JOURNAL_FILE_MAGIC.data(), JOURNAL_FILE_MAGIC.size());
+		for (size_t i = 0; i < segments.size(); i++)
+		{
+			const auto segment = EncodeJournalSegment(segments[i], (i % 2) ? JournalCompression::None : JournalCompression::Zlib);
+			file.write(segment.data(), segment.size());
+		}
+	}
+}
+
+TEST_CASE("tf2bd_event_journal", "[tf2bd][journal]")
+{
+	const auto path = std::filesystem::temp_directory_path() / "tf2bd_event_journal_test.tf2bdj";
+
+	const std::vector<std::vector<JournalRecord>> segments =
+	{
+		MakeRecords(1000, 100, STEAMID_A, JournalEventType::ConsoleLine),
+		MakeRecords(2000, 100, STEAMID_A, JournalEventType::RuleMatch),
+		MakeRecords(3000, 100, STEAMID_B, JournalEventType::Votekick),
+	};
+	WriteJournal(path, segments);
+
+	SECTION("Round trip")
+	{
+		JournalFileReader reader(path);
+		const auto records = reader.Query({});
+		REQUIRE(records.size() == 300);
+		REQUIRE(records[150].m_Type == JournalEventType::RuleMatch);
+		REQUIRE(records[150].m_Timestamp == 2050);
+		REQUIRE(records[151].m_SteamID64 == STEAMID_A);
+		REQUIRE(records[151].m_Text == "record 51");
+		REQUIRE(reader.GetStats().m_SegmentsRead == 3);
+	}
+
+	SECTION("Segments are skipped by header")
+	{
+		JournalQuery query;
+		query.m_MinTimestamp = 2010;
+		query.m_MaxTimestamp = 2019;
+
+		JournalFileReader reader(path);
+		REQUIRE(reader.Query(query).size() == 10);
+		REQUIRE(reader.GetStats().m_SegmentsRead == 1);
+		REQUIRE(reader.GetStats().m_SegmentsSkipped == 2);
+	}
+
+	SECTION("Event type and steamid filters")
+	{
+		JournalQuery query;
+		query.m_SteamID64 = STEAMID_B;
+		query.m_EventTypeMask = 1u << uint32_t(JournalEventType::Votekick);
+
+		JournalFileReader reader(path);
+		const auto records = reader.Query(query);
+		REQUIRE(records.size() == 50);
+		for (const auto& record : records)
+			REQUIRE(record.m_SteamID64 == STEAMID_B);
+
+		REQUIRE(reader.GetStats().m_SegmentsRead == 1);
+	}
+
+	SECTION("Truncated trailing segment")
+	{
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) - 10);
+
+		JournalFileReader reader(path);
+		REQUIRE(reader.Query({}).size() == 200);
+	}
+
+	std::filesystem::remove(path);
+}
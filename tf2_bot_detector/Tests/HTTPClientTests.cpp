@@ -0,0 +1,191 @@
+#include "Config/Settings.h"
+#include "Networking/HTTPClient.h"
+#include "Networking/HTTPTransport.h"
+#include "Networking/LogsTFAPI.h"
+#include "Networking/MockHTTPServer.h"
+#include "Networking/SteamAPI.h"
+#include "Filesystem.h"
+#include "GlobalDispatcher.h"
+#include "Log.h"
+
+#include <catch2/catch.hpp>
+#include <mh/error/not_implemented_error.hpp>
+#include <nlohmann/json.hpp>
+
+#include <regex>
+
+using namespace std::chrono_literals;
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	class CannedTransport final : public IHTTPTransport
+	{
+	public:
+		mh::task<HTTPResponse> GetAsync(URL url) override
+		{
+			m_RequestCount++;
+			co_return HTTPResponse{ HTTPResponseCode::OK, mh::format("{{\"path\":\"{}\"}}", url.m_Path) };
+		}
+
+		uint32_t m_RequestCount = 0;
+	};
+
+	struct MockSteamAPISettings final : ISteamAPISettings
+	{
+		std::string GetSteamAPIKey() const override { return "0123456789ABCDEF0123456789ABCDEF"; }
+		void SetSteamAPIKey(std::string key) override { throw mh::not_implemented_error(); }
+		SteamAPIMode GetSteamAPIMode() const override { return SteamAPIMode::Direct; }
+	};
+
+	std::vector<SteamID> ParseSteamIDsParam(const std::string_view& pathAndQuery)
+	{
+		static const std::regex s_Regex(R"regex(steamids=([0-9,]+))regex", std::regex::optimize);
+
+		std::vector<SteamID> retVal;
+		std::match_results<std::string_view::const_iterator> match;
+		if (std::regex_search(pathAndQuery.begin(), pathAndQuery.end(), match, s_Regex))
+		{
+			std::string_view ids(&*match[1].first, match[1].length());
+			while (!ids.empty())
+			{
+				const auto comma = ids.find(',');
+				retVal.push_back(SteamID(ids.substr(0, comma)));
+				ids = comma == ids.npos ? std::string_view{} : ids.substr(comma + 1);
+			}
+		}
+
+		return retVal;
+	}
+
+	HTTPResponse MockPlayerSummaries(const std::string_view& pathAndQuery)
+	{
+		nlohmann::json players = nlohmann::json::array();
+		for (const SteamID& id : ParseSteamIDsParam(pathAndQuery))
+		{
+			players.push_back(nlohmann::json{
+				{ "steamid", std::to_string(id.ID64) },
+				{ "personaname", mh::format("Player {}", id.GetAccountID()) },
+				{ "personastate", 1 },
+				{ "communityvisibilitystate", 3 },
+				{ "avatarhash", "fef49e7fa7e1997310d705b2a6158ff8dc1cdfeb" },
+				{ "profileurl", mh::format("https://steamcommunity.com/profiles/{}/", id.ID64) },
+				{ "timecreated", 1262304000 + id.GetAccountID() },
+			});
+		}
+
+		return HTTPResponse{ HTTPResponseCode::OK, nlohmann::json{ { "response", { { "players", players } } } }.dump() };
+	}
+
+	HTTPResponse MockPlayerBans(const std::string_view& pathAndQuery)
+	{
+		nlohmann::json players = nlohmann::json::array();
+		for (const SteamID& id : ParseSteamIDsParam(pathAndQuery))
+		{
+			players.push_back(nlohmann::json{
+				{ "SteamId", std::to_string(id.ID64) },
+				{ "CommunityBanned", false },
+				{ "VACBanned", false },
+				{ "NumberOfVACBans", 0 },
+				{ "DaysSinceLastBan", 0 },
+				{ "NumberOfGameBans", 0 },
+				{ "EconomyBan", "none" },
+			});
+		}
+
+		return HTTPResponse{ HTTPResponseCode::OK, nlohmann::json{ { "players", players } }.dump() };
+	}
+
+	template<typename T>
+	bool AllReady(const std::vector<mh::task<T>>& tasks)
+	{
+		return std::all_of(tasks.begin(), tasks.end(), [](const mh::task<T>& t) { return t.is_ready(); });
+	}
+}
+
+TEST_CASE("tf2bd_http_record_replay", "[tf2bd][http]")
+{
+	const auto dir = IFilesystem::Get().GetTempDir() / "HTTP Record Replay Test";
+	std::filesystem::remove_all(dir);
+
+	const auto canned = std::make_shared<CannedTransport>();
+	const auto recorder = IHTTPTransport::CreateRecording(canned, dir);
+
+	const URL url = "https://api.steampowered.com/ISteamUser/GetPlayerBans/v0001/?key=SECRET&steamids=76561197960287930";
+	const HTTPResponse recorded = recorder->GetAsync(url).get();
+	REQUIRE(canned->m_RequestCount == 1);
+
+	const auto replay = IHTTPTransport::CreateReplay(dir);
+	const HTTPResponse replayed = replay->GetAsync(url).get();
+	REQUIRE(replayed.m_StatusCode == HTTPResponseCode::OK);
+	REQUIRE(replayed.m_Body == recorded.m_Body);
+
+	// API keys are not part of the recording key, and never hit the disk
+	const HTTPResponse otherKey = replay->GetAsync(
+		"https://api.steampowered.com/ISteamUser/GetPlayerBans/v0001/?key=OTHER&steamids=76561197960287930").get();
+	REQUIRE(otherKey.m_Body == recorded.m_Body);
+	for (const auto& entry : std::filesystem::directory_iterator(dir))
+		REQUIRE(IFilesystem::Get().ReadFile(entry.path()).find("key=SECRET") == std::string::npos);
+
+	REQUIRE(replay->GetAsync("https://logs.tf/api/v1/log?player=1").get().m_StatusCode == HTTPResponseCode::NotFound);
+	REQUIRE(canned->m_RequestCount == 1);
+
+	std::filesystem::remove_all(dir);
+}
+
+// Hidden by default, run with --run-tests "[benchmark]"
+TEST_CASE("tf2bd_http_scoreboard_fill", "[tf2bd][http][.benchmark]")
+{
+	constexpr size_t PLAYER_COUNT = 32;
+
+	const auto server = IMockHTTPServer::Create(28015);
+	server->SetRoute("/ISteamUser/GetPlayerSummaries/", &MockPlayerSummaries);
+	server->SetRoute("/ISteamUser/GetPlayerBans/", &MockPlayerBans);
+	server->SetRoute("/api/v1/log", [](const std::string_view&)
+		{
+			return HTTPResponse{ HTTPResponseCode::OK, R"({"success":true,"results":0,"total":42,"parameters":{},"logs":[]})" };
+		});
+
+	IMockHTTPServer::FaultSettings faults;
+	faults.m_Latency = 50ms;
+	faults.m_TooManyRequestsRate = 0.05f;
+	faults.m_ServerErrorRate = 0.02f;
+	server->SetFaultSettings(faults);
+
+	const auto client = IHTTPClient::Create(IHTTPTransport::CreateRedirected(server->GetBaseURI()));
+	const MockSteamAPISettings apiSettings;
+
+	std::vector<SteamID> steamIDs;
+	for (uint32_t i = 0; i < PLAYER_COUNT; i++)
+		steamIDs.push_back(SteamID(1000 + i, SteamAccountType::Individual));
+
+	const auto startTime = clock_t::now();
+
+	// Same batching as WorldState: one summary and one bans request for the whole server, logs.tf per player
+	std::vector<mh::task<std::vector<SteamAPI::PlayerSummary>>> summaryTasks;
+	summaryTasks.push_back(SteamAPI::GetPlayerSummariesAsync(apiSettings, steamIDs, *client));
+	std::vector<mh::task<std::vector<SteamAPI::PlayerBans>>> banTasks;
+	banTasks.push_back(SteamAPI::GetPlayerBansAsync(apiSettings, steamIDs, *client));
+	std::vector<mh::task<LogsTFAPI::PlayerLogsInfo>> logsTasks;
+	for (const SteamID& id : steamIDs)
+		logsTasks.push_back(LogsTFAPI::GetPlayerLogsInfoAsync(client, id));
+
+	while (!AllReady(summaryTasks) || !AllReady(banTasks) || !AllReady(logsTasks))
+		GetDispatcher().run_for(10ms);
+
+	const auto elapsed = clock_t::now() - startTime;
+
+	REQUIRE(summaryTasks.front().get().size() == PLAYER_COUNT);
+	REQUIRE(banTasks.front().get().size() == PLAYER_COUNT);
+	for (auto& task : logsTasks)
+		REQUIRE(task.get().m_LogsCount == 42);
+
+	const auto serverCounts = server->GetRequestCounts();
+	const auto clientCounts = client->GetRequestCounts();
+	Log("[HTTP benchmark] {} players fully populated in {}ms: {} server requests ({} injected 429s, {} injected 5xx), {} client requests ({} failed)",
+		PLAYER_COUNT, to_seconds<double>(elapsed) * 1000, serverCounts.m_Total, serverCounts.m_TooManyRequests,
+		serverCounts.m_ServerErrors, clientCounts.m_Total, clientCounts.m_Failed);
+
+	REQUIRE(serverCounts.m_Unrouted == 0);
+}
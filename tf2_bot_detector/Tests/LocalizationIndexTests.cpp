@@ -0,0 +1,120 @@
+#include "Config/LocalizationIndex.h"
+
+#include <catch2/catch.hpp>
+
+#include <fstream>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+static constexpr std::string_view TEST_LOCALIZATION_FILE = R"vdf(
+// Comment with "quotes" in it
+"lang"
+{
+	"Language"	"English"
+	"Tokens"
+	{
+		"TF_Chat_Team"	"(TEAM) %s1 :  %s2"
+		"TF_Chat_All"	"%s1 :  %s2"	[$WIN32]
+		"[english]TF_Chat_All"	"%s1 :  %s2"
+		"TF_Chat_Escaped"	"say \"%s2\""
+		"TF_Scoreboard_Title"	"Scoreboard"
+		TF_Chat_Unquoted	"unquoted"
+	}
+}
+)vdf";
+
+static void CheckTestTokens(const std::vector<LocalizationToken>& tokens)
+{
+	REQUIRE(tokens.size() == 5);
+	REQUIRE(tokens[0].m_Key == "TF_Chat_Team");
+	REQUIRE(tokens[0].m_Value == "(TEAM) %s1 :  %s2");
+	REQUIRE(tokens[1].m_Key == "TF_Chat_All");
+	REQUIRE(tokens[1].m_Value == "%s1 :  %s2");
+	REQUIRE(tokens[2].m_Key == "[english]TF_Chat_All");
+	REQUIRE(tokens[3].m_Value == "say \"%s2\"");
+	REQUIRE(tokens[4].m_Key == "TF_Chat_Unquoted");
+	REQUIRE(tokens[4].m_Value == "unquoted");
+}
+
+static std::string ToUTF16LE(const std::string_view& ascii)
+{
+	std::string retVal = "\xFF\xFE";
+	for (char c : ascii)
+	{
+		retVal.push_back(c);
+		retVal.push_back('\0');
+	}
+
+	return retVal;
+}
+
+TEST_CASE("tf2bd_localization_tokens", "[tf2bd]")
+{
+	SECTION("UTF-8")
+	{
+		CheckTestTokens(ExtractLocalizationTokens(TEST_LOCALIZATION_FILE, { "TF_Chat_"sv, "[english]TF_Chat_"sv }));
+	}
+
+	SECTION("UTF-16")
+	{
+		CheckTestTokens(ExtractLocalizationTokens(ToUTF16LE(TEST_LOCALIZATION_FILE), { "TF_Chat_"sv, "[english]TF_Chat_"sv }));
+	}
+
+	SECTION("Truncated")
+	{
+		const auto tokens = ExtractLocalizationTokens(R"("Tokens" { "TF_Chat_All" "%s1)"sv, { "TF_Chat_"sv });
+		REQUIRE(tokens.empty());
+	}
+}
+
+TEST_CASE("tf2bd_localization_index", "[tf2bd]")
+{
+	const auto tfDir = std::filesystem::temp_directory_path() / "tf2bd_localization_index_test";
+	std::filesystem::remove_all(tfDir);
+
+	const auto CreateFile = [&](const std::filesystem::path& path)
+	{
+		std::filesystem::create_directories(tfDir / path.parent_path());
+		std::ofstream(tfDir / path) << TEST_LOCALIZATION_FILE;
+	};
+
+	CreateFile("resource/tf_english.txt");
+	CreateFile("resource/chat_english.txt");
+	CreateFile("resource/tf_german.txt");
+	CreateFile("custom/b_hud/resource/chat_english.txt");
+	CreateFile("custom/b_hud/resource/closecaption_english.txt");
+	CreateFile("custom/a_hud/resource/TF_English.txt");
+	std::filesystem::create_directories(tfDir / "custom/c_sounds/sound");
+
+	LocalizationIndex index;
+	index.Update(tfDir);
+
+	const std::vector<std::filesystem::path> expected =
+	{
+		tfDir / "resource/tf_english.txt",
+		tfDir / "resource/chat_english.txt",
+		tfDir / "custom/a_hud/resource/TF_English.txt",
+		tfDir / "custom/b_hud/resource/chat_english.txt",
+	};
+	REQUIRE(index.GetFiles("english") == expected);
+	REQUIRE(index.GetFiles("german").size() == 1);
+	REQUIRE(index.GetFiles("french").empty());
+
+	// Updating without any changes gives the same result
+	index.Update(tfDir);
+	REQUIRE(index.GetFiles("english") == expected);
+
+	// A folder that didn't have a resource folder before
+	CreateFile("custom/c_sounds/resource/tf_french.txt");
+
+	// Directory write times aren't always very precise, make sure they actually change
+	const auto newResourceDir = tfDir / "custom/c_sounds/resource";
+	std::filesystem::last_write_time(newResourceDir, std::filesystem::last_write_time(newResourceDir) + std::chrono::seconds(10));
+
+	index.Update(tfDir);
+	REQUIRE(index.GetFiles("french").size() == 1);
+	REQUIRE(index.GetFiles("english") == expected);
+
+	std::filesystem::remove_all(tfDir);
+}
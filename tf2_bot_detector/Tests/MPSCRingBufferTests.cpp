@@ -0,0 +1,81 @@
+#include "Util/MPSCRingBuffer.h"
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace tf2_bot_detector;
+
+TEST_CASE("tf2bd_mpsc_ringbuffer", "[tf2bd]")
+{
+	{
+		MPSCRingBuffer<int, 4> buffer;
+		int value = 0;
+		REQUIRE(!buffer.TryPop(value));
+
+		for (int i = 0; i < 4; i++)
+			REQUIRE(buffer.TryPush(int(i)));
+
+		REQUIRE(!buffer.TryPush(4)); // Full
+
+		REQUIRE(buffer.TryPop(value));
+		REQUIRE(value == 0);
+		REQUIRE(buffer.TryPush(4)); // Wraps around
+
+		for (int i = 1; i <= 4; i++)
+		{
+			REQUIRE(buffer.TryPop(value));
+			REQUIRE(value == i);
+		}
+
+		REQUIRE(!buffer.TryPop(value));
+	}
+
+	// Several producers racing a consumer: nothing lost, each producer's items stay in order
+	{
+		constexpr uint32_t PRODUCER_COUNT = 4;
+		constexpr uint32_t ITEMS_PER_PRODUCER = 20000;
+
+		MPSCRingBuffer<uint32_t, 256> buffer;
+
+		std::vector<std::thread> producers;
+		for (uint32_t p = 0; p < PRODUCER_COUNT; p++)
+		{
+			producers.emplace_back([&buffer, p]
+				{
+					for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; i++)
+					{
+						while (!buffer.TryPush((p << 24) | i))
+							std::this_thread::yield();
+					}
+				});
+		}
+
+		std::vector<uint32_t> nextExpected(PRODUCER_COUNT, 0);
+		uint32_t received = 0;
+		bool inOrder = true;
+		while (received < PRODUCER_COUNT * ITEMS_PER_PRODUCER)
+		{
+			uint32_t value;
+			if (!buffer.TryPop(value))
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			const uint32_t producer = value >> 24;
+			inOrder &= (value & 0xFFFFFF) == nextExpected[producer]++;
+			received++;
+		}
+
+		for (auto& t : producers)
+			t.join();
+
+		REQUIRE(inOrder);
+		REQUIRE(buffer.GetPushedCount() == PRODUCER_COUNT * ITEMS_PER_PRODUCER);
+
+		uint32_t value;
+		REQUIRE(!buffer.TryPop(value));
+	}
+}
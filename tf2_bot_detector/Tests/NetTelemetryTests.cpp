@@ -0,0 +1,88 @@
+#include "ConsoleLog/NetTelemetry.h"
+#include "ConsoleLog/NetworkStatus.h"
+
+#include <catch2/catch.hpp>
+
+using namespace tf2_bot_detector;
+using namespace std::chrono_literals;
+
+TEST_CASE("tf2bd_net_telemetry", "[tf2bd]")
+{
+	NetTelemetry telemetry;
+	const time_point_t start = time_point_t{} + 1h;
+
+	SECTION("Empty")
+	{
+		REQUIRE(telemetry.GetNewestTime() == time_point_t{});
+
+		std::vector<NetTelemetryBucket> output(4);
+		telemetry.Downsample(NetMetric::InKBps, 1s, output);
+		for (const auto& bucket : output)
+			REQUIRE(bucket.empty());
+	}
+
+	SECTION("Samples in the same bucket are accumulated")
+	{
+		telemetry.AddSample(NetMetric::InLatency, start, 1);
+		telemetry.AddSample(NetMetric::InLatency, start + 50ms, 3);
+		telemetry.AddSample(NetMetric::OutLatency, start, 10);
+		REQUIRE(telemetry.GetNewestTime() == start);
+
+		std::vector<NetTelemetryBucket> output(1);
+		telemetry.Downsample(NetMetric::InLatency, NetTelemetry::BUCKET_LENGTH, output);
+		REQUIRE(output[0].m_Count == 2);
+		REQUIRE(output[0].m_Min == 1);
+		REQUIRE(output[0].m_Max == 3);
+		REQUIRE(output[0].GetAverage() == 2);
+
+		telemetry.Downsample(NetMetric::OutLatency, NetTelemetry::BUCKET_LENGTH, output);
+		REQUIRE(output[0].m_Count == 1);
+	}
+
+	SECTION("Downsampling")
+	{
+		for (int i = 0; i < 10; i++)
+			telemetry.AddSample(NetMetric::InKBps, start + (NetTelemetry::BUCKET_LENGTH * i), float(i));
+
+		std::vector<NetTelemetryBucket> output(2);
+		telemetry.Downsample(NetMetric::InKBps, NetTelemetry::BUCKET_LENGTH * 10, output);
+		REQUIRE(output[0].m_Count == 5);
+		REQUIRE(output[0].m_Min == 0);
+		REQUIRE(output[0].m_Max == 4);
+		REQUIRE(output[1].m_Count == 5);
+		REQUIRE(output[1].m_Min == 5);
+		REQUIRE(output[1].m_Max == 9);
+
+		// Only the most recent part of the ring
+		telemetry.Downsample(NetMetric::InKBps, NetTelemetry::BUCKET_LENGTH * 2, output);
+		REQUIRE(output[0].m_Max == 8);
+		REQUIRE(output[1].m_Max == 9);
+	}
+
+	SECTION("Old samples are overwritten")
+	{
+		telemetry.AddSample(NetMetric::InLossPercent, start, 50);
+		telemetry.AddSample(NetMetric::InLossPercent, start + NetTelemetry::BUCKET_LENGTH * NetTelemetry::BUCKET_COUNT, 1);
+
+		// Too old to fit in the ring any more
+		telemetry.AddSample(NetMetric::InLossPercent, start, 100);
+
+		std::vector<NetTelemetryBucket> output(1);
+		telemetry.Downsample(NetMetric::InLossPercent, NetTelemetry::BUCKET_LENGTH * NetTelemetry::BUCKET_COUNT, output);
+		REQUIRE(output[0].m_Count == 1);
+		REQUIRE(output[0].m_Max == 1);
+	}
+
+	SECTION("net_status lines")
+	{
+		REQUIRE(telemetry.Add(NetLatencyLine(start, 0.25f, 0.5f)));
+		REQUIRE(telemetry.Add(NetDataTotalLine(start, 2, 40)));
+		REQUIRE(!telemetry.Add(NetChannelChokeLine(start, 1, 1)));
+
+		std::vector<NetTelemetryBucket> output(1);
+		telemetry.Downsample(NetMetric::InLatency, 1s, output);
+		REQUIRE(output[0].GetAverage() == 0.5f);
+		telemetry.Downsample(NetMetric::OutKBps, 1s, output);
+		REQUIRE(output[0].GetAverage() == 2);
+	}
+}
@@ -0,0 +1,123 @@
+#include "Util/RecencyList.h"
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using namespace tf2_bot_detector;
+using namespace std::chrono_literals;
+
+namespace
+{
+	std::vector<uint32_t> GetRows(const RecencyList& list)
+	{
+		std::vector<uint32_t> rows;
+		list.ForEach([&](uint32_t row) { rows.push_back(row); return true; });
+		return rows;
+	}
+}
+
+TEST_CASE("tf2bd_recencylist", "[tf2bd]")
+{
+	const time_point_t start{};
+
+	RecencyList list;
+	REQUIRE(GetRows(list).empty());
+
+	// New rows go at the oldest end
+	for (uint32_t i = 0; i < 4; i++)
+		REQUIRE(list.AddRow() == i);
+
+	REQUIRE(GetRows(list) == std::vector<uint32_t>{ 0, 1, 2, 3 });
+
+	SECTION("In order")
+	{
+		list.Update(2, start + 1s);
+		list.Update(0, start + 2s);
+		list.Update(3, start + 3s);
+		list.Update(1, start + 4s);
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 1, 3, 0, 2 });
+		REQUIRE(list.GetTime(3) == start + 3s);
+
+		// Moving the newest row forward again
+		list.Update(1, start + 5s);
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 1, 3, 0, 2 });
+	}
+
+	SECTION("Ties")
+	{
+		list.Update(0, start + 1s);
+		list.Update(1, start + 1s);
+		list.Update(2, start + 1s);
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 2, 1, 0, 3 });
+
+		// Updating a row to the same time it already has moves it in front of the others
+		list.Update(0, start + 1s);
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 0, 2, 1, 3 });
+	}
+
+	SECTION("Out of order")
+	{
+		list.Update(0, start + 10s);
+		list.Update(1, start + 30s);
+		list.Update(2, start + 20s); // Between the other two
+		list.Update(3, start + 5s);  // Oldest of them all
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 1, 2, 0, 3 });
+
+		// Moving backwards in time
+		list.Update(1, start + 1s);
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 2, 0, 3, 1 });
+
+		// Nothing is older than the default time point
+		list.AddRow();
+		list.Update(4, start);
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 2, 0, 3, 1, 4 });
+	}
+
+	SECTION("Unlink")
+	{
+		list.Update(0, start + 1s);
+		list.Update(1, start + 2s);
+		list.Update(2, start + 3s);
+		list.Update(3, start + 4s);
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 3, 2, 1, 0 });
+
+		list.Unlink(2); // Middle
+		REQUIRE(!list.IsLinked(2));
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 3, 1, 0 });
+
+		list.Unlink(3); // Newest
+		list.Unlink(0); // Oldest
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 1 });
+
+		list.Unlink(0); // Already unlinked, nothing happens
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 1 });
+
+		list.Unlink(1); // Last one
+		REQUIRE(GetRows(list).empty());
+		REQUIRE(!list.IsLinked(1));
+
+		// Relinked in timestamp order
+		list.Update(2, start + 3s);
+		list.Update(0, start + 5s);
+		list.Update(3, start + 1s);
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 0, 2, 3 });
+		REQUIRE(list.IsLinked(3));
+	}
+
+	SECTION("Stop early")
+	{
+		size_t visited = 0;
+		list.ForEach([&](uint32_t) { return ++visited < 2; });
+		REQUIRE(visited == 2);
+	}
+
+	SECTION("Clear")
+	{
+		list.clear();
+		REQUIRE(list.size() == 0);
+		REQUIRE(GetRows(list).empty());
+		REQUIRE(list.AddRow() == 0);
+		REQUIRE(GetRows(list) == std::vector<uint32_t>{ 0 });
+	}
+}
@@ -0,0 +1,75 @@
+#include "Util/SecretScrubber.h"
+
+#include <catch2/catch.hpp>
+#include <mh/text/format.hpp>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	std::string Scrubbed(const SecretScrubber& scrubber, std::string str)
+	{
+		scrubber.Scrub(str);
+		return str;
+	}
+}
+
+TEST_CASE("tf2bd_secretscrubber", "[tf2bd]")
+{
+	{
+		const SecretScrubber scrubber;
+		REQUIRE(Scrubbed(scrubber, "nothing to see here") == "nothing to see here");
+	}
+
+	const SecretScrubber scrubber(
+		{
+			{ "0123456789ABCDEF", "<KEY>" },
+			{ "hunter2", "<PASSWORD>" },
+			{ "ABCDEFGH", "<OVERLAP>" },
+			{ "hunter", "<SHORT>" },
+			{ "", "<EMPTY>" },
+		});
+
+	std::string untouched = "no secrets in this one";
+	REQUIRE(!scrubber.Scrub(untouched));
+	REQUIRE(untouched == "no secrets in this one");
+
+	REQUIRE(Scrubbed(scrubber, "key=0123456789ABCDEF&x=1") == "key=<KEY>&x=1");
+	REQUIRE(Scrubbed(scrubber, "hunter2hunter2 hunter2") == "<PASSWORD><PASSWORD> <PASSWORD>");
+	REQUIRE(Scrubbed(scrubber, "0123456789ABCDEF") == "<KEY>");
+
+	// Longest secret starting at a position wins
+	REQUIRE(Scrubbed(scrubber, "password: hunter2") == "password: <PASSWORD>");
+	REQUIRE(Scrubbed(scrubber, "hunter3") == "<SHORT>3");
+
+	// A secret that starts inside another and runs past it is replaced too, nothing leaks
+	REQUIRE(Scrubbed(scrubber, "[0123456789ABCDEFGH]") == "[<KEY><OVERLAP>]");
+
+	// Secret entirely inside a longer one
+	const SecretScrubber nested({ { "abc", "<ABC>" }, { "xxabcxx", "<OUTER>" } });
+	REQUIRE(Scrubbed(nested, "xxabcxx abc xabcx") == "<OUTER> <ABC> x<ABC>x");
+}
+
+// Per-line cost of scrubbing a log line as the number of registered secrets grows. Tagged
+// [.benchmark] so it is skipped unless asked for, e.g. --run-tests "[benchmark]"
+TEST_CASE("tf2bd_secretscrubber_benchmark", "[tf2bd][.benchmark]")
+{
+	const std::string line = "[12:34:56] Game command processed in 12ms : \"status\", response 2048 bytes. "
+		"GET https://api.steampowered.com/ISteamUser/GetPlayerSummaries/v0002/?key=<redacted>&steamids=76561197960287930";
+
+	for (size_t secretCount : { 1, 8, 64 })
+	{
+		std::vector<SecretScrubber::Secret> secrets;
+		for (size_t i = 0; i < secretCount; i++)
+			secrets.push_back({ mh::format("{:032X}", i * 0x9E3779B97F4A7C15ull), "<SECRET>" });
+
+		const SecretScrubber scrubber(std::move(secrets));
+
+		BENCHMARK(mh::format("Scrub with {} secrets", secretCount))
+		{
+			std::string copy = line;
+			scrubber.Scrub(copy);
+			return copy;
+		};
+	}
+}
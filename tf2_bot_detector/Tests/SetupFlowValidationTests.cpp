@@ -0,0 +1,74 @@
+#include "SetupFlow/ValidationInputs.h"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace std::chrono_literals;
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	enum class TestState
+	{
+		A,
+		B,
+	};
+}
+
+TEST_CASE("tf2bd_setupflow_validation_inputs_values", "[tf2bd][setupflow]")
+{
+	const auto Make = [](bool flag, TestState state, const std::string_view& str)
+	{
+		ValidationInputs inputs;
+		inputs.AddValue(flag).AddValue(state).AddValue(str);
+		return inputs;
+	};
+
+	REQUIRE(Make(true, TestState::A, "abc"sv) == Make(true, TestState::A, "abc"sv));
+	REQUIRE(Make(true, TestState::A, "abc"sv) != Make(false, TestState::A, "abc"sv));
+	REQUIRE(Make(true, TestState::A, "abc"sv) != Make(true, TestState::B, "abc"sv));
+	REQUIRE(Make(true, TestState::A, "abc"sv) != Make(true, TestState::A, "abd"sv));
+	REQUIRE(ValidationInputs{} == ValidationInputs{});
+
+	// Where one value ends and the next begins matters
+	REQUIRE(ValidationInputs{}.AddValue("ab"sv).AddValue("c"sv) != ValidationInputs{}.AddValue("a"sv).AddValue("bc"sv));
+	REQUIRE(ValidationInputs{}.AddValue(1) != ValidationInputs{}.AddValue("\1\0\0\0\0\0\0\0"sv));
+}
+
+TEST_CASE("tf2bd_setupflow_validation_inputs_paths", "[tf2bd][setupflow]")
+{
+	const auto dir = std::filesystem::temp_directory_path() / "tf2bd_setupflow_validation_test";
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+
+	const auto file = dir / "libraryfolders.vdf";
+	const auto Make = [&]
+	{
+		ValidationInputs inputs;
+		inputs.AddPath(dir).AddPath(file);
+		return inputs;
+	};
+
+	const auto missing = Make();
+	REQUIRE(Make() == missing);
+
+	std::ofstream(file) << "\"libraryfolders\" {}";
+	const auto created = Make();
+	REQUIRE(created != missing);
+	REQUIRE(Make() == created);
+
+	// Set explicitly, some filesystems only store modification times to the second
+	std::filesystem::last_write_time(file, std::filesystem::last_write_time(file) + 10s);
+	REQUIRE(Make() != created);
+
+	std::filesystem::remove_all(dir);
+	REQUIRE(Make() != created);
+
+	// Not the same as a missing path, even though neither one exists
+	REQUIRE(ValidationInputs{}.AddPath(dir) != ValidationInputs{}.AddPath(dir / "other"));
+	REQUIRE(ValidationInputs{}.AddPath({}) == ValidationInputs{}.AddPath({}));
+}
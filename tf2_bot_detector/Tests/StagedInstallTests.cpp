@@ -0,0 +1,196 @@
+#include "StagedInstall.h"
+#include "Tests/TestFiles.h"
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <string>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	// A fake install of the old version, and a fake delta update to go on top of it
+	struct FakeTrees
+	{
+		FakeTrees(const std::string_view& name) :
+			m_Root(std::filesystem::temp_directory_path() / name)
+		{
+			std::filesystem::remove_all(m_Root);
+
+			WriteTestFile(m_InstallDir / "tf2_bot_detector.dll", "old dll");
+			WriteTestFile(m_InstallDir / "fonts" / "font.ttf", "font");
+			WriteTestFile(m_InstallDir / "cfg" / "settings.json", "user settings");
+
+			WriteTestFile(m_SourceDir / "tf2_bot_detector.dll", "new dll");
+			WriteTestFile(m_SourceDir / "images" / "new.png", "new image");
+		}
+		~FakeTrees()
+		{
+			std::error_code ec;
+			std::filesystem::remove_all(m_Root, ec);
+		}
+
+		const std::filesystem::path m_Root;
+		const std::filesystem::path m_InstallDir = m_Root / "tf2_bot_detector";
+		const std::filesystem::path m_SourceDir = m_Root / "update";
+	};
+}
+
+TEST_CASE("tf2bd_staged_install", "[tf2bd]")
+{
+	FakeTrees trees("tf2bd_staged_install_test");
+	const auto& installDir = trees.m_InstallDir;
+	const auto previousDir = GetStagedInstallPreviousDir(installDir);
+
+	auto manifest = CreateUpdateManifest(trees.m_SourceDir);
+	REQUIRE(manifest.size() == 2);
+
+	SECTION("Install and roll back")
+	{
+		const auto stats = InstallStaged(trees.m_SourceDir, installDir, manifest);
+		REQUIRE(stats.m_FileCount == 2);
+		REQUIRE(stats.m_ByteCount == std::string_view("new dll").size() + std::string_view("new image").size());
+		REQUIRE(stats.m_SwappedDirectories);
+
+		REQUIRE(ReadTestFile(installDir / "tf2_bot_detector.dll") == "new dll");
+		REQUIRE(ReadTestFile(installDir / "images" / "new.png") == "new image");
+		REQUIRE(ReadTestFile(installDir / "fonts" / "font.ttf") == "font");
+		REQUIRE(ReadTestFile(installDir / "cfg" / "settings.json") == "user settings");
+		REQUIRE(!std::filesystem::exists(GetStagedInstallShadowDir(installDir)));
+
+		REQUIRE(ReadTestFile(previousDir / "tf2_bot_detector.dll") == "old dll");
+		REQUIRE(!std::filesystem::exists(previousDir / "images" / "new.png"));
+
+		REQUIRE(RollbackStagedInstall(installDir));
+		REQUIRE(ReadTestFile(installDir / "tf2_bot_detector.dll") == "old dll");
+		REQUIRE(!std::filesystem::exists(installDir / "images" / "new.png"));
+		REQUIRE(ReadTestFile(installDir / "fonts" / "font.ttf") == "font");
+
+		// And forward again
+		REQUIRE(RollbackStagedInstall(installDir));
+		REQUIRE(ReadTestFile(installDir / "tf2_bot_detector.dll") == "new dll");
+	}
+
+	SECTION("Hash mismatch")
+	{
+		manifest.at(1).m_SHA256 = HashSHA256("something else");
+		REQUIRE_THROWS(InstallStaged(trees.m_SourceDir, installDir, manifest));
+
+		REQUIRE(ReadTestFile(installDir / "tf2_bot_detector.dll") == "old dll");
+		REQUIRE(!std::filesystem::exists(installDir / "images" / "new.png"));
+		REQUIRE(!std::filesystem::exists(GetStagedInstallShadowDir(installDir)));
+		REQUIRE(!std::filesystem::exists(previousDir));
+		REQUIRE(!RollbackStagedInstall(installDir));
+	}
+
+	SECTION("Missing source file")
+	{
+		manifest.push_back({ "missing.dll", HashSHA256("") });
+		REQUIRE_THROWS(InstallStaged(trees.m_SourceDir, installDir, manifest));
+		REQUIRE(ReadTestFile(installDir / "tf2_bot_detector.dll") == "old dll");
+		REQUIRE(!std::filesystem::exists(GetStagedInstallShadowDir(installDir)));
+	}
+
+	SECTION("Invalid manifest path")
+	{
+		manifest.push_back({ "../outside.dll", HashSHA256("") });
+		REQUIRE_THROWS(InstallStaged(trees.m_SourceDir, installDir, manifest));
+		REQUIRE(ReadTestFile(installDir / "tf2_bot_detector.dll") == "old dll");
+	}
+
+	SECTION("Left over staging directory")
+	{
+		WriteTestFile(GetStagedInstallShadowDir(installDir) / "junk.txt", "junk");
+		InstallStaged(trees.m_SourceDir, installDir, manifest);
+		REQUIRE(!std::filesystem::exists(installDir / "junk.txt"));
+	}
+
+	SECTION("First install")
+	{
+		std::filesystem::remove_all(installDir);
+		const auto stats = InstallStaged(trees.m_SourceDir, installDir, manifest);
+		REQUIRE(stats.m_SwappedDirectories);
+		REQUIRE(ReadTestFile(installDir / "tf2_bot_detector.dll") == "new dll");
+		REQUIRE(!RollbackStagedInstall(installDir));
+	}
+
+	SECTION("Staged inside the install")
+	{
+		// Portable mode's temp directory is inside the install, and used to be where updates were staged
+		const auto tempDir = installDir / "temp";
+		const auto sourceDir = tempDir / "Portable Updates" / "tool_1";
+		std::filesystem::create_directories(sourceDir.parent_path());
+		std::filesystem::rename(trees.m_SourceDir, sourceDir);
+		WriteTestFile(tempDir / "Portable Update Cache" / "cached.bin", "cached");
+
+		const auto stats = InstallStaged(sourceDir, installDir, manifest);
+		REQUIRE(stats.m_SwappedDirectories);
+		REQUIRE(ReadTestFile(installDir / "tf2_bot_detector.dll") == "new dll");
+		REQUIRE(ReadTestFile(installDir / "cfg" / "settings.json") == "user settings");
+		REQUIRE(!std::filesystem::exists(installDir / "temp"));
+
+		// Left behind with the version that was running
+		REQUIRE(ReadTestFile(previousDir / "temp" / "Portable Update Cache" / "cached.bin") == "cached");
+		REQUIRE(ReadTestFile(previousDir / "temp" / "Portable Updates" / "tool_1" / "images" / "new.png") == "new image");
+	}
+
+	SECTION("Previous version survives until the swap")
+	{
+		WriteTestFile(previousDir / "tf2_bot_detector.dll", "older dll");
+		InstallStaged(trees.m_SourceDir, installDir, manifest);
+		REQUIRE(ReadTestFile(previousDir / "tf2_bot_detector.dll") == "old dll");
+		REQUIRE(!std::filesystem::exists(installDir.string() + ".previous_version.old"));
+
+		// Nothing is touched if the install fails
+		manifest.at(0).m_SHA256 = HashSHA256("something else");
+		REQUIRE_THROWS(InstallStaged(trees.m_SourceDir, installDir, manifest));
+		REQUIRE(ReadTestFile(previousDir / "tf2_bot_detector.dll") == "old dll");
+	}
+
+	SECTION("Many files, many threads")
+	{
+		for (int i = 0; i < 200; i++)
+			WriteTestFile(trees.m_SourceDir / ("dir" + std::to_string(i % 7)) / (std::to_string(i) + ".bin"), std::string(i * 37, char(i)));
+
+		manifest = CreateUpdateManifest(trees.m_SourceDir);
+		REQUIRE(manifest.size() == 202);
+
+		const auto stats = InstallStaged(trees.m_SourceDir, installDir, manifest, 8);
+		REQUIRE(stats.m_FileCount == 202);
+
+		for (const auto& entry : manifest)
+			REQUIRE(HashFileSHA256(installDir / entry.m_Path) == entry.m_SHA256);
+	}
+}
+
+// Copy throughput on a build sized tree with 1 and 4 workers. Selected with --run-tests "[benchmark]",
+// it writes around 75 MB to the system temp directory.
+TEST_CASE("tf2bd_staged_install_benchmark", "[tf2bd][.benchmark]")
+{
+	FakeTrees trees("tf2bd_staged_install_benchmark");
+
+	// Roughly the shape of a real build: a few large binaries and a lot of small files
+	for (int i = 0; i < 4; i++)
+		WriteTestFile(trees.m_SourceDir / ("big" + std::to_string(i) + ".dll"), std::string(16 * 1024 * 1024, char(i)));
+	for (int i = 0; i < 500; i++)
+		WriteTestFile(trees.m_SourceDir / "images" / (std::to_string(i) + ".png"), std::string(20 * 1024, char(i)));
+
+	const auto manifest = CreateUpdateManifest(trees.m_SourceDir);
+
+	for (unsigned threadCount : { 1u, 4u })
+	{
+		const auto stats = InstallStaged(trees.m_SourceDir, trees.m_InstallDir, manifest, threadCount);
+		WARN(threadCount << " thread(s): " << stats.m_FileCount << " files, " << stats.GetMBPerSecond() << " MB/s");
+	}
+
+	BENCHMARK("InstallStaged, 1 thread")
+	{
+		return InstallStaged(trees.m_SourceDir, trees.m_InstallDir, manifest, 1).m_ByteCount;
+	};
+
+	BENCHMARK("InstallStaged, 4 threads")
+	{
+		return InstallStaged(trees.m_SourceDir, trees.m_InstallDir, manifest, 4).m_ByteCount;
+	};
+}
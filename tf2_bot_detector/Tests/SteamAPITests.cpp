@@ -0,0 +1,188 @@
+#include "Networking/HTTPTransport.h"
+#include "Networking/SteamAPI.h"
+#include "Filesystem.h"
+
+#include <catch2/catch.hpp>
+#include <mh/text/format.hpp>
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+using namespace tf2_bot_detector::SteamAPI;
+
+namespace
+{
+	// Shaped like a GetPlayerSummaries response, including the fields we don't care about
+	std::string MakePlayerSummariesResponse(size_t count)
+	{
+		std::string retVal = R"({"response":{"players":[)";
+		for (size_t i = 0; i < count; i++)
+		{
+			if (i != 0)
+				retVal += ',';
+
+			const uint64_t id64 = 76561197960265728ull + 1000 + i;
+			retVal += mh::format(R"({{"steamid":"{0}","communityvisibilitystate":3,"profilestate":1,)"
+				R"("personaname":"Player \u00e9 {1}","commentpermission":{2},"profileurl":"https://steamcommunity.com/profiles/{0}/",)"
+				R"("avatar":"https://steamcdn-a.akamaihd.net/steamcommunity/public/images/avatars/fe/fef49e7fa7e1997310d705b2a6158ff8dc1cdfeb.jpg",)"
+				R"("avatarmedium":"https://steamcdn-a.akamaihd.net/steamcommunity/public/images/avatars/fe/fef49e7fa7e1997310d705b2a6158ff8dc1cdfeb_medium.jpg",)"
+				R"("avatarhash":"fef49e7fa7e1997310d705b2a6158ff8dc1cdfeb","lastlogoff":1612345678,"personastate":{3},)"
+				R"({4}"primaryclanid":"103582791429521408","timecreated":{5},"personastateflags":0,"loccountrycode":"US"}})",
+				id64, i, i % 2, i % 7, (i % 3) ? mh::format(R"("realname":"Real {}",)", i) : "", 1262304000 + i * 1000);
+		}
+		retVal += "]}}";
+		return retVal;
+	}
+
+	std::string MakePlayerBansResponse(size_t count)
+	{
+		std::string retVal = R"({"players":[)";
+		for (size_t i = 0; i < count; i++)
+		{
+			if (i != 0)
+				retVal += ',';
+
+			retVal += mh::format(R"({{"SteamId":"{}","CommunityBanned":{},"VACBanned":{},"NumberOfVACBans":{},)"
+				R"("DaysSinceLastBan":{},"NumberOfGameBans":{},"EconomyBan":"{}"}})",
+				76561197960265728ull + 1000 + i, (i % 11) == 0, (i % 5) == 0, (i % 5) == 0 ? 1 : 0,
+				i * 3, i % 2, (i % 13) == 0 ? "banned" : "none");
+		}
+		retVal += "]}";
+		return retVal;
+	}
+
+	std::vector<PlayerSummary> ParseSummariesDOM(const std::string& response)
+	{
+		return nlohmann::json::parse(response).at("response").at("players").get<std::vector<PlayerSummary>>();
+	}
+	std::vector<PlayerBans> ParseBansDOM(const std::string& response)
+	{
+		return nlohmann::json::parse(response).at("players").get<std::vector<PlayerBans>>();
+	}
+}
+
+TEST_CASE("tf2bd_steamapi_summaries_streaming", "[tf2bd][steamapi]")
+{
+	const std::string response = MakePlayerSummariesResponse(100);
+
+	const auto expected = ParseSummariesDOM(response);
+	const auto actual = ParsePlayerSummariesResponse(response, 100);
+
+	REQUIRE(actual.size() == expected.size());
+	for (size_t i = 0; i < actual.size(); i++)
+	{
+		REQUIRE(actual[i].m_SteamID == expected[i].m_SteamID);
+		REQUIRE(actual[i].m_RealName == expected[i].m_RealName);
+		REQUIRE(actual[i].m_Nickname == expected[i].m_Nickname);
+		REQUIRE(actual[i].m_AvatarHash == expected[i].m_AvatarHash);
+		REQUIRE(actual[i].m_ProfileURL == expected[i].m_ProfileURL);
+		REQUIRE(actual[i].m_Status == expected[i].m_Status);
+		REQUIRE(actual[i].m_Visibility == expected[i].m_Visibility);
+		REQUIRE(actual[i].m_ProfileConfigured == expected[i].m_ProfileConfigured);
+		REQUIRE(actual[i].m_CommentPermissions == expected[i].m_CommentPermissions);
+		REQUIRE(actual[i].m_CreationTime == expected[i].m_CreationTime);
+		REQUIRE(actual[i].m_LastLogOff == expected[i].m_LastLogOff);
+	}
+
+	REQUIRE(ParsePlayerSummariesResponse(R"({"response":{"players":[]}})").empty());
+
+	// Missing required field
+	REQUIRE_THROWS_AS(ParsePlayerSummariesResponse(R"({"response":{"players":[{"steamid":"76561197960287930"}]}})"), SteamAPIError);
+	// Missing players array entirely
+	REQUIRE_THROWS_AS(ParsePlayerSummariesResponse(R"({"response":{}})"), SteamAPIError);
+	// Truncated
+	REQUIRE_THROWS_AS(ParsePlayerSummariesResponse(response.substr(0, response.size() / 2)), SteamAPIError);
+}
+
+TEST_CASE("tf2bd_steamapi_bans_streaming", "[tf2bd][steamapi]")
+{
+	const std::string response = MakePlayerBansResponse(100);
+
+	const auto expected = ParseBansDOM(response);
+	const auto actual = ParsePlayerBansResponse(response, 100);
+
+	REQUIRE(actual.size() == expected.size());
+	for (size_t i = 0; i < actual.size(); i++)
+	{
+		REQUIRE(actual[i].m_SteamID == expected[i].m_SteamID);
+		REQUIRE(actual[i].m_CommunityBanned == expected[i].m_CommunityBanned);
+		REQUIRE(actual[i].m_EconomyBan == expected[i].m_EconomyBan);
+		REQUIRE(actual[i].m_VACBanCount == expected[i].m_VACBanCount);
+		REQUIRE(actual[i].m_GameBanCount == expected[i].m_GameBanCount);
+		REQUIRE(actual[i].m_TimeSinceLastBan == expected[i].m_TimeSinceLastBan);
+	}
+
+	REQUIRE_THROWS_AS(ParsePlayerBansResponse(R"({"players":[{"SteamId":"76561197960287930"}]})"), SteamAPIError);
+}
+
+// Decodes real responses rather than MakePlayer*Response(), since the shape of actual profiles (long
+// summaries, unicode names, missing optional fields) is what the streaming parser is tuned for. Record
+// some from the staging directory with --http-record test_recordings/steamapi while a full server is
+// loaded, then run this with --run-tests "[benchmark]".
+TEST_CASE("tf2bd_steamapi_decode_benchmark", "[tf2bd][steamapi][.benchmark]")
+{
+	const std::filesystem::path recordingDir = "test_recordings/steamapi";
+	if (!std::filesystem::is_directory(recordingDir))
+	{
+		WARN("No recorded responses in " << recordingDir << ", nothing to benchmark");
+		return;
+	}
+
+	// The recording transport keeps the (key-less) url in each file, use it to ask the replay
+	// transport for the same response the client would get
+	const auto replay = IHTTPTransport::CreateReplay(recordingDir);
+	std::vector<std::string> summaries;
+	std::vector<std::string> bans;
+	for (const auto& entry : std::filesystem::directory_iterator(recordingDir))
+	{
+		const auto url = nlohmann::json::parse(IFilesystem::Get().ReadFile(entry.path())).at("url").get<std::string>();
+		const bool isSummaries = url.find("/ISteamUser/GetPlayerSummaries/") != url.npos;
+		const bool isBans = url.find("/ISteamUser/GetPlayerBans/") != url.npos;
+		if (!isSummaries && !isBans)
+			continue;
+
+		HTTPResponse response = replay->GetAsync("https://" + url).get();
+		if (response.m_StatusCode != HTTPResponseCode::OK)
+			continue;
+
+		(isSummaries ? summaries : bans).push_back(std::move(response.m_Body));
+	}
+
+	if (summaries.empty() || bans.empty())
+	{
+		WARN("Recording in " << recordingDir << " needs at least one GetPlayerSummaries and one GetPlayerBans response");
+		return;
+	}
+
+	BENCHMARK("GetPlayerSummaries: json DOM + from_json")
+	{
+		size_t count = 0;
+		for (const auto& response : summaries)
+			count += ParseSummariesDOM(response).size();
+		return count;
+	};
+	BENCHMARK("GetPlayerSummaries: streaming")
+	{
+		size_t count = 0;
+		for (const auto& response : summaries)
+			count += ParsePlayerSummariesResponse(response).size();
+		return count;
+	};
+
+	BENCHMARK("GetPlayerBans: json DOM + from_json")
+	{
+		size_t count = 0;
+		for (const auto& response : bans)
+			count += ParseBansDOM(response).size();
+		return count;
+	};
+	BENCHMARK("GetPlayerBans: streaming")
+	{
+		size_t count = 0;
+		for (const auto& response : bans)
+			count += ParsePlayerBansResponse(response).size();
+		return count;
+	};
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace tf2_bot_detector
+{
+	// Creates any missing parent directories, and replaces whatever was there
+	inline void WriteTestFile(const std::filesystem::path& path, const std::string_view& contents)
+	{
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << contents;
+	}
+
+	// Fails the current test if path can't be opened
+	inline std::string ReadTestFile(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		REQUIRE(file.good());
+		return std::string(std::istreambuf_iterator<char>(file), {});
+	}
+}
@@ -0,0 +1,50 @@
+#include "Util/TimingWheel.h"
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using namespace tf2_bot_detector;
+using namespace std::chrono_literals;
+
+TEST_CASE("tf2bd_timingwheel", "[tf2bd]")
+{
+	const time_point_t start{};
+	TimingWheel<int, 8> wheel(10ms, start);
+
+	std::vector<int> fired;
+	const auto Fire = [&](int value) { fired.push_back(value); };
+
+	wheel.Schedule(start + 25ms, 1);
+	wheel.Schedule(start + 20ms, 2);
+	wheel.Schedule(start + 500ms, 3); // Several revolutions out
+	REQUIRE(wheel.size() == 3);
+
+	// Never early
+	wheel.Advance(start + 19ms, Fire);
+	REQUIRE(fired.empty());
+
+	wheel.Advance(start + 20ms, Fire);
+	REQUIRE(fired == std::vector<int>{ 2 });
+
+	wheel.Advance(start + 30ms, Fire);
+	REQUIRE(fired == std::vector<int>{ 2, 1 });
+
+	// Passing over the slot for 3 on an earlier revolution doesn't fire it
+	wheel.Advance(start + 100ms, Fire);
+	REQUIRE(fired.size() == 2);
+
+	// Rescheduling from inside the callback, including into the past
+	wheel.Advance(start + 1s, [&](int value)
+		{
+			Fire(value);
+			if (value == 3)
+				wheel.Schedule(start, 4);
+		});
+	REQUIRE(fired == std::vector<int>{ 2, 1, 3 });
+	REQUIRE(wheel.size() == 1);
+
+	wheel.Advance(start + 1s + 10ms, Fire);
+	REQUIRE(fired == std::vector<int>{ 2, 1, 3, 4 });
+	REQUIRE(wheel.empty());
+}
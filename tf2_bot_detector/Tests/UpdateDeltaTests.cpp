@@ -0,0 +1,399 @@
+#include "Networking/HTTPClient.h"
+#include "Networking/HTTPTransport.h"
+#include "Networking/MockHTTPServer.h"
+#include "Util/BinaryPatch.h"
+#include "Tests/TestFiles.h"
+#include "GlobalDispatcher.h"
+#include "UpdateDownload.h"
+#include "UpdateManifest.h"
+
+#include <catch2/catch.hpp>
+#include <libzippp/libzippp.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	class PatchBuilder final
+	{
+	public:
+		PatchBuilder(uint64_t newSize) : m_Patch("TF2BDP01") { AppendU64(newSize); }
+
+		PatchBuilder& Copy(uint64_t offset, uint64_t length)
+		{
+			m_Patch.push_back('\0');
+			AppendU64(offset);
+			AppendU64(length);
+			return *this;
+		}
+		PatchBuilder& Insert(const std::string_view& bytes)
+		{
+			m_Patch.push_back('\1');
+			AppendU64(bytes.size());
+			m_Patch.append(bytes);
+			return *this;
+		}
+
+		const std::string& str() const { return m_Patch; }
+
+	private:
+		void AppendU64(uint64_t value)
+		{
+			for (size_t i = 0; i < 8; i++)
+				m_Patch.push_back(char((value >> (i * 8)) & 0xFF));
+		}
+
+		std::string m_Patch;
+	};
+
+	// A release served from a loopback server, with an old version installed next to it
+	class FakeRelease final
+	{
+	public:
+		FakeRelease(const std::string_view& name) :
+			m_Root(std::filesystem::temp_directory_path() / name),
+			m_Server(IMockHTTPServer::Create(28016)),
+			m_Client(IHTTPClient::Create(IHTTPTransport::CreateRedirected(m_Server->GetBaseURI())))
+		{
+			std::filesystem::remove_all(m_Root);
+			m_Server->SetRoute("/release/manifest.json", [this](const std::string_view&)
+				{
+					return HTTPResponse{ HTTPResponseCode::OK, nlohmann::json{ { "files", m_Files } }.dump() };
+				});
+		}
+		~FakeRelease()
+		{
+			std::error_code ec;
+			std::filesystem::remove_all(m_Root, ec);
+		}
+
+		// Returns the index of the file in the release manifest
+		size_t AddFile(const std::string& path, const std::string& contents)
+		{
+			const std::string urlPath = "/release/files/" + path;
+			Serve(urlPath, contents);
+
+			m_Files.push_back({
+				{ "path", path },
+				{ "size", contents.size() },
+				{ "sha256", HashSHA256(contents) },
+				{ "download_url", URL_BASE + urlPath },
+				});
+
+			return m_Files.size() - 1;
+		}
+
+		void AddPatch(size_t fileIndex, const std::string& fromContents, const std::string& patch)
+		{
+			const std::string urlPath = "/release/patches/" + HashSHA256(fromContents);
+			Serve(urlPath, patch);
+
+			m_Files.at(fileIndex)["patches"].push_back({
+				{ "from_sha256", HashSHA256(fromContents) },
+				{ "download_url", URL_BASE + urlPath },
+				});
+		}
+
+		// Whatever the manifest says, the server sends this
+		void Serve(const std::string& urlPath, std::string contents)
+		{
+			m_Server->SetRoute(urlPath, [this, urlPath, contents = std::move(contents)](const std::string_view&)
+				{
+					std::lock_guard lock(m_DownloadCountsMutex);
+					m_DownloadCounts[urlPath]++;
+					return HTTPResponse{ HTTPResponseCode::OK, contents };
+				});
+		}
+
+		uint32_t GetDownloadCount(const std::string& urlPath) const
+		{
+			std::lock_guard lock(m_DownloadCountsMutex);
+			auto found = m_DownloadCounts.find(urlPath);
+			return found == m_DownloadCounts.end() ? 0 : found->second;
+		}
+
+		// The client throttles with the global dispatcher, so something has to be running it
+		template<typename TFunc>
+		void Run(TFunc&& func)
+		{
+			auto future = std::async(std::launch::async, std::forward<TFunc>(func));
+			while (future.wait_for(0s) != std::future_status::ready)
+				GetDispatcher().run_for(10ms);
+
+			future.get();
+		}
+
+		static constexpr char URL_BASE[] = "https://tf2bd-util.pazer.us";
+		const std::string MANIFEST_URL = URL_BASE + "/release/manifest.json"s;
+
+		const std::filesystem::path m_Root;
+		const std::filesystem::path m_InstallDir = m_Root / "tf2_bot_detector";
+		const std::filesystem::path m_CacheDir = m_Root / "cache";
+		const std::filesystem::path m_ExtractDir = m_Root / "update";
+
+		const std::unique_ptr<IMockHTTPServer> m_Server;
+		const std::shared_ptr<IHTTPClient> m_Client;
+
+	private:
+		nlohmann::json m_Files = nlohmann::json::array();
+
+		mutable std::mutex m_DownloadCountsMutex;
+		std::map<std::string, uint32_t> m_DownloadCounts;
+	};
+}
+
+TEST_CASE("tf2bd_update_sha256", "[tf2bd]")
+{
+	REQUIRE(HashSHA256("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+	REQUIRE(HashSHA256("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+	const auto path = std::filesystem::temp_directory_path() / "tf2bd_update_sha256_test.bin";
+	const std::string contents(200 * 1024, 'x'); // More than one read buffer
+	WriteTestFile(path, contents);
+	REQUIRE(HashFileSHA256(path) == HashSHA256(contents));
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("tf2bd_binary_patch", "[tf2bd]")
+{
+	const std::string_view oldData = "The quick brown fox jumps over the lazy dog";
+
+	SECTION("Copy and insert")
+	{
+		const auto patch = PatchBuilder(41)
+			.Copy(0, 10)
+			.Insert("red")
+			.Copy(15, 28);
+
+		REQUIRE(ApplyBinaryPatch(oldData, patch.str()) == "The quick red fox jumps over the lazy dog");
+	}
+
+	SECTION("Empty output")
+	{
+		REQUIRE(ApplyBinaryPatch(oldData, PatchBuilder(0).str()).empty());
+	}
+
+	SECTION("Bad magic")
+	{
+		auto patch = PatchBuilder(0).str();
+		patch[0] = 'X';
+		REQUIRE_THROWS(ApplyBinaryPatch(oldData, patch));
+	}
+
+	SECTION("Copy out of range")
+	{
+		REQUIRE_THROWS(ApplyBinaryPatch(oldData, PatchBuilder(10).Copy(40, 10).str()));
+		REQUIRE_THROWS(ApplyBinaryPatch(oldData, PatchBuilder(1).Copy(UINT64_MAX, 2).str()));
+	}
+
+	SECTION("Wrong size")
+	{
+		REQUIRE_THROWS(ApplyBinaryPatch(oldData, PatchBuilder(5).Copy(0, 4).str()));
+		REQUIRE_THROWS(ApplyBinaryPatch(oldData, PatchBuilder(3).Copy(0, 4).str()));
+	}
+
+	SECTION("Truncated")
+	{
+		const auto patch = PatchBuilder(3).Insert("abc").str();
+		REQUIRE_THROWS(ApplyBinaryPatch(oldData, patch.substr(0, patch.size() - 1)));
+		REQUIRE_THROWS(ApplyBinaryPatch(oldData, patch.substr(0, 12)));
+	}
+
+	SECTION("Unknown op")
+	{
+		REQUIRE_THROWS(ApplyBinaryPatch(oldData, PatchBuilder(0).str() + "\x07"s));
+	}
+}
+
+TEST_CASE("tf2bd_update_manifest", "[tf2bd]")
+{
+	const auto dir = std::filesystem::temp_directory_path() / "tf2bd_update_manifest_test";
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+
+	const auto manifestPath = dir / UPDATE_MANIFEST_FILENAME;
+
+	SECTION("Round trip")
+	{
+		const std::vector<UpdateManifestEntry> entries =
+		{
+			{ "tf2_bot_detector.dll", HashSHA256("dll") },
+			{ std::filesystem::path("cfg") / "settings.json", HashSHA256("settings") },
+			{ "images/with space.png", HashSHA256("image") },
+		};
+
+		WriteUpdateManifest(manifestPath, entries);
+
+		const auto read = ReadUpdateManifest(manifestPath);
+		REQUIRE(read.size() == entries.size());
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			REQUIRE(read[i].m_Path == entries[i].m_Path);
+			REQUIRE(read[i].m_SHA256 == entries[i].m_SHA256);
+		}
+
+		// Written the same way as sha256sum
+		REQUIRE(ReadTestFile(manifestPath).starts_with(HashSHA256("dll") + " *tf2_bot_detector.dll\n"));
+	}
+
+	SECTION("sha256sum text mode and CRLF")
+	{
+		WriteTestFile(manifestPath, HashSHA256("a") + "  a.txt\r\n\r\n");
+
+		const auto read = ReadUpdateManifest(manifestPath);
+		REQUIRE(read.size() == 1);
+		REQUIRE(read[0].m_Path == "a.txt");
+	}
+
+	SECTION("Invalid paths")
+	{
+		REQUIRE(!IsValidUpdateManifestPath(""));
+		REQUIRE(!IsValidUpdateManifestPath("../tf2_bot_detector.dll"));
+		REQUIRE(!IsValidUpdateManifestPath("cfg/../../tf2_bot_detector.dll"));
+		REQUIRE(!IsValidUpdateManifestPath(std::filesystem::temp_directory_path() / "a.txt"));
+		REQUIRE(IsValidUpdateManifestPath("cfg/settings.json"));
+
+		WriteTestFile(manifestPath, HashSHA256("a") + " *../a.txt\n");
+		REQUIRE_THROWS(ReadUpdateManifest(manifestPath));
+
+		WriteTestFile(manifestPath, "not a hash *a.txt\n");
+		REQUIRE_THROWS(ReadUpdateManifest(manifestPath));
+	}
+
+	SECTION("ReplaceFile")
+	{
+		const auto source = dir / "source.txt";
+		const auto dest = dir / "sub" / "dest.txt";
+		WriteTestFile(source, "new");
+		WriteTestFile(dest, "old");
+
+		ReplaceFile(source, dest);
+		REQUIRE(ReadTestFile(dest) == "new");
+		REQUIRE(ReadTestFile(source) == "new");
+
+		auto tempPath = dest;
+		tempPath += ".tf2bd_new";
+		REQUIRE(!std::filesystem::exists(tempPath));
+
+		// Creates missing directories
+		ReplaceFile(source, dir / "a" / "b" / "c.txt");
+		REQUIRE(ReadTestFile(dir / "a" / "b" / "c.txt") == "new");
+	}
+
+	std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("tf2bd_update_download_delta", "[tf2bd][http]")
+{
+	FakeRelease release("tf2bd_update_download_delta_test");
+	const auto& installDir = release.m_InstallDir;
+	const auto& cacheDir = release.m_CacheDir;
+	const auto& extractDir = release.m_ExtractDir;
+
+	WriteTestFile(installDir / "tf2_bot_detector.dll", "old dll");
+	WriteTestFile(installDir / "unchanged.txt", "same");
+
+	const size_t dllIndex = release.AddFile("tf2_bot_detector.dll", "new dll");
+	release.AddFile("unchanged.txt", "same");
+	release.AddFile("images/new.png", "new image");
+
+	const auto RunDownloadDelta = [&]
+	{
+		release.Run([&] { DownloadDelta(*release.m_Client, release.MANIFEST_URL, installDir, cacheDir, extractDir); });
+	};
+
+	SECTION("Patches and new files")
+	{
+		release.AddPatch(dllIndex, "old dll", PatchBuilder(7).Insert("new").Copy(3, 4).str());
+		RunDownloadDelta();
+
+		REQUIRE(release.GetDownloadCount("/release/patches/" + HashSHA256("old dll")) == 1);
+		REQUIRE(release.GetDownloadCount("/release/files/tf2_bot_detector.dll") == 0);
+		REQUIRE(release.GetDownloadCount("/release/files/unchanged.txt") == 0);
+		REQUIRE(release.GetDownloadCount("/release/files/images/new.png") == 1);
+
+		REQUIRE(ReadTestFile(extractDir / "tf2_bot_detector.dll") == "new dll");
+		REQUIRE(ReadTestFile(extractDir / "images" / "new.png") == "new image");
+		REQUIRE(!std::filesystem::exists(extractDir / "unchanged.txt"));
+
+		const auto manifest = ReadUpdateManifest(extractDir / UPDATE_MANIFEST_FILENAME);
+		REQUIRE(manifest.size() == 2);
+		REQUIRE(manifest.at(0).m_Path == "tf2_bot_detector.dll");
+		REQUIRE(manifest.at(0).m_SHA256 == HashSHA256("new dll"));
+
+		// Only needed until the download finishes
+		REQUIRE(std::filesystem::is_empty(cacheDir));
+	}
+
+	SECTION("Bad patch")
+	{
+		// Applies fine, but doesn't produce the right file
+		release.AddPatch(dllIndex, "old dll", PatchBuilder(7).Insert("bad").Copy(3, 4).str());
+		RunDownloadDelta();
+
+		REQUIRE(release.GetDownloadCount("/release/patches/" + HashSHA256("old dll")) == 1);
+		REQUIRE(release.GetDownloadCount("/release/files/tf2_bot_detector.dll") == 1);
+		REQUIRE(ReadTestFile(extractDir / "tf2_bot_detector.dll") == "new dll");
+	}
+
+	SECTION("Resume from the cache")
+	{
+		WriteTestFile(cacheDir / HashSHA256("new image"), "new image");
+		WriteTestFile(cacheDir / HashSHA256("new dll"), "interrupted"); // Doesn't match its name
+		RunDownloadDelta();
+
+		REQUIRE(release.GetDownloadCount("/release/files/images/new.png") == 0);
+		REQUIRE(release.GetDownloadCount("/release/files/tf2_bot_detector.dll") == 1);
+		REQUIRE(ReadTestFile(extractDir / "images" / "new.png") == "new image");
+		REQUIRE(ReadTestFile(extractDir / "tf2_bot_detector.dll") == "new dll");
+	}
+
+	SECTION("Hash mismatch")
+	{
+		release.Serve("/release/files/images/new.png", "corrupted image");
+		REQUIRE_THROWS(RunDownloadDelta());
+		REQUIRE(!std::filesystem::exists(cacheDir / HashSHA256("new image")));
+		REQUIRE(!std::filesystem::exists(cacheDir / HashSHA256("corrupted image")));
+	}
+
+	SECTION("Falls back to the zip")
+	{
+		release.Serve("/release/files/images/new.png", "corrupted image");
+
+		const auto zipPath = release.m_Root / "release.zip";
+		{
+			const std::string dll = "new dll";
+			const std::string image = "new image";
+			libzippp::ZipArchive zip(zipPath.string());
+			zip.open(libzippp::ZipArchive::New);
+			zip.addData("tf2_bot_detector.dll", dll.data(), dll.size());
+			zip.addData("images/new.png", image.data(), image.size());
+			zip.close();
+		}
+		release.Serve("/release/full.zip", ReadTestFile(zipPath));
+
+		release.Run([&]
+			{
+				DownloadPortableBuild(*release.m_Client, release.MANIFEST_URL, FakeRelease::URL_BASE + "/release/full.zip"s,
+					installDir, cacheDir, extractDir);
+			});
+
+		REQUIRE(release.GetDownloadCount("/release/full.zip") == 1);
+		REQUIRE(ReadTestFile(extractDir / "tf2_bot_detector.dll") == "new dll");
+		REQUIRE(ReadTestFile(extractDir / "images" / "new.png") == "new image");
+
+		// Lists everything in the zip, so the update tool can check it
+		REQUIRE(ReadUpdateManifest(extractDir / UPDATE_MANIFEST_FILENAME).size() == 2);
+	}
+}
@@ -18,7 +18,13 @@ using namespace gl21;
 #include <mh/memory/unique_object.hpp>
 
 #include <array>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <map>
+#include <optional>
 #include <set>
+#include <vector>
 
 using namespace tf2_bot_detector;
 
@@ -44,6 +50,26 @@ namespace
 
 	using TextureHandle = mh::unique_object<GLuint, TextureHandleTraits>;
 
+	struct BufferHandleTraits final
+	{
+		static void delete_obj(GLuint t)
+		{
+			glDeleteBuffers(1, &t);
+		}
+		static GLuint release_obj(GLuint& t)
+		{
+			auto retVal = t;
+			t = {};
+			return retVal;
+		}
+		static bool is_obj_valid(GLuint t)
+		{
+			return t > 0;
+		}
+	};
+
+	using BufferHandle = mh::unique_object<GLuint, BufferHandleTraits>;
+
 	class TextureManager;
 
 	class Texture final : public ITexture
@@ -64,6 +90,61 @@ namespace
 		uint16_t m_Height{};
 	};
 
+	// A single RGBA texture divided into a grid of equally sized cells
+	class AtlasPage final
+	{
+	public:
+		static constexpr uint16_t PAGE_SIZE = 1024;
+
+		AtlasPage(uint16_t cellWidth, uint16_t cellHeight);
+
+		GLuint GetHandle() const { return m_Handle; }
+		uint16_t GetCellWidth() const { return m_CellWidth; }
+		uint16_t GetCellHeight() const { return m_CellHeight; }
+
+		bool IsFull() const { return m_FreeSlots.empty(); }
+		uint16_t AllocateSlot();
+		void FreeSlot(uint16_t slot) { m_FreeSlots.push_back(slot); }
+
+		// If a pixel unpack buffer is bound, data is an offset into it
+		void Upload(uint16_t slot, const void* data, uint8_t channelCount);
+		TextureRegion GetSlotRegion(uint16_t slot) const;
+
+	private:
+		TextureHandle m_Handle{};
+		uint16_t m_CellWidth{};
+		uint16_t m_CellHeight{};
+		uint16_t m_Columns{};
+		std::vector<uint16_t> m_FreeSlots;
+	};
+
+	class AtlasTexture final : public ITexture
+	{
+	public:
+		AtlasTexture(std::shared_ptr<AtlasPage> page);
+		~AtlasTexture() override { m_Page->FreeSlot(m_Slot); }
+
+		AtlasPage& GetPage() const { return *m_Page; }
+		uint16_t GetSlot() const { return m_Slot; }
+
+		bool IsLoaded() const override { return m_Loaded; }
+		void SetLoaded() { m_Loaded = true; }
+
+		handle_type GetHandle() const override { return m_Page->GetHandle(); }
+		const TextureSettings& GetSettings() const override { return m_Settings; }
+
+		uint16_t GetWidth() const override { return m_Page->GetCellWidth(); }
+		uint16_t GetHeight() const override { return m_Page->GetCellHeight(); }
+
+		TextureRegion GetRegion() const override { return m_Page->GetSlotRegion(m_Slot); }
+
+	private:
+		std::shared_ptr<AtlasPage> m_Page;
+		uint16_t m_Slot{};
+		TextureSettings m_Settings{};
+		bool m_Loaded = false;
+	};
+
 	class TextureManager final : public ITextureManager
 	{
 	public:
@@ -71,7 +152,15 @@ namespace
 
 		void EndFrame() override;
 		std::shared_ptr<ITexture> CreateTexture(const Bitmap& bitmap, const TextureSettings& settings) override;
+		std::shared_ptr<ITexture> CreateAtlasTexture(const Bitmap& bitmap) override;
+
+		std::shared_ptr<ITexture> FindCachedTexture(const std::string_view& key) override;
+		void AddCachedTexture(std::string key, std::shared_ptr<ITexture> texture) override;
+
 		size_t GetActiveTextureCount() const override { return m_Textures.size(); }
+		size_t GetAtlasPageCount() const override { return m_AtlasPages.size(); }
+		size_t GetCachedTextureBytes() const override { return m_CachedTextureBytes; }
+		size_t GetPendingUploadCount() const override { return m_PendingUploads.size(); }
 
 #ifdef IMGUI_USE_GLBINDING
 		bool HasExtension(GLextension ext) const { return GetExtensions().contains(ext); }
@@ -87,7 +176,38 @@ namespace
 #endif
 
 		uint64_t m_FrameCount{};
-		std::vector<std::shared_ptr<Texture>> m_Textures;
+
+		// Textures are only ever destroyed from EndFrame(), once we're holding the last reference,
+		// so that the GL calls happen on this thread no matter who let go of them last.
+		std::vector<std::shared_ptr<ITexture>> m_Textures;
+
+		std::vector<std::weak_ptr<AtlasPage>> m_AtlasPages;
+
+		// Atlas uploads are spread out over several frames, so that a whole lobby's worth of
+		// avatars showing up at once doesn't cause a hitch.
+		static constexpr size_t UPLOAD_BUDGET_PER_FRAME = 512 * 1024;
+		struct PendingUpload
+		{
+			std::weak_ptr<AtlasTexture> m_Texture;
+			std::vector<std::byte> m_Pixels;
+			uint8_t m_ChannelCount{};
+		};
+		std::deque<PendingUpload> m_PendingUploads;
+		BufferHandle m_UploadBuffer{};
+		void ProcessPendingUploads();
+
+		static constexpr size_t TEXTURE_CACHE_BUDGET = 32 * 1024 * 1024;
+		struct CachedTexture
+		{
+			std::string m_Key;
+			std::shared_ptr<ITexture> m_Texture;
+			size_t m_Bytes{};
+		};
+		std::list<CachedTexture> m_TextureCache; // Most recently used first
+		std::map<std::string, std::list<CachedTexture>::iterator, std::less<>> m_TextureCacheIndex;
+		size_t m_CachedTextureBytes = 0;
+		void TrimTextureCache();
+
 		mh::thread_sentinel m_Sentinel;
 	};
 }
@@ -107,10 +227,16 @@ TextureManager::TextureManager()
 void TextureManager::EndFrame()
 {
 	m_Sentinel.check();
-	std::erase_if(m_Textures, [](const std::shared_ptr<Texture>& t)
+
+	ProcessPendingUploads();
+	TrimTextureCache();
+
+	std::erase_if(m_Textures, [](const std::shared_ptr<ITexture>& t)
 		{
 			return t.use_count() == 1;
 		});
+
+	std::erase_if(m_AtlasPages, [](const std::weak_ptr<AtlasPage>& p) { return p.expired(); });
 }
 
 std::shared_ptr<ITexture> TextureManager::CreateTexture(const Bitmap& bitmap, const TextureSettings& settings)
@@ -119,6 +245,203 @@ std::shared_ptr<ITexture> TextureManager::CreateTexture(const Bitmap& bitmap, co
 	return m_Textures.emplace_back(std::make_shared<Texture>(*this, bitmap, settings));
 }
 
+std::shared_ptr<ITexture> TextureManager::CreateAtlasTexture(const Bitmap& bitmap)
+{
+	m_Sentinel.check();
+
+	// Pages are always RGBA, so 1 and 2 channel images (which rely on swizzling) get their own texture
+	constexpr uint32_t MAX_CELL_SIZE = AtlasPage::PAGE_SIZE / 2;
+	if (bitmap.GetWidth() > MAX_CELL_SIZE || bitmap.GetHeight() > MAX_CELL_SIZE || bitmap.GetChannelCount() < 3)
+		return CreateTexture(bitmap);
+
+	std::shared_ptr<AtlasPage> page;
+	for (const auto& weakPage : m_AtlasPages)
+	{
+		auto existing = weakPage.lock();
+		if (existing && !existing->IsFull() &&
+			existing->GetCellWidth() == bitmap.GetWidth() && existing->GetCellHeight() == bitmap.GetHeight())
+		{
+			page = std::move(existing);
+			break;
+		}
+	}
+
+	if (!page)
+	{
+		page = std::make_shared<AtlasPage>(uint16_t(bitmap.GetWidth()), uint16_t(bitmap.GetHeight()));
+		m_AtlasPages.push_back(page);
+	}
+
+	auto texture = std::make_shared<AtlasTexture>(std::move(page));
+
+	// Copy the pixels now, the caller's bitmap probably won't be around by the time we upload it
+	const auto pixels = static_cast<const std::byte*>(bitmap.GetData());
+	m_PendingUploads.push_back(PendingUpload
+		{
+			.m_Texture = texture,
+			.m_Pixels = std::vector<std::byte>(pixels, pixels + size_t(bitmap.GetWidth()) * bitmap.GetHeight() * bitmap.GetChannelCount()),
+			.m_ChannelCount = bitmap.GetChannelCount(),
+		});
+
+	return m_Textures.emplace_back(std::move(texture));
+}
+
+void TextureManager::ProcessPendingUploads()
+{
+	// Pixel buffer objects let the driver copy into the texture asynchronously, instead of
+	// stalling until it's done with the memory we hand it.
+	const bool usePBO = GLAD_GL_VERSION_2_1 || GLAD_GL_ARB_pixel_buffer_object;
+	if (usePBO && !m_UploadBuffer && !m_PendingUploads.empty())
+		glGenBuffers(1, &m_UploadBuffer.reset_and_get_ref());
+
+	size_t uploadedBytes = 0;
+	while (!m_PendingUploads.empty() && uploadedBytes < UPLOAD_BUDGET_PER_FRAME)
+	{
+		PendingUpload upload = std::move(m_PendingUploads.front());
+		m_PendingUploads.pop_front();
+
+		const auto texture = upload.m_Texture.lock();
+		if (!texture)
+			continue; // Nobody wanted it after all
+
+		if (usePBO)
+		{
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_UploadBuffer);
+
+			// Orphan the previous contents, so we don't have to wait for the last upload to finish
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, upload.m_Pixels.size(), nullptr, GL_STREAM_DRAW);
+			if (void* mapped = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY))
+			{
+				std::memcpy(mapped, upload.m_Pixels.data(), upload.m_Pixels.size());
+				glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+				texture->GetPage().Upload(texture->GetSlot(), nullptr, upload.m_ChannelCount);
+			}
+			else
+			{
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				texture->GetPage().Upload(texture->GetSlot(), upload.m_Pixels.data(), upload.m_ChannelCount);
+			}
+
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		}
+		else
+		{
+			texture->GetPage().Upload(texture->GetSlot(), upload.m_Pixels.data(), upload.m_ChannelCount);
+		}
+
+		texture->SetLoaded();
+		uploadedBytes += upload.m_Pixels.size();
+	}
+}
+
+std::shared_ptr<ITexture> TextureManager::FindCachedTexture(const std::string_view& key)
+{
+	m_Sentinel.check();
+
+	auto found = m_TextureCacheIndex.find(key);
+	if (found == m_TextureCacheIndex.end())
+		return nullptr;
+
+	m_TextureCache.splice(m_TextureCache.begin(), m_TextureCache, found->second);
+	return found->second->m_Texture;
+}
+
+void TextureManager::AddCachedTexture(std::string key, std::shared_ptr<ITexture> texture)
+{
+	m_Sentinel.check();
+
+	if (auto existing = m_TextureCacheIndex.find(key); existing != m_TextureCacheIndex.end())
+	{
+		m_CachedTextureBytes -= existing->second->m_Bytes;
+		m_TextureCache.erase(existing->second);
+		m_TextureCacheIndex.erase(existing);
+	}
+
+	const size_t bytes = size_t(texture->GetWidth()) * texture->GetHeight() * 4;
+	m_TextureCache.push_front({ key, std::move(texture), bytes });
+	m_TextureCacheIndex.emplace(std::move(key), m_TextureCache.begin());
+	m_CachedTextureBytes += bytes;
+}
+
+void TextureManager::TrimTextureCache()
+{
+	for (auto it = m_TextureCache.end(); m_CachedTextureBytes > TEXTURE_CACHE_BUDGET && it != m_TextureCache.begin(); )
+	{
+		--it;
+
+		// Only evict textures that nobody but us (the cache and m_Textures) is holding on to
+		if (it->m_Texture.use_count() > 2)
+			continue;
+
+		m_CachedTextureBytes -= it->m_Bytes;
+		m_TextureCacheIndex.erase(it->m_Key);
+		it = m_TextureCache.erase(it);
+	}
+}
+
+AtlasPage::AtlasPage(uint16_t cellWidth, uint16_t cellHeight) :
+	m_CellWidth(cellWidth),
+	m_CellHeight(cellHeight),
+	m_Columns(PAGE_SIZE / cellWidth)
+{
+	const uint16_t rows = PAGE_SIZE / cellHeight;
+	const uint16_t slotCount = m_Columns * rows;
+
+	// Hand out slots in order, front to back
+	m_FreeSlots.reserve(slotCount);
+	for (uint16_t i = slotCount; i > 0; i--)
+		m_FreeSlots.push_back(i - 1);
+
+	glGenTextures(1, &m_Handle.reset_and_get_ref());
+	assert(m_Handle);
+
+	glBindTexture(GL_TEXTURE_2D, m_Handle);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, PAGE_SIZE, PAGE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+uint16_t AtlasPage::AllocateSlot()
+{
+	assert(!IsFull());
+	const uint16_t slot = m_FreeSlots.back();
+	m_FreeSlots.pop_back();
+	return slot;
+}
+
+void AtlasPage::Upload(uint16_t slot, const void* data, uint8_t channelCount)
+{
+	glBindTexture(GL_TEXTURE_2D, m_Handle);
+
+	// Rows of 3 channel images aren't necessarily 4 byte aligned
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % m_Columns) * m_CellWidth, (slot / m_Columns) * m_CellHeight,
+		m_CellWidth, m_CellHeight, channelCount == 4 ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, data);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+TextureRegion AtlasPage::GetSlotRegion(uint16_t slot) const
+{
+	// Inset by half a texel so linear filtering never blends in the neighboring cells
+	constexpr float TEXEL = 1.0f / PAGE_SIZE;
+	const float x = float((slot % m_Columns) * m_CellWidth);
+	const float y = float((slot / m_Columns) * m_CellHeight);
+
+	return TextureRegion
+	{
+		.m_U0 = (x + 0.5f) * TEXEL,
+		.m_V0 = (y + 0.5f) * TEXEL,
+		.m_U1 = (x + m_CellWidth - 0.5f) * TEXEL,
+		.m_V1 = (y + m_CellHeight - 0.5f) * TEXEL,
+	};
+}
+
+AtlasTexture::AtlasTexture(std::shared_ptr<AtlasPage> page) :
+	m_Page(std::move(page)),
+	m_Slot(m_Page->AllocateSlot())
+{
+}
+
 Texture::Texture(const TextureManager& manager, const Bitmap& bitmap, const TextureSettings& settings) :
 	m_Settings(settings),
 	m_Width(bitmap.GetWidth()),
@@ -168,19 +491,21 @@ Texture::Texture(const TextureManager& manager, const Bitmap& bitmap, const Text
 		glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA_EXT, swizzle.data());
 	}
 
-#if 0
-	if (glGenerateMipmap)
+	// Generated exactly once, here. Atlas pages never have mips, they would bleed between cells.
+	if (settings.m_EnableMips && (GLAD_GL_VERSION_3_0 || GLAD_GL_ARB_framebuffer_object))
 	{
 		glGenerateMipmap(GL_TEXTURE_2D);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 	}
-	else if (glGenerateMipmapEXT)
+	else if (settings.m_EnableMips && GLAD_GL_EXT_framebuffer_object)
 	{
 		glGenerateMipmapEXT(GL_TEXTURE_2D);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 	}
 	else
-#endif
 	{
 		// just disable mipmaps
+		m_Settings.m_EnableMips = false;
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	}
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 
 namespace tf2_bot_detector
 {
@@ -11,6 +14,15 @@ namespace tf2_bot_detector
 		bool m_EnableMips = false;
 	};
 
+	// Area of GetHandle() that this texture occupies, in texture coordinates.
+	struct TextureRegion
+	{
+		float m_U0 = 0;
+		float m_V0 = 0;
+		float m_U1 = 1;
+		float m_V1 = 1;
+	};
+
 	class ITexture
 	{
 	public:
@@ -23,6 +35,12 @@ namespace tf2_bot_detector
 
 		virtual uint16_t GetWidth() const = 0;
 		virtual uint16_t GetHeight() const = 0;
+
+		// The whole texture, unless this is a slot in a shared atlas page
+		virtual TextureRegion GetRegion() const { return {}; }
+
+		// Atlas textures are uploaded a few per frame, and draw as garbage until this returns true
+		virtual bool IsLoaded() const { return true; }
 	};
 
 	class ITextureManager
@@ -37,6 +55,20 @@ namespace tf2_bot_detector
 		virtual std::shared_ptr<ITexture> CreateTexture(const Bitmap& bitmap,
 			const TextureSettings& settings = {}) = 0;
 
+		// Packs the bitmap into a shared atlas page alongside other bitmaps of the same size, so
+		// drawing many of them doesn't need a texture bind for each. The pixels are copied and then
+		// uploaded over the next few EndFrame()s, see ITexture::IsLoaded(). Falls back to
+		// CreateTexture() for bitmaps that are too big or can't share a page format.
+		virtual std::shared_ptr<ITexture> CreateAtlasTexture(const Bitmap& bitmap) = 0;
+
+		// Content-addressed texture cache. Textures are kept (most recently used first) after
+		// nobody else is using them anymore, until the cache is over its byte budget.
+		virtual std::shared_ptr<ITexture> FindCachedTexture(const std::string_view& key) = 0;
+		virtual void AddCachedTexture(std::string key, std::shared_ptr<ITexture> texture) = 0;
+
 		virtual size_t GetActiveTextureCount() const = 0;
+		virtual size_t GetAtlasPageCount() const = 0;
+		virtual size_t GetCachedTextureBytes() const = 0;
+		virtual size_t GetPendingUploadCount() const = 0;
 	};
 }
@@ -22,6 +22,9 @@ using namespace tf2_bot_detector;
 
 void MainWindow::OnDrawScoreboard()
 {
+	const auto drawStartTime = std::chrono::steady_clock::now();
+	m_ScoreboardRowsRebuilt = 0;
+
 	const auto& style = ImGui::GetStyle();
 	const auto currentFontScale = ImGui::GetCurrentFontScale();
 
@@ -123,8 +126,18 @@ void MainWindow::OnDrawScoreboard()
 				ImGui::Separator();
 			}
 
+			m_ScoreboardRows.clear();
 			for (IPlayer& player : m_MainState->GeneratePlayerPrintData())
-				OnDrawScoreboardRow(player);
+				m_ScoreboardRows.push_back(&player);
+
+			// Only submit the rows that are actually on screen, community servers can have a lot of players
+			ImGuiListClipper clipper;
+			clipper.Begin(int(m_ScoreboardRows.size()));
+			while (clipper.Step())
+			{
+				for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+					OnDrawScoreboardRow(*m_ScoreboardRows[i]);
+			}
 
 			ImGui::EndGroup();
 
@@ -138,6 +151,10 @@ void MainWindow::OnDrawScoreboard()
 	}
 
 	ImGui::EndChild();
+
+	m_ScoreboardTimes[m_ScoreboardTimeCount % m_ScoreboardTimes.size()] =
+		std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - drawStartTime).count();
+	m_ScoreboardTimeCount++;
 }
 
 // src/dest terminology is mirroring that of opengl: dest color is the base color, src color is the color we are blending towards
@@ -155,43 +172,128 @@ static ImVec4 BlendColors(const std::array<float, 4>& dstColor, const std::array
 	return ImVec4(result);
 }
 
+auto MainWindow::GetScoreboardRowModel(IPlayer& player) -> const ScoreboardRowModel&
+{
+	static constexpr bool DEBUG_ALWAYS_DRAW_ICONS = false;
+
+	auto& model = player.GetOrCreateData<ScoreboardRowModel>();
+
+	// Rebuild when a world event or mark change may have touched this row, when an API request for this
+	// player finishes, and at least once a second for the connected time column and anything that doesn't
+	// have an event (friends list, lobby teams, playerlists that finish loading in the background).
+	const auto now = std::chrono::steady_clock::now();
+	const auto attributesGeneration = GetModLogic().GetPlayerAttributesGeneration();
+	const auto& summary = player.GetPlayerSummary();
+	const auto& bans = player.GetPlayerBans();
+	if (model.m_WorldGeneration == m_ScoreboardGeneration &&
+		model.m_AttributesGeneration == attributesGeneration &&
+		model.m_HasSummary == bool(summary) &&
+		model.m_HasBans == bool(bans) &&
+		(now - model.m_BuildTime) < 1s)
+	{
+		return model;
+	}
+
+	m_ScoreboardRowsRebuilt++;
+	model.m_WorldGeneration = m_ScoreboardGeneration;
+	model.m_AttributesGeneration = attributesGeneration;
+	model.m_HasSummary = bool(summary);
+	model.m_HasBans = bool(bans);
+	model.m_BuildTime = now;
+
+	model.m_TeamShareResult = GetModLogic().GetTeamShareResult(player);
+	model.m_Team = player.GetTeam();
+	model.m_Attributes = GetModLogic().GetPlayerAttributes(player);
+
+	model.m_HighlightAttribute.reset();
+	for (auto attr : { PlayerAttribute::Cheater, PlayerAttribute::Suspicious, PlayerAttribute::Exploiter, PlayerAttribute::Racist })
+	{
+		if (model.m_Attributes.Has(attr))
+		{
+			model.m_HighlightAttribute = attr;
+			break;
+		}
+	}
+
+	const auto& playerName = player.GetNameSafe();
+	model.m_IsConnecting = player.GetConnectionState() != PlayerStatusState::Active || playerName.empty();
+	model.m_IsLocalPlayer = player.GetSteamID() == m_Settings.GetLocalSteamID();
+
+	if (!player.GetUserID().has_value())
+		model.m_UserID = "?";
+	else
+		model.m_UserID.fmt("{}", player.GetUserID().value());
+
+	if (!playerName.empty())
+		model.m_Name = playerName;
+	else if (summary && !summary->m_Nickname.empty())
+		model.m_Name = summary->m_Nickname;
+	else
+		model.m_Name = "<Unknown>";
+
+	// If their steamcommunity name doesn't match their ingame name
+	model.m_MismatchedSteamName.clear();
+	if (summary && !playerName.empty() && summary->m_Nickname != playerName)
+		model.m_MismatchedSteamName = mh::format("({})", summary->m_Nickname);
+
+	model.m_VACBanned = bans && (DEBUG_ALWAYS_DRAW_ICONS || bans->m_VACBanCount > 0);
+	model.m_GameBanned = bans && (DEBUG_ALWAYS_DRAW_ICONS || bans->m_GameBanCount > 0);
+	model.m_IsFriend = DEBUG_ALWAYS_DRAW_ICONS || player.IsFriend();
+
+	if (playerName.empty())
+	{
+		model.m_Kills = "?";
+		model.m_Deaths = "?";
+		model.m_ConnectedTime = "?";
+		model.m_Ping = "?";
+	}
+	else
+	{
+		model.m_Kills.fmt("{}", player.GetScores().m_Kills);
+		model.m_Deaths.fmt("{}", player.GetScores().m_Deaths);
+		model.m_ConnectedTime.fmt("{}:{:02}",
+			std::chrono::duration_cast<std::chrono::minutes>(player.GetConnectedTime()).count(),
+			std::chrono::duration_cast<std::chrono::seconds>(player.GetConnectedTime()).count() % 60);
+		model.m_Ping.fmt("{}", player.GetPing());
+	}
+
+	model.m_SteamID.fmt("{}", player.GetSteamID().str());
+	model.m_SteamIDValid = player.GetSteamID().Type != SteamAccountType::Invalid;
+
+	return model;
+}
+
 void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 {
 	if (!m_Settings.m_LazyLoadAPIData)
 		TryGetAvatarTexture(player);
 
-	const auto& playerName = player.GetNameSafe();
+	const ScoreboardRowModel& model = GetScoreboardRowModel(player);
+	const auto& colors = m_Settings.m_Theme.m_Colors;
+
 	ImGuiDesktop::ScopeGuards::ID idScope((int)player.GetSteamID().Lower32);
 	ImGuiDesktop::ScopeGuards::ID idScope2((int)player.GetSteamID().Upper32);
 
 	ImGuiDesktop::ScopeGuards::StyleColor textColor;
-	if (player.GetConnectionState() != PlayerStatusState::Active || player.GetNameSafe().empty())
-		textColor = { ImGuiCol_Text, m_Settings.m_Theme.m_Colors.m_ScoreboardConnectingFG };
-	else if (player.GetSteamID() == m_Settings.GetLocalSteamID())
-		textColor = { ImGuiCol_Text, m_Settings.m_Theme.m_Colors.m_ScoreboardYouFG };
-
-	mh::fmtstr<32> buf;
-	if (!player.GetUserID().has_value())
-		buf = "?";
-	else
-		buf.fmt("{}", player.GetUserID().value());
+	if (model.m_IsConnecting)
+		textColor = { ImGuiCol_Text, colors.m_ScoreboardConnectingFG };
+	else if (model.m_IsLocalPlayer)
+		textColor = { ImGuiCol_Text, colors.m_ScoreboardYouFG };
 
 	bool shouldDrawPlayerTooltip = false;
 
 	// Selectable
-	const auto teamShareResult = GetModLogic().GetTeamShareResult(player);
-	const auto playerAttribs = GetModLogic().GetPlayerAttributes(player);
 	{
 		ImVec4 bgColor = [&]() -> ImVec4
 		{
-			switch (teamShareResult)
+			switch (model.m_TeamShareResult)
 			{
-			case TeamShareResult::SameTeams:      return m_Settings.m_Theme.m_Colors.m_ScoreboardFriendlyTeamBG;
-			case TeamShareResult::OppositeTeams:  return m_Settings.m_Theme.m_Colors.m_ScoreboardEnemyTeamBG;
+			case TeamShareResult::SameTeams:      return colors.m_ScoreboardFriendlyTeamBG;
+			case TeamShareResult::OppositeTeams:  return colors.m_ScoreboardEnemyTeamBG;
 			case TeamShareResult::Neither:        break;
 			}
 
-			switch (player.GetTeam())
+			switch (model.m_Team)
 			{
 			case TFTeam::Red:   return ImVec4(1.0f, 0.5f, 0.5f, 0.5f);
 			case TFTeam::Blue:  return ImVec4(0.5f, 0.5f, 1.0f, 0.5f);
@@ -199,14 +301,21 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 			}
 		}();
 
-		if (playerAttribs.Has(PlayerAttribute::Cheater))
-			bgColor = BlendColors(bgColor.to_array(), m_Settings.m_Theme.m_Colors.m_ScoreboardCheaterBG, TimeSine());
-		else if (playerAttribs.Has(PlayerAttribute::Suspicious))
-			bgColor = BlendColors(bgColor.to_array(), m_Settings.m_Theme.m_Colors.m_ScoreboardSuspiciousBG, TimeSine());
-		else if (playerAttribs.Has(PlayerAttribute::Exploiter))
-			bgColor = BlendColors(bgColor.to_array(), m_Settings.m_Theme.m_Colors.m_ScoreboardExploiterBG, TimeSine());
-		else if (playerAttribs.Has(PlayerAttribute::Racist))
-			bgColor = BlendColors(bgColor.to_array(), m_Settings.m_Theme.m_Colors.m_ScoreboardRacistBG, TimeSine());
+		if (model.m_HighlightAttribute)
+		{
+			const auto& highlightColor = [&]() -> const std::array<float, 4>&
+			{
+				switch (*model.m_HighlightAttribute)
+				{
+				case PlayerAttribute::Suspicious:  return colors.m_ScoreboardSuspiciousBG;
+				case PlayerAttribute::Exploiter:   return colors.m_ScoreboardExploiterBG;
+				case PlayerAttribute::Racist:      return colors.m_ScoreboardRacistBG;
+				default:                           return colors.m_ScoreboardCheaterBG;
+				}
+			}();
+
+			bgColor = BlendColors(bgColor.to_array(), highlightColor, TimeSine());
+		}
 
 		ImGuiDesktop::ScopeGuards::StyleColor styleColorScope(ImGuiCol_Header, bgColor);
 
@@ -215,7 +324,7 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 
 		bgColor.w = std::min(bgColor.w + 0.5f, 1.0f);
 		ImGuiDesktop::ScopeGuards::StyleColor styleColorScopeActive(ImGuiCol_HeaderActive, bgColor);
-		ImGui::Selectable(buf.c_str(), true, ImGuiSelectableFlags_SpanAllColumns);
+		ImGui::Selectable(model.m_UserID.c_str(), true, ImGuiSelectableFlags_SpanAllColumns);
 
 		shouldDrawPlayerTooltip = ImGui::IsItemHovered();
 
@@ -226,87 +335,39 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 
 	// player names column
 	{
-		static constexpr bool DEBUG_ALWAYS_DRAW_ICONS = false;
-
 		const auto columnEndX = ImGui::GetCursorPosX() - ImGui::GetStyle().ItemSpacing.x + ImGui::GetColumnWidth();
 
-		if (!playerName.empty())
-			ImGui::TextFmt(playerName);
-		else if (const auto& summary = player.GetPlayerSummary(); summary && !summary->m_Nickname.empty())
-			ImGui::TextFmt(summary->m_Nickname);
-		else
-			ImGui::TextFmt("<Unknown>");
+		ImGui::TextFmt(model.m_Name);
 
-		// If their steamcommunity name doesn't match their ingame name
-		if (auto summary = player.GetPlayerSummary();
-			summary && !playerName.empty() && summary->m_Nickname != playerName)
+		if (!model.m_MismatchedSteamName.empty())
 		{
 			ImGui::SameLine();
-			ImGui::TextFmt({ 1, 0, 0, 1 }, "({})", summary->m_Nickname);
+			ImGui::TextFmt({ 1, 0, 0, 1 }, model.m_MismatchedSteamName);
 		}
 
-		// Move cursor pos up a few pixels if we have icons to draw
 		struct IconDrawData
 		{
 			ImTextureID m_Texture;
 			ImVec4 m_Color{ 1, 1, 1, 1 };
 			std::string_view m_Tooltip;
 		};
-		std::vector<IconDrawData> icons;
+		std::array<IconDrawData, 3> icons;
+		size_t iconCount = 0;
 
-		// Check their steam bans
-		if (auto bans = player.GetPlayerBans())
+		const auto AddIcon = [&](const ITexture* icon, const ImVec4& color, const std::string_view& tooltip)
 		{
-			// If they are VAC banned
-			std::invoke([&]
-				{
-					if constexpr (!DEBUG_ALWAYS_DRAW_ICONS)
-					{
-						if (bans->m_VACBanCount <= 0)
-							return;
-					}
-
-					auto icon = m_BaseTextures->GetVACShield_16();
-					if (!icon)
-						return;
-
-					icons.push_back({ (ImTextureID)(intptr_t)icon->GetHandle(), { 1, 1, 1, 1 }, "VAC Banned" });
-				});
-
-			// If they are game banned
-			std::invoke([&]
-				{
-					if constexpr (!DEBUG_ALWAYS_DRAW_ICONS)
-					{
-						if (bans->m_GameBanCount <= 0)
-							return;
-					}
-
-					auto icon = m_BaseTextures->GetGameBanIcon_16();
-					if (!icon)
-						return;
-
-					icons.push_back({ (ImTextureID)(intptr_t)icon->GetHandle(), { 1, 1, 1, 1 }, "Game Banned" });
-				});
-		}
-
-		// If they are friends with us on Steam
-		std::invoke([&]
-			{
-				if constexpr (!DEBUG_ALWAYS_DRAW_ICONS)
-				{
-					if (!player.IsFriend())
-						return;
-				}
+			if (icon)
+				icons[iconCount++] = { (ImTextureID)(intptr_t)icon->GetHandle(), color, tooltip };
+		};
 
-				auto icon = m_BaseTextures->GetHeart_16();
-				if (!icon)
-					return;
+		if (model.m_VACBanned)
+			AddIcon(m_BaseTextures->GetVACShield_16(), { 1, 1, 1, 1 }, "VAC Banned");
+		if (model.m_GameBanned)
+			AddIcon(m_BaseTextures->GetGameBanIcon_16(), { 1, 1, 1, 1 }, "Game Banned");
+		if (model.m_IsFriend)
+			AddIcon(m_BaseTextures->GetHeart_16(), { 1, 0, 0, 1 }, "Steam Friends");
 
-				icons.push_back({ (ImTextureID)(intptr_t)icon->GetHandle(), { 1, 0, 0, 1 }, "Steam Friends" });
-			});
-
-		if (!icons.empty())
+		if (iconCount > 0)
 		{
 			// We have at least one icon to draw
 			ImGui::SameLine();
@@ -317,9 +378,9 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 			const float iconSize = 16 * ImGui::GetCurrentFontScale();
 
 			const auto spacing = ImGui::GetStyle().ItemSpacing.x;
-			ImGui::SetCursorPosX(columnEndX - (iconSize + spacing) * icons.size());
+			ImGui::SetCursorPosX(columnEndX - (iconSize + spacing) * iconCount);
 
-			for (size_t i = 0; i < icons.size(); i++)
+			for (size_t i = 0; i < iconCount; i++)
 			{
 				ImGui::Image(icons[i].m_Texture, { iconSize, iconSize }, { 0, 0 }, { 1, 1 }, icons[i].m_Color);
 
@@ -334,65 +395,25 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 		ImGui::NextColumn();
 	}
 
-	// Kills column
-	{
-		if (playerName.empty())
-			ImGui::TextRightAligned("?");
-		else
-			ImGui::TextRightAlignedF("%u", player.GetScores().m_Kills);
-
-		ImGui::NextColumn();
-	}
-
-	// Deaths column
-	{
-		if (playerName.empty())
-			ImGui::TextRightAligned("?");
-		else
-			ImGui::TextRightAlignedF("%u", player.GetScores().m_Deaths);
-
-		ImGui::NextColumn();
-	}
-
-	// Connected time column
-	{
-		if (playerName.empty())
-		{
-			ImGui::TextRightAligned("?");
-		}
-		else
-		{
-			ImGui::TextRightAlignedF("%u:%02u",
-				std::chrono::duration_cast<std::chrono::minutes>(player.GetConnectedTime()).count(),
-				std::chrono::duration_cast<std::chrono::seconds>(player.GetConnectedTime()).count() % 60);
-		}
-
-		ImGui::NextColumn();
-	}
-
-	// Ping column
+	// Kills, deaths, connected time and ping columns
+	for (const auto& text : { model.m_Kills.view(), model.m_Deaths.view(), model.m_ConnectedTime.view(), model.m_Ping.view() })
 	{
-		if (playerName.empty())
-			ImGui::TextRightAligned("?");
-		else
-			ImGui::TextRightAlignedF("%u", player.GetPing());
-
+		ImGui::TextRightAligned(text);
 		ImGui::NextColumn();
 	}
 
 	// Steam ID column
 	{
-		const auto str = player.GetSteamID().str();
-		if (player.GetSteamID().Type != SteamAccountType::Invalid)
-			ImGui::TextFmt(ImGui::GetStyle().Colors[ImGuiCol_Text], str);
+		if (model.m_SteamIDValid)
+			ImGui::TextFmt(ImGui::GetStyle().Colors[ImGuiCol_Text], model.m_SteamID);
 		else
-			ImGui::TextFmt(str);
+			ImGui::TextFmt(model.m_SteamID);
 
 		ImGui::NextColumn();
 	}
 
 	if (shouldDrawPlayerTooltip)
-		DrawPlayerTooltip(player, teamShareResult, playerAttribs);
+		DrawPlayerTooltip(player, model.m_TeamShareResult, model.m_Attributes);
 }
 
 void MainWindow::OnDrawScoreboardContextMenu(IPlayer& player)
@@ -865,7 +886,9 @@ void MainWindow::DrawPlayerTooltipBody(IPlayer& player, TeamShareResult teamShar
 			})
 		.map([&](const std::shared_ptr<ITexture>& tex)
 			{
-				ImGui::Image((ImTextureID)(intptr_t)tex->GetHandle(), { 184, 184 });
+				const TextureRegion region = tex->GetRegion();
+				ImGui::Image((ImTextureID)(intptr_t)tex->GetHandle(), { 184, 184 },
+					{ region.m_U0, region.m_V0 }, { region.m_U1, region.m_V1 });
 			});
 
 	////////////////////////////////
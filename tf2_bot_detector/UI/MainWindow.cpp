@@ -4,6 +4,8 @@
 #include "Networking/GithubAPI.h"
 #include "Networking/SteamAPI.h"
 #include "ConsoleLog/NetworkStatus.h"
+#include "DB/TempDB.h"
+#include "EventJournal/EventJournal.h"
 #include "Platform/Platform.h"
 #include "ImGui_TF2BotDetector.h"
 #include "Actions/ActionGenerators.h"
@@ -35,9 +37,11 @@
 #include <mh/text/stringops.hpp>
 #include <srcon/async_client.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <filesystem>
+#include <numeric>
 #include <string>
 
 using namespace tf2_bot_detector;
@@ -73,7 +77,11 @@ MainWindow::MainWindow(ImGuiDesktop::Application& app) :
 
 	m_OpenTime = clock_t::now();
 
-	GetActionManager().AddPeriodicActionGenerator<StatusUpdateActionGenerator>();
+	{
+		auto statusUpdateGenerator = std::make_unique<StatusUpdateActionGenerator>(GetWorld());
+		m_StatusUpdateGenerator = statusUpdateGenerator.get();
+		GetActionManager().AddPeriodicActionGenerator(std::move(statusUpdateGenerator));
+	}
 	GetActionManager().AddPeriodicActionGenerator<ConfigActionGenerator>();
 	GetActionManager().AddPeriodicActionGenerator<LobbyDebugActionGenerator>();
 
@@ -176,20 +184,103 @@ void MainWindow::OnDrawChat()
 			{ "Friendlies", m_Settings.m_Theme.m_Colors.m_ChatLogFriendlyTeamFG },
 		});
 
+	if (!m_MainState)
+		return;
+
+	ConsoleHistory& history = m_MainState->m_ChatHistory;
+	history.SetCapacity(m_Settings.m_UIState.m_MainWindow.m_ChatHistoryLength);
+
+	if (ImGui::InputTextWithHint("##ChatFilter", "Search chat", &m_ChatFilter))
+	{
+		m_ChatFilterResults.clear();
+		m_ChatFilterNextID = 0;
+	}
+
+	if (!m_ChatFilter.empty())
+	{
+		// Only search records added since last frame, and forget about the ones that have fallen out of the history
+		history.Find(m_ChatFilter, m_ChatFilterResults, m_ChatFilterNextID);
+		m_ChatFilterNextID = history.GetNextID();
+		m_ChatFilterResults.erase(m_ChatFilterResults.begin(),
+			std::lower_bound(m_ChatFilterResults.begin(), m_ChatFilterResults.end(), history.GetFirstID()));
+	}
+
 	ImGui::AutoScrollBox("##fileContents", { 0, 0 }, [&]()
 		{
-			if (!m_MainState)
-				return;
-
 			ImGui::PushTextWrapPos();
 
+			// Heights depend on wrapping, so they have to be measured again if the window or font size changes
+			if (const float wrapWidth = ImGui::GetContentRegionAvail().x, fontSize = ImGui::GetFontSize();
+				wrapWidth != m_ChatHistoryWrapWidth || fontSize != m_ChatHistoryFontSize)
+			{
+				for (size_t i = 0; i < history.size(); i++)
+					history[i].m_DisplayHeight = 0;
+
+				m_ChatHistoryWrapWidth = wrapWidth;
+				m_ChatHistoryFontSize = fontSize;
+			}
+
+			// Only records that are on screen are drawn. The rest just take up the height they had the last
+			// time they were drawn (or one line if they never have been), so long histories stay cheap.
 			const IConsoleLine::PrintArgs args{ m_Settings, *m_WorldState, *this };
-			for (auto it = m_MainState->m_PrintingLines.rbegin(); it != m_MainState->m_PrintingLines.rend(); ++it)
+			const float defaultHeight = ImGui::GetTextLineHeightWithSpacing();
+			const float visibleMinY = ImGui::GetScrollY();
+			const float visibleMaxY = visibleMinY + ImGui::GetWindowHeight();
+			float y = ImGui::GetCursorPosY();
+
+			const auto DrawRecord = [&](ConsoleHistoryRecord& record)
+			{
+				const float height = record.m_DisplayHeight > 0 ? record.m_DisplayHeight : defaultHeight;
+				if ((y + height) < visibleMinY || y > visibleMaxY)
+				{
+					y += height;
+					return;
+				}
+
+				ImGui::SetCursorPosY(y);
+				ImGuiDesktop::ScopeGuards::ID id(int(record.m_ID));
+
+				switch (record.m_Type)
+				{
+				case ConsoleHistoryRecordType::Chat:
+					ChatConsoleLine::PrintMessage(ChatConsoleLine::MessageView
+						{
+							.m_PlayerName = history.GetName(record),
+							.m_Message = history.GetText(record),
+							.m_PlayerSteamID = record.m_SteamID,
+							.m_TeamShareResult = record.m_TeamShareResult,
+							.m_IsDead = record.m_IsDead,
+							.m_IsTeam = record.m_IsTeam,
+							.m_IsSelf = record.m_IsSelf,
+						}, args);
+					break;
+				case ConsoleHistoryRecordType::Separator:
+					ImGui::Separator();
+					break;
+				case ConsoleHistoryRecordType::Text:
+					ImGui::TextFmt(ImVec4(record.m_Color), history.GetText(record));
+					break;
+				}
+
+				record.m_DisplayHeight = ImGui::GetCursorPosY() - y;
+				y += record.m_DisplayHeight;
+			};
+
+			if (m_ChatFilter.empty())
 			{
-				assert(*it);
-				(*it)->Print(args);
+				for (size_t i = 0; i < history.size(); i++)
+					DrawRecord(history[i]);
+			}
+			else
+			{
+				for (uint64_t id : m_ChatFilterResults)
+				{
+					if (auto record = history.FindByID(id))
+						DrawRecord(*record);
+				}
 			}
 
+			ImGui::SetCursorPosY(y);
 			ImGui::PopTextWrapPos();
 		});
 }
@@ -454,11 +545,50 @@ void MainWindow::OnDrawServerStats()
 			}, (int)m_ServerPingSamples.size(), 0, nullptr, 0);
 	}
 
-	//OnDrawNetGraph();
+	OnDrawNetGraph();
+}
+
+void MainWindow::OnDrawNetGraph()
+{
+	const NetTelemetry& telemetry = GetWorld().GetNetTelemetry();
+	if (telemetry.GetNewestTime() == time_point_t{})
+		return;
+
+	const auto PlotMetric = [&](NetMetric metric, const char* label)
+	{
+		telemetry.Downsample(metric, 5min, m_NetGraphBuckets);
+
+		// net_status only runs every few seconds, so hold the last value across empty buckets
+		float lastValue = 0;
+		float maxValue = 0;
+		for (size_t i = 0; i < NET_GRAPH_POINTS; i++)
+		{
+			const NetTelemetryBucket& bucket = m_NetGraphBuckets[i];
+			if (!bucket.empty())
+			{
+				lastValue = bucket.GetAverage();
+				maxValue = std::max(maxValue, bucket.m_Max);
+			}
+
+			m_NetGraphValues[i] = lastValue;
+		}
+
+		ImGui::PlotLines(mh::fmtstr<64>("{}: {:.2f} (max {:.2f})", label, lastValue, maxValue).c_str(),
+			m_NetGraphValues.data(), int(m_NetGraphValues.size()), 0, nullptr, 0);
+	};
+
+	PlotMetric(NetMetric::InKBps, "In KB/s");
+	PlotMetric(NetMetric::OutKBps, "Out KB/s");
+	PlotMetric(NetMetric::InLatency, "In latency");
+	PlotMetric(NetMetric::OutLatency, "Out latency");
+	PlotMetric(NetMetric::InLossPercent, "In loss %");
 }
 
 void MainWindow::OnDraw()
 {
+	// Anything the scoreboard needs from the temp db goes through the async API
+	[[maybe_unused]] const DB::ScopedDisallowDBAccess noDBAccess;
+
 	ImGui::GetIO().FontDefault = GetFontPointer(m_Settings.m_Theme.m_Font);
 	ImGui::GetIO().FontGlobalScale = m_Settings.m_Theme.m_GlobalScale;
 
@@ -532,10 +662,37 @@ void MainWindow::OnDraw()
 
 		ImGui::TextFmt("FPS: {:1.1f}", GetFPS());
 
+		if (const size_t frameCount = std::min(m_FrameTimeCount, m_FrameTimes.size()); frameCount > 0)
+		{
+			std::array<float, std::tuple_size_v<decltype(m_FrameTimes)>> sorted;
+			std::copy_n(m_FrameTimes.begin(), frameCount, sorted.begin());
+			std::sort(sorted.begin(), sorted.begin() + frameCount);
+
+			const auto Percentile = [&](float p) { return sorted[size_t(p * (frameCount - 1))]; };
+			ImGui::TextFmt("Frame time (last {} frames): p50 {:1.1f}ms | p95 {:1.1f}ms | p99 {:1.1f}ms | max {:1.1f}ms",
+				frameCount, Percentile(0.5f), Percentile(0.95f), Percentile(0.99f), sorted[frameCount - 1]);
+		}
+
+		if (const size_t frameCount = std::min(m_ScoreboardTimeCount, m_ScoreboardTimes.size()); frameCount > 0)
+		{
+			const auto first = m_ScoreboardTimes.begin();
+			ImGui::TextFmt("Scoreboard build time (last {} frames): avg {:1.3f}ms | max {:1.3f}ms, {} rows, {} rebuilt last frame",
+				frameCount, std::accumulate(first, first + frameCount, 0.0f) / frameCount, *std::max_element(first, first + frameCount),
+				m_ScoreboardRows.size(), m_ScoreboardRowsRebuilt);
+		}
+
 		ImGui::Value("Texture Count", m_TextureManager->GetActiveTextureCount());
+		ImGui::TextFmt("Texture atlas pages: {}, cached textures: {:1.1f} MB, pending uploads: {}", m_TextureManager->GetAtlasPageCount(),
+			m_TextureManager->GetCachedTextureBytes() / 1024.0f / 1024, m_TextureManager->GetPendingUploadCount());
 
 		ImGui::TextFmt("RAM Usage: {:1.1f} MB", Platform::Processes::GetCurrentRAMUsage() / 1024.0f / 1024);
 
+		{
+			const ILogManager::QueueStats logStats = ILogManager::GetInstance().GetQueueStats();
+			ImGui::TextFmt(logStats.m_Dropped > 0 || logStats.m_Backpressured > 0 ? ImVec4{ 1, 0.5f, 0.5f, 1 } : ImVec4{ 1, 1, 1, 1 },
+				"Log queue: {} dropped, {} backpressured", logStats.m_Dropped, logStats.m_Backpressured);
+		}
+
 		if (auto client = m_Settings.GetHTTPClient())
 		{
 			const IHTTPClient::RequestCounts reqs = client->GetRequestCounts();
@@ -563,6 +720,26 @@ void MainWindow::OnDraw()
 		{
 			ImGui::TextFmt("HTTP Requests: HTTPClient Unavailable");
 		}
+
+		ImGui::TextFmt("Status poll interval: {:1.1f}s (last activity {:1.1f}s ago)",
+			to_seconds<float>(m_StatusUpdateGenerator->GetInterval()),
+			to_seconds<float>(m_StatusUpdateGenerator->GetTimeSinceActivity()));
+
+		if (ImGui::TreeNode("RCON Round Trip Times"))
+		{
+			for (const auto& [cmd, stats] : GetActionManager().GetRTTStats())
+			{
+				std::array<float, IRCONActionManager::CommandRTTStats::BUCKET_COUNT> buckets;
+				std::copy(stats.m_Buckets.begin(), stats.m_Buckets.end(), buckets.begin());
+
+				ImGui::PlotHistogram(mh::fmtstr<128>("{}", cmd).c_str(), buckets.data(), int(buckets.size()), 0,
+					mh::fmtstr<128>("{} samples, avg {:1.1f}ms, max {:1.1f}ms", stats.m_Count,
+						to_seconds(stats.GetAverageRTT()) * 1000, to_seconds(stats.m_MaxRTT) * 1000).c_str(),
+					0, FLT_MAX, { 0, 40 });
+			}
+
+			ImGui::TreePop();
+		}
 	}
 #endif
 
@@ -631,6 +808,15 @@ void MainWindow::OnDrawAllPanesDisabled()
 void MainWindow::OnEndFrame()
 {
 	m_TextureManager->EndFrame();
+
+	const auto now = std::chrono::steady_clock::now();
+	if (m_LastEndFrameTime != std::chrono::steady_clock::time_point{})
+	{
+		m_FrameTimes[m_FrameTimeCount % m_FrameTimes.size()] =
+			std::chrono::duration<float, std::milli>(now - m_LastEndFrameTime).count();
+		m_FrameTimeCount++;
+	}
+	m_LastEndFrameTime = now;
 }
 
 void MainWindow::OnDrawMenuBar()
@@ -774,6 +960,8 @@ void MainWindow::OnUpdate()
 	if (m_Settings.m_Unsaved.m_RCONClient)
 		m_Settings.m_Unsaved.m_RCONClient->set_logging(m_Settings.m_Logging.m_RCONPackets);
 
+	IEventJournal::GetInstance().SetEnabled(m_Settings.m_Logging.m_EventJournal);
+
 	if (m_SetupFlow.OnUpdate(m_Settings))
 	{
 		m_MainState.reset();
@@ -822,13 +1010,8 @@ void MainWindow::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 {
 	m_ParsedLineCount++;
 
-	if (parsed.ShouldPrint() && m_MainState)
-	{
-		while (m_MainState->m_PrintingLines.size() > m_MainState->MAX_PRINTING_LINES)
-			m_MainState->m_PrintingLines.pop_back();
-
-		m_MainState->m_PrintingLines.push_front(parsed.shared_from_this());
-	}
+	if (m_MainState)
+		m_MainState->m_ChatHistory.Add(parsed);
 
 	switch (parsed.GetType())
 	{
@@ -864,75 +1047,27 @@ void MainWindow::OnConsoleLineUnparsed(IWorldState& world, const std::string_vie
 
 mh::generator<IPlayer&> MainWindow::PostSetupFlowState::GeneratePlayerPrintData()
 {
-	IPlayer* printData[33]{};
-	auto begin = std::begin(printData);
-	auto end = std::end(printData);
-	assert(begin <= end);
+	// Community servers can have a lot more players than a 12v12 lobby, so this isn't a fixed size array
+	std::vector<IPlayer*> printData;
 	auto& world = m_Parent->m_WorldState;
-	assert(static_cast<size_t>(end - begin) >= world->GetApproxLobbyMemberCount());
-
-	std::fill(begin, end, nullptr);
+	printData.reserve(world->GetApproxLobbyMemberCount());
 
 	{
-		auto* current = begin;
 		for (IPlayer& member : world->GetLobbyMembers())
-		{
-			*current = &member;
-			current++;
-		}
+			printData.push_back(&member);
 
-		if (current == begin)
+		if (printData.empty())
 		{
 			// We seem to have either an empty lobby or we're playing on a community server.
 			// Just find the most recent status updates.
-			for (IPlayer& playerData : world->GetPlayers())
-			{
-				if (playerData.GetLastStatusUpdateTime() >= (world->GetLastStatusUpdateTime() - 15s))
-				{
-					*current = &playerData;
-					current++;
-
-					if (current >= end)
-						break; // This might happen, but we're not in a lobby so everything has to be approximate
-				}
-			}
+			world->FindPlayersUpdatedSince(world->GetLastStatusUpdateTime() - 15s, printData);
 		}
-
-		end = current;
 	}
 
-	std::sort(begin, end, [](const IPlayer* lhs, const IPlayer* rhs) -> bool
-		{
-			assert(lhs);
-			assert(rhs);
-			//if (!lhs && !rhs)
-			//	return false;
-			//if (auto result = !!rhs <=> !!lhs; !std::is_eq(result))
-			//	return result < 0;
-
-			// Intentionally reversed, we want descending kill order
-			if (auto killsResult = rhs->GetScores().m_Kills <=> lhs->GetScores().m_Kills; !std::is_eq(killsResult))
-				return std::is_lt(killsResult);
-
-			if (auto deathsResult = lhs->GetScores().m_Deaths <=> rhs->GetScores().m_Deaths; !std::is_eq(deathsResult))
-				return std::is_lt(deathsResult);
-
-			// Sort by ascending userid
-			{
-				auto luid = lhs->GetUserID();
-				auto ruid = rhs->GetUserID();
-				if (luid && ruid)
-				{
-					if (auto result = *luid <=> *ruid; !std::is_eq(result))
-						return std::is_lt(result);
-				}
-			}
+	world->SortPlayersByScore(printData);
 
-			return false;
-		});
-
-	for (auto it = begin; it != end; ++it)
-		co_yield **it;
+	for (IPlayer* player : printData)
+		co_yield *player;
 }
 
 void MainWindow::UpdateServerPing(time_point_t timestamp)
@@ -995,7 +1130,12 @@ mh::expected<std::shared_ptr<ITexture>, std::error_condition> MainWindow::TryGet
 	{
 		StateTask_t m_State;
 
-		static StateTask_t LoadAvatarAsync(mh::task<Bitmap> avatarBitmapTask,
+		static StateTask_t GetCachedAvatar(std::shared_ptr<ITexture> texture)
+		{
+			co_return texture;
+		}
+
+		static StateTask_t LoadAvatarAsync(mh::task<Bitmap> avatarBitmapTask, std::string avatarHash,
 			mh::dispatcher updateDispatcher, std::shared_ptr<ITextureManager> textureManager)
 		{
 			const Bitmap* avatarBitmap = nullptr;
@@ -1015,7 +1155,13 @@ mh::expected<std::shared_ptr<ITexture>, std::error_condition> MainWindow::TryGet
 
 			try
 			{
-				co_return textureManager->CreateTexture(*avatarBitmap);
+				// Someone else with the same avatar might have beaten us to it
+				if (auto cached = textureManager->FindCachedTexture(avatarHash))
+					co_return cached;
+
+				auto texture = textureManager->CreateAtlasTexture(*avatarBitmap);
+				textureManager->AddCachedTexture(std::move(avatarHash), texture);
+				co_return texture;
 			}
 			catch (...)
 			{
@@ -1033,9 +1179,17 @@ mh::expected<std::shared_ptr<ITexture>, std::error_condition> MainWindow::TryGet
 		const auto& summary = playerPtr->GetPlayerSummary();
 		if (summary)
 		{
-			avatarData = PlayerAvatarData::LoadAvatarAsync(
-				summary->GetAvatarBitmap(m_Settings.GetHTTPClient()),
-				GetDispatcher(), m_TextureManager);
+			// Avatars are content-addressed, and lots of players (especially bots) share the same one
+			if (auto cached = m_TextureManager->FindCachedTexture(summary->m_AvatarHash))
+			{
+				avatarData = PlayerAvatarData::GetCachedAvatar(std::move(cached));
+			}
+			else
+			{
+				avatarData = PlayerAvatarData::LoadAvatarAsync(
+					summary->GetAvatarBitmap(m_Settings.GetHTTPClient()), summary->m_AvatarHash,
+					GetDispatcher(), m_TextureManager);
+			}
 		}
 		else
 		{
@@ -1044,15 +1198,24 @@ mh::expected<std::shared_ptr<ITexture>, std::error_condition> MainWindow::TryGet
 	}
 
 	if (auto data = avatarData.try_get())
+	{
+		// Uploads to the GPU are spread out over several frames
+		if (data->has_value() && !data->value()->IsLoaded())
+			return std::errc::operation_in_progress;
+
 		return *data;
+	}
 	else
+	{
 		return std::errc::operation_in_progress;
+	}
 }
 
 MainWindow::PostSetupFlowState::PostSetupFlowState(MainWindow& window) :
 	m_Parent(&window),
 	m_ModeratorLogic(IModeratorLogic::Create(window.GetWorld(), window.m_Settings, window.GetActionManager())),
 	m_SponsorsList(window.m_Settings),
+	m_ChatHistory(window.m_Settings.m_UIState.m_MainWindow.m_ChatHistoryLength),
 	m_Parser(window.GetWorld(), window.m_Settings, window.m_Settings.GetTFDir() / "console.log")
 {
 #ifdef TF2BD_ENABLE_DISCORD_INTEGRATION
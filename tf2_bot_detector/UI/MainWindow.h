@@ -4,8 +4,10 @@
 #include "Actions/RCONActionManager.h"
 #include "Clock.h"
 #include "CompensatedTS.h"
+#include "ConsoleLog/ConsoleHistory.h"
 #include "ConsoleLog/ConsoleLineListener.h"
 #include "ConsoleLog/ConsoleLogParser.h"
+#include "ConsoleLog/NetTelemetry.h"
 #include "Config/PlayerListJSON.h"
 #include "Config/Settings.h"
 #include "Config/SponsorsList.h"
@@ -21,7 +23,10 @@
 
 #include <imgui_desktop/Window.h>
 #include <mh/error/expected.hpp>
+#include <mh/text/fmtstr.hpp>
 
+#include <array>
+#include <chrono>
 #include <optional>
 #include <vector>
 
@@ -37,6 +42,7 @@ namespace tf2_bot_detector
 	class ITextureManager;
 	class IUpdateManager;
 	class SettingsWindow;
+	class StatusUpdateActionGenerator;
 
 	class MainWindow final : public ImGuiDesktop::Window, IConsoleLineListener, BaseWorldEventListener
 	{
@@ -63,9 +69,55 @@ namespace tf2_bot_detector
 		void OnDrawAllPanesDisabled();
 		void OnDrawScoreboardContextMenu(IPlayer& player);
 		void OnDrawScoreboardRow(IPlayer& player);
+
+		// Everything in a scoreboard row that is too expensive to look up every frame. Colors are
+		// still resolved while drawing so the theme color pickers apply immediately.
+		struct ScoreboardRowModel final
+		{
+			uint32_t m_WorldGeneration = 0;
+			uint32_t m_AttributesGeneration = 0;
+			bool m_HasSummary = false;
+			bool m_HasBans = false;
+			std::chrono::steady_clock::time_point m_BuildTime{};
+
+			TeamShareResult m_TeamShareResult{};
+			TFTeam m_Team{};
+			PlayerMarks m_Attributes;
+			std::optional<PlayerAttribute> m_HighlightAttribute;
+
+			bool m_IsConnecting = false;
+			bool m_IsLocalPlayer = false;
+			bool m_VACBanned = false;
+			bool m_GameBanned = false;
+			bool m_IsFriend = false;
+
+			mh::fmtstr<32> m_UserID;
+			std::string m_Name;
+			std::string m_MismatchedSteamName;
+			mh::fmtstr<16> m_Kills;
+			mh::fmtstr<16> m_Deaths;
+			mh::fmtstr<16> m_ConnectedTime;
+			mh::fmtstr<16> m_Ping;
+			mh::fmtstr<32> m_SteamID;
+			bool m_SteamIDValid = false;
+		};
+		const ScoreboardRowModel& GetScoreboardRowModel(IPlayer& player);
+		uint32_t m_ScoreboardGeneration = 0;  // Bumped by world events that can affect any row
+		std::vector<IPlayer*> m_ScoreboardRows;
+
+		// Per-frame CPU time spent in OnDrawScoreboard, in ms
+		std::array<float, 120> m_ScoreboardTimes{};
+		size_t m_ScoreboardTimeCount = 0;
+		size_t m_ScoreboardRowsRebuilt = 0;
 		void OnDrawColorPicker(const char* name_id, std::array<float, 4>& color);
 		void OnDrawChat();
+		std::string m_ChatFilter;
+		std::vector<uint64_t> m_ChatFilterResults;  // ConsoleHistory IDs
+		uint64_t m_ChatFilterNextID = 0;            // Everything before this has already been searched
+		float m_ChatHistoryWrapWidth = 0;           // What the cached record heights were measured with
+		float m_ChatHistoryFontSize = 0;
 		void OnDrawServerStats();
+		void OnDrawNetGraph();
 		void DrawPlayerTooltipBody(IPlayer& player, TeamShareResult teamShareResult, const PlayerMarks& playerAttribs);
 
 		struct ColorPicker
@@ -112,6 +164,9 @@ namespace tf2_bot_detector
 		// IWorldEventListener
 		//void OnChatMsg(WorldState& world, const IPlayer& player, const std::string_view& msg) override;
 		//void OnUpdate(WorldState& world, bool consoleLinesUpdated) override;
+		void OnPlayerStatusUpdate(IWorldState& world, const IPlayer& player) override { m_ScoreboardGeneration++; }
+		void OnPlayerDroppedFromServer(IWorldState& world, IPlayer& player, const std::string_view& reason) override { m_ScoreboardGeneration++; }
+		void OnLocalPlayerInitialized(IWorldState& world, bool initialized) override { m_ScoreboardGeneration++; }
 
 		bool m_Paused = false;
 
@@ -152,8 +207,18 @@ namespace tf2_bot_detector
 		};
 		std::vector<EdictUsageSample> m_EdictUsageSamples;
 
+		// Scratch space for OnDrawNetGraph(), so drawing it doesn't allocate every frame
+		static constexpr size_t NET_GRAPH_POINTS = 300;
+		std::vector<NetTelemetryBucket> m_NetGraphBuckets = std::vector<NetTelemetryBucket>(NET_GRAPH_POINTS);
+		std::array<float, NET_GRAPH_POINTS> m_NetGraphValues{};
+
 		time_point_t m_OpenTime;
 
+		// Recent frame times in ms, for spotting hitches in the debug window
+		std::array<float, 600> m_FrameTimes{};
+		size_t m_FrameTimeCount = 0;
+		std::chrono::steady_clock::time_point m_LastEndFrameTime{};
+
 		void UpdateServerPing(time_point_t timestamp);
 		std::vector<PingSample> m_ServerPingSamples;
 		time_point_t m_LastServerPingSample{};
@@ -167,6 +232,7 @@ namespace tf2_bot_detector
 
 		std::shared_ptr<IWorldState> m_WorldState;
 		std::unique_ptr<IRCONActionManager> m_ActionManager;
+		const StatusUpdateActionGenerator* m_StatusUpdateGenerator = nullptr; // Owned by m_ActionManager
 
 		IWorldState& GetWorld() { return *m_WorldState; }
 		const IWorldState& GetWorld() const { return *m_WorldState; }
@@ -182,8 +248,7 @@ namespace tf2_bot_detector
 			SponsorsList m_SponsorsList;
 
 			ConsoleLogParser m_Parser;
-			std::list<std::shared_ptr<const IConsoleLine>> m_PrintingLines;  // newest to oldest order
-			static constexpr size_t MAX_PRINTING_LINES = 512;
+			ConsoleHistory m_ChatHistory;
 			mh::generator<IPlayer&> GeneratePlayerPrintData();
 
 			void OnUpdateDiscord();
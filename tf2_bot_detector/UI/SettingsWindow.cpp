@@ -1,6 +1,7 @@
 #include "SettingsWindow.h"
 #include "ImGui_TF2BotDetector.h"
 #include "Config/Settings.h"
+#include "ConsoleLog/ConsoleHistory.h"
 #include "SetupFlow/AddonManagerPage.h"
 #include "UI/MainWindow.h"
 #include "Util/PathUtils.h"
@@ -8,6 +9,8 @@
 #include <mh/algorithm/algorithm.hpp>
 #include <mh/error/ensure.hpp>
 
+#include <algorithm>
+
 using namespace tf2_bot_detector;
 
 SettingsWindow::SettingsWindow(ImGuiDesktop::Application& app, Settings& settings, MainWindow& mainWindow) :
@@ -78,6 +81,9 @@ void SettingsWindow::OnDrawLoggingSettings()
 #endif
 		if (ImGui::Checkbox("RCON Packets", &m_Settings.m_Logging.m_RCONPackets))
 			m_Settings.SaveFile();
+		if (ImGui::Checkbox("Event Journal", &m_Settings.m_Logging.m_EventJournal))
+			m_Settings.SaveFile();
+		ImGui::SetHoverTooltip("Records console lines, rule matches, marks, votekicks and API requests to a compact binary journal in the logs folder. Search it with tf2bd_logq.");
 
 		ImGui::NewLine();
 		ImGui::TreePop();
@@ -163,6 +169,17 @@ void SettingsWindow::OnDrawPerformanceSettings()
 			ImGui::SetHoverTooltip("Slows program refresh rate when not focused to reduce CPU/GPU usage.");
 		}
 
+		// Chat history length
+		{
+			auto& historyLength = m_Settings.m_UIState.m_MainWindow.m_ChatHistoryLength;
+			if (int length = int(historyLength); ImGui::InputInt("Chat history length", &length, 256, 4096))
+			{
+				historyLength = uint32_t(std::clamp<int>(length, ConsoleHistory::MIN_CAPACITY, ConsoleHistory::MAX_CAPACITY));
+				m_Settings.SaveFile();
+			}
+			ImGui::SetHoverTooltip("How many chat messages are kept in the chat window. Memory usage is fixed by this number, not by how much is actually said.");
+		}
+
 		ImGui::NewLine();
 		ImGui::TreePop();
 	}
@@ -0,0 +1,313 @@
+#include "UpdateDownload.h"
+#include "Networking/HTTPClient.h"
+#include "Networking/HTTPHelpers.h"
+#include "Util/BinaryPatch.h"
+#include "Util/JSONUtils.h"
+#include "Log.h"
+#include "UpdateManifest.h"
+
+#include <libzippp/libzippp.h>
+#include <mh/raii/scope_exit.hpp>
+#include <mh/text/format.hpp>
+#include <mh/utility.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <execution>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	// Downloaded from BuildVariant::m_ManifestURL
+	struct ReleaseManifest
+	{
+		struct Patch
+		{
+			std::string m_FromSHA256;
+			std::string m_DownloadURL;
+		};
+
+		struct File
+		{
+			std::filesystem::path m_Path;
+			uint64_t m_Size = 0;
+			std::string m_SHA256;
+			std::string m_DownloadURL;
+
+			// Optional, from specific older versions of this file. See ApplyBinaryPatch().
+			std::vector<Patch> m_Patches;
+		};
+
+		std::vector<File> m_Files;
+	};
+
+	void from_json(const nlohmann::json& j, ReleaseManifest::Patch& d)
+	{
+		d.m_FromSHA256 = j.at("from_sha256");
+		d.m_DownloadURL = j.at("download_url");
+	}
+	void from_json(const nlohmann::json& j, ReleaseManifest::File& d)
+	{
+		const auto path = j.at("path").get<std::string>();
+		d.m_Path = std::u8string(path.begin(), path.end());
+		if (!IsValidUpdateManifestPath(d.m_Path))
+			throw std::invalid_argument(mh::format("Invalid path in release manifest: {}", d.m_Path));
+
+		d.m_Size = j.at("size");
+		d.m_SHA256 = j.at("sha256");
+		d.m_DownloadURL = j.at("download_url");
+		try_get_to_defaulted(j, d.m_Patches, "patches");
+	}
+	void from_json(const nlohmann::json& j, ReleaseManifest& d)
+	{
+		j.at("files").get_to(d.m_Files);
+	}
+
+	static void SaveFile(const std::filesystem::path& path, const void* dataBegin, const void* dataEnd)
+	{
+		std::filesystem::create_directories(mh::copy(path).remove_filename());
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.exceptions(std::ios::badbit | std::ios::failbit);
+		file.write(reinterpret_cast<const char*>(dataBegin),
+			static_cast<const std::byte*>(dataEnd) - static_cast<const std::byte*>(dataBegin));
+	}
+
+	static void ExtractArchive(const libzippp::ZipArchive& archive, const std::filesystem::path& directory)
+	{
+		try
+		{
+			std::filesystem::create_directories(directory);
+		}
+		catch (...)
+		{
+			std::throw_with_nested(std::runtime_error(mh::format("{}: Failed to create directory(s) for {}",
+				MH_SOURCE_LOCATION_CURRENT(), directory)));
+		}
+
+		try
+		{
+			for (const auto& entry : archive.getEntries())
+			{
+				const std::filesystem::path path = directory / entry.getName();
+				if (!entry.isFile())
+					continue;
+
+				std::filesystem::create_directories(mh::copy(path).remove_filename());
+
+				std::ofstream file(path, std::ios::binary);
+				file.exceptions(std::ios::badbit | std::ios::failbit);
+
+				const auto result = entry.readContent(file);
+				if (result != LIBZIPPP_OK)
+				{
+					throw std::runtime_error(mh::format("{}: entry.readContent() returned {}",
+						MH_SOURCE_LOCATION_CURRENT(), result));
+				}
+			}
+		}
+		catch (...)
+		{
+			std::throw_with_nested(std::runtime_error(mh::format("{}: Failed to extract archive entries",
+				MH_SOURCE_LOCATION_CURRENT())));
+		}
+	}
+
+	static std::string ReadBinaryFile(const std::filesystem::path& path)
+	{
+		std::ifstream file;
+		file.exceptions(std::ios::badbit | std::ios::failbit);
+		file.open(path, std::ios::binary);
+
+		file.seekg(0, std::ios::end);
+		std::string retVal(static_cast<size_t>(file.tellg()), '\0');
+		file.seekg(0, std::ios::beg);
+		file.read(retVal.data(), retVal.size());
+		return retVal;
+	}
+
+	static std::string HashInstalledFile(const std::filesystem::path& installDir, const ReleaseManifest::File& file)
+	{
+		const auto path = installDir / file.m_Path;
+
+		// If the size is different, the only reason to hash it is to see if we have a patch for it
+		std::error_code ec;
+		const auto size = std::filesystem::file_size(path, ec);
+		if (ec || (size != file.m_Size && file.m_Patches.empty()))
+			return {};
+
+		try
+		{
+			return HashFileSHA256(path);
+		}
+		catch (...)
+		{
+			DebugLogException(MH_SOURCE_LOCATION_CURRENT(), "Failed to hash {}", path);
+			return {};
+		}
+	}
+
+	static std::optional<std::string> DownloadPatchedFile(const IHTTPClient& client,
+		const std::filesystem::path& installDir, const ReleaseManifest::File& file, const std::string& installedHash,
+		uint64_t& downloadedBytes)
+	{
+		auto patch = std::find_if(file.m_Patches.begin(), file.m_Patches.end(),
+			[&](const ReleaseManifest::Patch& p) { return p.m_FromSHA256 == installedHash; });
+		if (installedHash.empty() || patch == file.m_Patches.end())
+			return std::nullopt;
+
+		try
+		{
+			const auto patchData = client.GetString(patch->m_DownloadURL);
+			downloadedBytes += patchData.size();
+
+			auto data = ApplyBinaryPatch(ReadBinaryFile(installDir / file.m_Path), patchData);
+			if (HashSHA256(data) == file.m_SHA256)
+				return data;
+
+			LogWarning(MH_SOURCE_LOCATION_CURRENT(), "Patching {} produced the wrong hash, downloading the whole file instead",
+				file.m_Path);
+		}
+		catch (...)
+		{
+			LogException(MH_SOURCE_LOCATION_CURRENT(), "Failed to patch {}, downloading the whole file instead",
+				file.m_Path);
+		}
+
+		return std::nullopt;
+	}
+}
+
+void tf2_bot_detector::DownloadDelta(const IHTTPClient& client, const URL& manifestURL,
+	const std::filesystem::path& installDir, const std::filesystem::path& cacheDir,
+	const std::filesystem::path& extractDir)
+{
+	Log(MH_SOURCE_LOCATION_CURRENT(), "Downloading release manifest {}...", manifestURL);
+	const auto manifest = nlohmann::json::parse(client.GetString(manifestURL)).get<ReleaseManifest>();
+
+	// Mostly waiting on the disk
+	std::vector<std::string> installedHashes(manifest.m_Files.size());
+	std::transform(std::execution::par, manifest.m_Files.begin(), manifest.m_Files.end(), installedHashes.begin(),
+		[&](const ReleaseManifest::File& file) { return HashInstalledFile(installDir, file); });
+
+	std::filesystem::create_directories(cacheDir);
+	std::filesystem::create_directories(extractDir);
+
+	std::vector<UpdateManifestEntry> changedFiles;
+	uint64_t downloadedBytes = 0;
+	uint64_t resumedFiles = 0;
+
+	for (size_t i = 0; i < manifest.m_Files.size(); i++)
+	{
+		const auto& file = manifest.m_Files[i];
+		if (installedHashes[i] == file.m_SHA256)
+			continue;
+
+		const auto cachedPath = cacheDir / file.m_SHA256;
+		if (std::error_code ec; std::filesystem::exists(cachedPath, ec) && HashFileSHA256(cachedPath) == file.m_SHA256)
+		{
+			resumedFiles++;
+		}
+		else
+		{
+			auto data = DownloadPatchedFile(client, installDir, file, installedHashes[i], downloadedBytes);
+			if (!data)
+			{
+				DebugLog(MH_SOURCE_LOCATION_CURRENT(), "Downloading {}...", file.m_DownloadURL);
+				data = client.GetString(file.m_DownloadURL);
+				downloadedBytes += data->size();
+
+				if (const auto hash = HashSHA256(*data); hash != file.m_SHA256)
+				{
+					throw std::runtime_error(mh::format("{}: Downloaded {} has hash {}, expected {}",
+						MH_SOURCE_LOCATION_CURRENT(), file.m_DownloadURL, hash, file.m_SHA256));
+				}
+			}
+
+			// Written under a temporary name, a file in the cache is always complete
+			auto tempPath = cachedPath;
+			tempPath += ".tmp";
+			SaveFile(tempPath, data->data(), data->data() + data->size());
+			std::filesystem::rename(tempPath, cachedPath);
+		}
+
+		// Copied rather than moved, more than one file in the build might have the same contents
+		const auto destPath = extractDir / file.m_Path;
+		std::filesystem::create_directories(mh::copy(destPath).remove_filename());
+		std::filesystem::copy_file(cachedPath, destPath, std::filesystem::copy_options::overwrite_existing);
+
+		changedFiles.push_back({ file.m_Path, file.m_SHA256 });
+	}
+
+	WriteUpdateManifest(extractDir / UPDATE_MANIFEST_FILENAME, changedFiles);
+
+	Log(MH_SOURCE_LOCATION_CURRENT(), "{} of {} files changed ({} already downloaded), downloaded {} bytes",
+		changedFiles.size(), manifest.m_Files.size(), resumedFiles, downloadedBytes);
+
+	for (const auto& file : changedFiles)
+	{
+		std::error_code ec;
+		std::filesystem::remove(cacheDir / file.m_SHA256, ec);
+	}
+}
+
+void tf2_bot_detector::DownloadAndExtractZip(const IHTTPClient& client, const URL& url,
+	const std::filesystem::path& extractDir)
+{
+	Log(MH_SOURCE_LOCATION_CURRENT(), "{} -> {}", url, extractDir);
+
+	DebugLog(MH_SOURCE_LOCATION_CURRENT(), "Downloading {}...", url);
+	const auto data = client.GetString(url);
+
+	// Need to save to a file due to a libzippp bug in ZipArchive::fromBuffer
+	const auto tempZipPath = mh::copy(extractDir).replace_extension(".zip");
+	Log(MH_SOURCE_LOCATION_CURRENT(), "Saving zip to {}...", tempZipPath);
+
+	mh::scope_exit scopeExit([&]
+		{
+			Log(MH_SOURCE_LOCATION_CURRENT(), "Deleting {}...", tempZipPath);
+			std::filesystem::remove(tempZipPath);
+		});
+
+	SaveFile(tempZipPath, data.data(), data.data() + data.size());
+
+	{
+		using namespace libzippp;
+		Log(MH_SOURCE_LOCATION_CURRENT(), "Extracting {} to {}...", tempZipPath, extractDir);
+		ZipArchive archive(tempZipPath.string());
+		archive.open();
+		ExtractArchive(archive, extractDir);
+	}
+}
+
+void tf2_bot_detector::DownloadPortableBuild(const IHTTPClient& client, const std::string& manifestURL, const std::string& zipURL,
+	const std::filesystem::path& installDir, const std::filesystem::path& cacheDir,
+	const std::filesystem::path& extractDir)
+{
+	if (!manifestURL.empty())
+	{
+		try
+		{
+			DownloadDelta(client, manifestURL, installDir, cacheDir, extractDir);
+			return;
+		}
+		catch (...)
+		{
+			LogException(MH_SOURCE_LOCATION_CURRENT(), "Failed to download delta update, downloading the full build instead");
+
+			std::error_code ec;
+			std::filesystem::remove_all(extractDir, ec);
+		}
+	}
+
+	DownloadAndExtractZip(client, zipURL, extractDir);
+
+	// Lets the update tool check that it copied everything correctly
+	WriteUpdateManifest(extractDir / UPDATE_MANIFEST_FILENAME, CreateUpdateManifest(extractDir));
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace tf2_bot_detector
+{
+	class IHTTPClient;
+	class URL;
+
+	// Downloads only the files that differ from the ones in installDir to extractDir, along with an update
+	// manifest listing them for the update tool. Files with a patch from the installed version are patched
+	// and checked against their hash, falling back to downloading the whole file. Each file goes to cacheDir
+	// (named after its hash) first, so if this is interrupted, the next attempt only downloads the files
+	// that hadn't finished yet.
+	//
+	// Throws if the release manifest can't be read, or a downloaded file has the wrong hash.
+	void DownloadDelta(const IHTTPClient& client, const URL& manifestURL, const std::filesystem::path& installDir,
+		const std::filesystem::path& cacheDir, const std::filesystem::path& extractDir);
+
+	void DownloadAndExtractZip(const IHTTPClient& client, const URL& url, const std::filesystem::path& extractDir);
+
+	// DownloadDelta() if manifestURL isn't empty, and the whole zip from zipURL if there isn't or that fails.
+	// Either way, extractDir ends up with the files to install and an update manifest to check them against.
+	void DownloadPortableBuild(const IHTTPClient& client, const std::string& manifestURL, const std::string& zipURL,
+		const std::filesystem::path& installDir, const std::filesystem::path& cacheDir,
+		const std::filesystem::path& extractDir);
+}
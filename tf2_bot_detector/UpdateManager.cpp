@@ -8,20 +8,19 @@
 #include "Log.h"
 #include "ReleaseChannel.h"
 #include "Filesystem.h"
+#include "UpdateDownload.h"
 
-#include <libzippp/libzippp.h>
 #include <mh/algorithm/multi_compare.hpp>
 #include <mh/future.hpp>
 #include <mh/error/exception_details.hpp>
-#include <mh/raii/scope_exit.hpp>
 #include <mh/text/fmtstr.hpp>
 #include <mh/types/disable_copy_move.hpp>
 #include <mh/utility.hpp>
 #include <mh/variant.hpp>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <compare>
-#include <fstream>
 #include <variant>
 
 using namespace std::string_view_literals;
@@ -55,12 +54,16 @@ namespace tf2_bot_detector
 			{ "arch", d.m_Arch },
 			{ "download_url", d.m_DownloadURL },
 		};
+
+		if (!d.m_ManifestURL.empty())
+			j["manifest_url"] = d.m_ManifestURL;
 	}
 	void from_json(const nlohmann::json& j, BuildInfo::BuildVariant& d)
 	{
 		d.m_OS = j.at("os");
 		d.m_Arch = j.at("arch");
 		d.m_DownloadURL = j.at("download_url");
+		try_get_to_defaulted(j, d.m_ManifestURL, "manifest_url");
 	}
 
 	void to_json(nlohmann::json& j, const BuildInfo& d)
@@ -245,13 +248,21 @@ namespace
 
 		bool CanReplaceUpdateCheckState() const;
 
+		// Not IFilesystem::GetTempDir(), which is inside the install in portable mode. The update tool
+		// runs from here, and the install directory can't be swapped out while it is.
 		const std::filesystem::path DOWNLOAD_DIR_ROOT =
-			IFilesystem::Get().GetTempDir() / "Portable Updates";
+			Platform::GetRootTempDataDir() / "TF2 Bot Detector" / "Portable Updates";
+
+		// Files for delta updates are kept here until the whole update has been downloaded, so an
+		// interrupted download can pick up where it left off.
+		const std::filesystem::path DELTA_CACHE_DIR =
+			Platform::GetRootTempDataDir() / "TF2 Bot Detector" / "Portable Update Cache";
 
 		void CleanupOldUpdates() const;
 
 		static std::future<std::optional<DownloadedBuild>> DownloadBuild(const HTTPClient& client,
-			BuildInfo::BuildVariant tool, BuildInfo::BuildVariant updater, std::filesystem::path downloadDirRoot);
+			BuildInfo::BuildVariant tool, BuildInfo::BuildVariant updater, std::filesystem::path downloadDirRoot,
+			std::filesystem::path deltaCacheDir);
 		static std::future<std::optional<DownloadedUpdateTool>> DownloadUpdateTool(const HTTPClient& client,
 			BuildInfo::BuildVariant updater, std::string args, std::filesystem::path downloadDirRoot);
 		static std::future<std::optional<UpdateToolResult>> RunUpdateTool(std::filesystem::path path, std::string args);
@@ -497,85 +508,6 @@ namespace
 		return false;
 	}
 
-	static void SaveFile(const std::filesystem::path& path, const void* dataBegin, const void* dataEnd)
-	{
-		std::filesystem::create_directories(mh::copy(path).remove_filename());
-
-		std::ofstream file(path, std::ios::binary | std::ios::trunc);
-		file.exceptions(std::ios::badbit | std::ios::failbit);
-		file.write(reinterpret_cast<const char*>(dataBegin),
-			static_cast<const std::byte*>(dataEnd) - static_cast<const std::byte*>(dataBegin));
-	}
-
-	static void ExtractArchive(const libzippp::ZipArchive& archive, const std::filesystem::path& directory)
-	{
-		try
-		{
-			std::filesystem::create_directories(directory);
-		}
-		catch (...)
-		{
-			std::throw_with_nested(std::runtime_error(mh::format("{}: Failed to create directory(s) for {}",
-				MH_SOURCE_LOCATION_CURRENT(), directory)));
-		}
-
-		try
-		{
-			for (const auto& entry : archive.getEntries())
-			{
-				const std::filesystem::path path = directory / entry.getName();
-				if (!entry.isFile())
-					continue;
-
-				std::filesystem::create_directories(mh::copy(path).remove_filename());
-
-				std::ofstream file(path, std::ios::binary);
-				file.exceptions(std::ios::badbit | std::ios::failbit);
-
-				const auto result = entry.readContent(file);
-				if (result != LIBZIPPP_OK)
-				{
-					throw std::runtime_error(mh::format("{}: entry.readContent() returned {}",
-						MH_SOURCE_LOCATION_CURRENT(), result));
-				}
-			}
-		}
-		catch (...)
-		{
-			std::throw_with_nested(std::runtime_error(mh::format("{}: Failed to extract archive entries",
-				MH_SOURCE_LOCATION_CURRENT())));
-		}
-	}
-
-	static void DownloadAndExtractZip(const HTTPClient& client, const URL& url,
-		const std::filesystem::path& extractDir)
-	{
-		Log(MH_SOURCE_LOCATION_CURRENT(), "{} -> {}", url, extractDir);
-
-		DebugLog(MH_SOURCE_LOCATION_CURRENT(), "Downloading {}...", url);
-		const auto data = client.GetString(url);
-
-		// Need to save to a file due to a libzippp bug in ZipArchive::fromBuffer
-		const auto tempZipPath = mh::copy(extractDir).replace_extension(".zip");
-		Log(MH_SOURCE_LOCATION_CURRENT(), "Saving zip to {}...", tempZipPath);
-
-		mh::scope_exit scopeExit([&]
-			{
-				Log(MH_SOURCE_LOCATION_CURRENT(), "Deleting {}...", tempZipPath);
-				std::filesystem::remove(tempZipPath);
-			});
-
-		SaveFile(tempZipPath, data.data(), data.data() + data.size());
-
-		{
-			using namespace libzippp;
-			Log(MH_SOURCE_LOCATION_CURRENT(), "Extracting {} to {}...", tempZipPath, extractDir);
-			ZipArchive archive(tempZipPath.string());
-			archive.open();
-			ExtractArchive(archive, extractDir);
-		}
-	}
-
 	void UpdateManager::CleanupOldUpdates() const
 	{
 		DebugLog(MH_SOURCE_LOCATION_CURRENT(), "Cleaning up old downloaded updates from {}...", DOWNLOAD_DIR_ROOT);
@@ -596,19 +528,31 @@ namespace
 		{
 			Log(MH_SOURCE_LOCATION_CURRENT(), "Deleted {} items from {}.", deletedCount, DOWNLOAD_DIR_ROOT);
 		}
+
+		// The delta cache is supposed to survive restarts, but not forever. Leftover temp files are from
+		// downloads that were interrupted partway through and are no use to anyone.
+		const auto cacheExpiryTime = std::filesystem::file_time_type::clock::now() - std::chrono::hours(24 * 7);
+		std::error_code cacheEC;
+		for (const auto& entry : std::filesystem::directory_iterator(DELTA_CACHE_DIR, cacheEC))
+		{
+			std::error_code ec;
+			if (entry.path().extension() == ".tmp" || entry.last_write_time(ec) < cacheExpiryTime)
+				std::filesystem::remove(entry.path(), ec);
+		}
 	}
 
 	auto UpdateManager::DownloadBuild(const HTTPClient& client,
-		BuildInfo::BuildVariant tool, BuildInfo::BuildVariant updater, std::filesystem::path downloadDirRoot) ->
-		std::future<std::optional<DownloadedBuild>>
+		BuildInfo::BuildVariant tool, BuildInfo::BuildVariant updater, std::filesystem::path downloadDirRoot,
+		std::filesystem::path deltaCacheDir) -> std::future<std::optional<DownloadedBuild>>
 	{
 		const auto downloadDir = downloadDirRoot / mh::format("tool_{}",
 			std::chrono::high_resolution_clock::now().time_since_epoch().count());
 
 		auto clientPtr = client.shared_from_this();
-		return std::async([clientPtr, tool, updater, downloadDir]() -> std::optional<DownloadedBuild>
+		return std::async([clientPtr, tool, updater, downloadDir, deltaCacheDir]() -> std::optional<DownloadedBuild>
 			{
-				DownloadAndExtractZip(*clientPtr, tool.m_DownloadURL, downloadDir);
+				DownloadPortableBuild(*clientPtr, tool.m_ManifestURL, tool.m_DownloadURL, Platform::GetCurrentExeDir(),
+					deltaCacheDir, downloadDir);
 
 				return DownloadedBuild(updater, downloadDir);
 			});
@@ -758,7 +702,8 @@ namespace
 			auto portable = m_Portable.value();
 			auto updater = m_Updater.value();
 
-			auto downloadBuildFuture = DownloadBuild(*client, portable, updater, m_Parent.DOWNLOAD_DIR_ROOT);
+			auto downloadBuildFuture = DownloadBuild(*client, portable, updater, m_Parent.DOWNLOAD_DIR_ROOT,
+				m_Parent.DELTA_CACHE_DIR);
 			m_Parent.m_State.Set(MH_SOURCE_LOCATION_CURRENT(), UpdateStatus::Downloading,
 				"Downloading new build...",
 				std::move(downloadBuildFuture));
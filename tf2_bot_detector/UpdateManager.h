@@ -26,6 +26,9 @@ namespace tf2_bot_detector
 			Platform::OS m_OS{};
 			Platform::Arch m_Arch{};
 			std::string m_DownloadURL;
+
+			// Optional. Lists every file in the build with its hash, so only changed files need to be downloaded.
+			std::string m_ManifestURL;
 		};
 
 		std::vector<BuildVariant> m_Updater;
@@ -0,0 +1,98 @@
+#include "BinaryPatch.h"
+
+#include <mh/text/format.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	enum class PatchOp : uint8_t
+	{
+		Copy = 0,
+		Insert = 1,
+	};
+
+	class PatchReader final
+	{
+	public:
+		PatchReader(const std::string_view& patch) : m_Remaining(patch) {}
+
+		bool empty() const { return m_Remaining.empty(); }
+
+		std::string_view ReadBytes(uint64_t count)
+		{
+			if (count > m_Remaining.size())
+				throw std::runtime_error(mh::format("Binary patch truncated: needed {} bytes, {} left", count, m_Remaining.size()));
+
+			const auto retVal = m_Remaining.substr(0, size_t(count));
+			m_Remaining.remove_prefix(size_t(count));
+			return retVal;
+		}
+
+		uint8_t ReadU8() { return uint8_t(ReadBytes(1)[0]); }
+		uint64_t ReadU64()
+		{
+			const auto bytes = ReadBytes(8);
+
+			uint64_t retVal = 0;
+			for (size_t i = 0; i < 8; i++)
+				retVal |= uint64_t(uint8_t(bytes[i])) << (i * 8);
+
+			return retVal;
+		}
+
+	private:
+		std::string_view m_Remaining;
+	};
+}
+
+std::string tf2_bot_detector::ApplyBinaryPatch(const std::string_view& oldData, const std::string_view& patch)
+{
+	PatchReader reader(patch);
+	if (reader.ReadBytes(8) != "TF2BDP01"sv)
+		throw std::runtime_error("Not a binary patch (bad magic)");
+
+	const uint64_t newSize = reader.ReadU64();
+
+	std::string retVal;
+	retVal.reserve(size_t(newSize));
+
+	while (!reader.empty())
+	{
+		const auto op = PatchOp(reader.ReadU8());
+		switch (op)
+		{
+		case PatchOp::Copy:
+		{
+			const uint64_t offset = reader.ReadU64();
+			const uint64_t length = reader.ReadU64();
+			if (offset > oldData.size() || length > (oldData.size() - offset))
+			{
+				throw std::runtime_error(mh::format("Binary patch copies {} bytes from offset {}, but the old file is only {} bytes",
+					length, offset, oldData.size()));
+			}
+
+			retVal.append(oldData.substr(size_t(offset), size_t(length)));
+			break;
+		}
+		case PatchOp::Insert:
+			retVal.append(reader.ReadBytes(reader.ReadU64()));
+			break;
+
+		default:
+			throw std::runtime_error(mh::format("Unknown binary patch op {}", uint8_t(op)));
+		}
+
+		if (retVal.size() > newSize)
+			throw std::runtime_error(mh::format("Binary patch output is larger than the expected {} bytes", newSize));
+	}
+
+	if (retVal.size() != newSize)
+		throw std::runtime_error(mh::format("Binary patch output is {} bytes, expected {}", retVal.size(), newSize));
+
+	return retVal;
+}
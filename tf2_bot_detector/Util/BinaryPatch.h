@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace tf2_bot_detector
+{
+	// Used by delta updates so that a small change to a large binary doesn't mean downloading all of it.
+	// A patch builds the new file out of ranges of the old file and literal bytes. All integers are
+	// little endian.
+	//
+	//   char[8]   "TF2BDP01"
+	//   uint64    size of the new file
+	//   then until the end of the patch, one of:
+	//     uint8 0, uint64 offset, uint64 length    copy length bytes from the old file, starting at offset
+	//     uint8 1, uint64 length, bytes[length]    insert the following bytes
+	//
+	// Throws std::runtime_error if the patch is malformed or doesn't fit oldData.
+	std::string ApplyBinaryPatch(const std::string_view& oldData, const std::string_view& patch);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace tf2_bot_detector
+{
+	// Maps client indices (the "#  N" column of status, or entindex + 1) to the object that
+	// currently owns them. Lookups are a single array index, so this is safe to hit for every
+	// voice packet line, which can arrive many times a second per player.
+	template<typename T>
+	class ClientIndexTable final
+	{
+	public:
+		static constexpr size_t MAX_CLIENTS = 101; // MAX_PLAYERS in the source engine
+
+		T* Find(uint8_t clientIndex) const
+		{
+			if (clientIndex < 1 || clientIndex > MAX_CLIENTS)
+				return nullptr;
+
+			return m_Slots[clientIndex - 1];
+		}
+
+		// Returns whatever previously occupied the slot (may be nullptr or value itself)
+		T* Set(uint8_t clientIndex, T* value)
+		{
+			if (clientIndex < 1 || clientIndex > MAX_CLIENTS)
+				return nullptr;
+
+			T* previous = m_Slots[clientIndex - 1];
+			m_Slots[clientIndex - 1] = value;
+			return previous;
+		}
+
+		void Remove(uint8_t clientIndex, const T* value)
+		{
+			if (clientIndex >= 1 && clientIndex <= MAX_CLIENTS && m_Slots[clientIndex - 1] == value)
+				m_Slots[clientIndex - 1] = nullptr;
+		}
+
+		void clear() { m_Slots.fill(nullptr); }
+
+	private:
+		std::array<T*, MAX_CLIENTS> m_Slots{};
+	};
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace tf2_bot_detector
+{
+	// Bounded lock-free queue for any number of producer threads and exactly one consumer thread.
+	// Each cell carries a sequence number that tells producers/the consumer whose turn it is, so
+	// the only contended atomic is the producers' shared write position.
+	template<typename T, size_t Capacity>
+	class MPSCRingBuffer final
+	{
+		static_assert(std::has_single_bit(Capacity), "Capacity must be a power of 2");
+		static constexpr size_t INDEX_MASK = Capacity - 1;
+
+	public:
+		MPSCRingBuffer() :
+			m_Cells(std::make_unique<Cell[]>(Capacity))
+		{
+			for (size_t i = 0; i < Capacity; i++)
+				m_Cells[i].m_Sequence.store(i, std::memory_order_relaxed);
+		}
+
+		MPSCRingBuffer(const MPSCRingBuffer&) = delete;
+		MPSCRingBuffer& operator=(const MPSCRingBuffer&) = delete;
+
+		// Safe to call from any thread. Returns false (and leaves value untouched) if the buffer is full.
+		bool TryPush(T&& value)
+		{
+			size_t pos = m_WritePos.load(std::memory_order_relaxed);
+			while (true)
+			{
+				Cell& cell = m_Cells[pos & INDEX_MASK];
+				const size_t seq = cell.m_Sequence.load(std::memory_order_acquire);
+				const auto diff = intptr_t(seq) - intptr_t(pos);
+
+				if (diff == 0)
+				{
+					if (m_WritePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					{
+						cell.m_Value = std::move(value);
+						cell.m_Sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0)
+				{
+					return false; // Full, the consumer hasn't gotten to this cell yet
+				}
+				else
+				{
+					pos = m_WritePos.load(std::memory_order_relaxed); // Someone else got this cell
+				}
+			}
+		}
+
+		// Consumer thread only. Returns false if there is nothing (fully written) to read.
+		bool TryPop(T& value)
+		{
+			Cell& cell = m_Cells[m_ReadPos & INDEX_MASK];
+			const size_t seq = cell.m_Sequence.load(std::memory_order_acquire);
+			if (intptr_t(seq) - intptr_t(m_ReadPos + 1) < 0)
+				return false;
+
+			value = std::move(cell.m_Value);
+			cell.m_Value = T{};
+			cell.m_Sequence.store(m_ReadPos + Capacity, std::memory_order_release);
+			m_ReadPos++;
+			return true;
+		}
+
+		// Total number of items ever pushed. Only approximate while producers are active.
+		size_t GetPushedCount() const { return m_WritePos.load(std::memory_order_acquire); }
+
+		static constexpr size_t GetCapacity() { return Capacity; }
+
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> m_Sequence;
+			T m_Value;
+		};
+
+		std::unique_ptr<Cell[]> m_Cells;
+
+		// Keep producers and the consumer off of each other's cache lines
+		alignas(64) std::atomic<size_t> m_WritePos = 0;
+		alignas(64) size_t m_ReadPos = 0;
+	};
+}
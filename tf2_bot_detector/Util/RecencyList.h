@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Clock.h"
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// An intrusive doubly linked list through the rows of a table, ordered by a timestamp per row,
+	// newest first. Rows are expected to be updated in roughly timestamp order, which puts them at
+	// the front of the list without walking it; an out of order timestamp only walks as far back
+	// as it needs to.
+	class RecencyList final
+	{
+	public:
+		static constexpr uint32_t NO_ROW = std::numeric_limits<uint32_t>::max();
+
+		// Number of rows, linked or not
+		size_t size() const { return m_Times.size(); }
+		void clear()
+		{
+			m_Times.clear();
+			m_NewerRows.clear();
+			m_OlderRows.clear();
+			m_NewestRow = m_OldestRow = NO_ROW;
+		}
+
+		// Adds row size() at the oldest end of the list, with a default constructed timestamp
+		uint32_t AddRow()
+		{
+			const auto row = uint32_t(m_Times.size());
+			m_Times.push_back(time_point_t{});
+			m_NewerRows.push_back(m_OldestRow);
+			m_OlderRows.push_back(NO_ROW);
+
+			if (m_OldestRow != NO_ROW)
+				m_OlderRows[m_OldestRow] = row;
+			else
+				m_NewestRow = row;
+
+			m_OldestRow = row;
+			return row;
+		}
+
+		time_point_t GetTime(uint32_t row) const { return m_Times[row]; }
+
+		// Moves row into place for its new timestamp, relinking it if it was unlinked. Ties go in
+		// front, so of two rows with the same timestamp, the one updated last comes first.
+		void Update(uint32_t row, time_point_t time)
+		{
+			assert(row < size());
+			m_Times[row] = time;
+			Unlink(row);
+
+			uint32_t newer = NO_ROW;
+			uint32_t older = m_NewestRow;
+			while (older != NO_ROW && m_Times[older] > time)
+			{
+				newer = older;
+				older = m_OlderRows[older];
+			}
+
+			m_NewerRows[row] = newer;
+			m_OlderRows[row] = older;
+			(newer != NO_ROW ? m_OlderRows[newer] : m_NewestRow) = row;
+			(older != NO_ROW ? m_NewerRows[older] : m_OldestRow) = row;
+		}
+
+		// Takes row out of the list until its next Update(). Does nothing if it isn't linked.
+		void Unlink(uint32_t row)
+		{
+			if (!IsLinked(row))
+				return;
+
+			const uint32_t newer = m_NewerRows[row];
+			const uint32_t older = m_OlderRows[row];
+			(newer != NO_ROW ? m_OlderRows[newer] : m_NewestRow) = older;
+			(older != NO_ROW ? m_NewerRows[older] : m_OldestRow) = newer;
+			m_NewerRows[row] = m_OlderRows[row] = NO_ROW;
+		}
+
+		bool IsLinked(uint32_t row) const
+		{
+			return m_NewerRows[row] != NO_ROW || m_OlderRows[row] != NO_ROW || m_NewestRow == row;
+		}
+
+		// Calls func(row) from the newest to the oldest linked row, until it returns false. Only
+		// visits the rows it needs to.
+		template<typename TFunc> void ForEach(TFunc&& func) const
+		{
+			for (uint32_t row = m_NewestRow; row != NO_ROW; row = m_OlderRows[row])
+			{
+				if (!func(row))
+					break;
+			}
+		}
+
+	private:
+		std::vector<time_point_t> m_Times;
+		std::vector<uint32_t> m_NewerRows;
+		std::vector<uint32_t> m_OlderRows;
+		uint32_t m_NewestRow = NO_ROW;
+		uint32_t m_OldestRow = NO_ROW;
+	};
+}
@@ -0,0 +1,156 @@
+#include "SecretScrubber.h"
+
+#include <cassert>
+#include <queue>
+
+using namespace tf2_bot_detector;
+
+SecretScrubber::SecretScrubber(std::vector<Secret> secrets) :
+	m_Secrets(std::move(secrets))
+{
+	std::erase_if(m_Secrets, [](const Secret& s) { return s.m_Value.empty(); });
+	if (m_Secrets.empty())
+		return;
+
+	for (const Secret& secret : m_Secrets)
+	{
+		for (char c : secret.m_Value)
+		{
+			if (auto& byteClass = m_ByteClasses[uint8_t(c)]; byteClass == 0)
+				byteClass = uint16_t(m_ClassCount++);
+		}
+	}
+
+	const auto AddState = [&]
+	{
+		m_States.emplace_back();
+		m_Transitions.resize(m_States.size() * m_ClassCount, -1);
+		return int32_t(m_States.size() - 1);
+	};
+
+	// Build the trie
+	AddState();
+	for (size_t i = 0; i < m_Secrets.size(); i++)
+	{
+		int32_t state = 0;
+		for (char c : m_Secrets[i].m_Value)
+		{
+			const size_t index = state * m_ClassCount + m_ByteClasses[uint8_t(c)];
+			if (m_Transitions[index] < 0)
+			{
+				const int32_t newState = AddState();
+				m_Transitions[index] = newState;
+			}
+
+			state = m_Transitions[index];
+		}
+
+		// Identical values would have been merged by whoever gave them to us, but if not, first one wins
+		if (m_States[state].m_Secret < 0)
+			m_States[state].m_Secret = int32_t(i);
+	}
+
+	// Breadth first, resolve failure links into a complete DFA
+	std::vector<int32_t> failLinks(m_States.size(), 0);
+	std::queue<int32_t> queue;
+	for (size_t c = 0; c < m_ClassCount; c++)
+	{
+		int32_t& next = m_Transitions[c];
+		if (next < 0)
+			next = 0;
+		else
+			queue.push(next);
+	}
+
+	while (!queue.empty())
+	{
+		const int32_t state = queue.front();
+		queue.pop();
+
+		const int32_t fail = failLinks[state];
+		m_States[state].m_OutputLink = m_States[fail].m_Secret >= 0 ? fail : m_States[fail].m_OutputLink;
+
+		for (size_t c = 0; c < m_ClassCount; c++)
+		{
+			int32_t& next = m_Transitions[state * m_ClassCount + c];
+			const int32_t failNext = m_Transitions[fail * m_ClassCount + c];
+			if (next < 0)
+			{
+				next = failNext;
+			}
+			else
+			{
+				failLinks[next] = failNext;
+				queue.push(next);
+			}
+		}
+	}
+}
+
+bool SecretScrubber::Scrub(std::string& str) const
+{
+	if (m_Secrets.empty())
+		return false;
+
+	// Reused between calls, so steady state scrubbing doesn't allocate
+	thread_local std::vector<int32_t> s_LongestSecretAt; // Longest secret starting at each position, or -1
+	thread_local std::string s_Output;
+
+	bool anyMatches = false;
+
+	int32_t state = 0;
+	for (size_t i = 0; i < str.size(); i++)
+	{
+		state = GetTransition(state, uint8_t(str[i]));
+
+		for (int32_t match = m_States[state].m_Secret >= 0 ? state : m_States[state].m_OutputLink;
+			match >= 0; match = m_States[match].m_OutputLink)
+		{
+			if (!anyMatches)
+			{
+				s_LongestSecretAt.assign(str.size(), -1);
+				anyMatches = true;
+			}
+
+			const int32_t secret = m_States[match].m_Secret;
+			const size_t start = i + 1 - m_Secrets[secret].m_Value.size();
+
+			int32_t& longest = s_LongestSecretAt[start];
+			if (longest < 0 || m_Secrets[longest].m_Value.size() < m_Secrets[secret].m_Value.size())
+				longest = secret;
+		}
+	}
+
+	if (!anyMatches)
+		return false;
+
+	s_Output.clear();
+	for (size_t i = 0; i < str.size(); )
+	{
+		const int32_t secret = s_LongestSecretAt[i];
+		if (secret < 0)
+		{
+			s_Output.push_back(str[i++]);
+			continue;
+		}
+
+		s_Output.append(m_Secrets[secret].m_Replacement);
+		size_t end = i + m_Secrets[secret].m_Value.size();
+
+		// Swallow anything that starts inside this secret but runs past the end of it
+		for (size_t j = i + 1; j < end; j++)
+		{
+			if (const int32_t overlapping = s_LongestSecretAt[j];
+				overlapping >= 0 && (j + m_Secrets[overlapping].m_Value.size()) > end)
+			{
+				s_Output.append(m_Secrets[overlapping].m_Replacement);
+				end = j + m_Secrets[overlapping].m_Value.size();
+			}
+		}
+
+		i = end;
+	}
+
+	str.assign(s_Output);
+	return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// Replaces a fixed set of secrets (api keys, passwords...) in text. The secrets are compiled into a
+	// single Aho-Corasick automaton, so scrubbing is one pass over the input no matter how many
+	// secrets there are. Immutable once constructed, safe to use from multiple threads.
+	class SecretScrubber final
+	{
+	public:
+		struct Secret
+		{
+			std::string m_Value;
+			std::string m_Replacement;
+		};
+
+		SecretScrubber() = default;
+		explicit SecretScrubber(std::vector<Secret> secrets);
+
+		// Where secrets overlap, every one of them is replaced (in order of where they start) so that
+		// no part of any secret survives. Returns false and leaves str untouched if nothing matched.
+		bool Scrub(std::string& str) const;
+
+		const std::vector<Secret>& GetSecrets() const { return m_Secrets; }
+		bool empty() const { return m_Secrets.empty(); }
+
+	private:
+		std::vector<Secret> m_Secrets;
+
+		// Bytes that appear in no secret all share class 0, which keeps the transition table small
+		uint16_t m_ByteClasses[256]{};
+		size_t m_ClassCount = 1;
+
+		struct State
+		{
+			int32_t m_Secret = -1;      // Index of the secret ending at this state, if any
+			int32_t m_OutputLink = -1;  // Next state down the failure chain that ends a secret
+		};
+		std::vector<State> m_States;
+		std::vector<int32_t> m_Transitions; // m_States.size() * m_ClassCount, fully resolved DFA
+
+		int32_t GetTransition(int32_t state, uint8_t c) const { return m_Transitions[state * m_ClassCount + m_ByteClasses[c]]; }
+	};
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Clock.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// Hashed timing wheel. Scheduling is O(1), and advancing only visits the slots for the ticks
+	// that have elapsed rather than every pending timer. Timers further out than one revolution
+	// of the wheel just stay in their slot until their tick comes around.
+	template<typename T, size_t SlotCount = 64>
+	class TimingWheel final
+	{
+	public:
+		explicit TimingWheel(duration_t tickLength, time_point_t startTime = clock_t::now()) :
+			m_TickLength(tickLength), m_StartTime(startTime)
+		{
+			assert(tickLength.count() > 0);
+		}
+
+		// Timers are never fired early, but may fire up to one tick late. Anything scheduled in the
+		// past fires on the next call to Advance().
+		void Schedule(time_point_t when, T value)
+		{
+			const auto sinceStart = when - m_StartTime;
+			int64_t tick = sinceStart / m_TickLength;
+			if ((sinceStart % m_TickLength).count() > 0)
+				tick++;
+
+			tick = std::max(tick, m_CurrentTick);
+			m_Slots[size_t(tick) % SlotCount].push_back({ std::move(value), tick });
+			m_Count++;
+		}
+
+		// Invokes func(T&&) for every timer that is due as of now. func is allowed to Schedule().
+		template<typename TFunc>
+		void Advance(time_point_t now, TFunc&& func)
+		{
+			const int64_t targetTick = (now - m_StartTime) / m_TickLength;
+			if (targetTick < m_CurrentTick)
+				return; // Clock went backwards, or still inside the current tick
+
+			// Collect first, so that func can reschedule into the slots we are walking
+			m_Due.clear();
+
+			const int64_t slotsToVisit = std::min<int64_t>(targetTick - m_CurrentTick + 1, SlotCount);
+			for (int64_t i = 0; i < slotsToVisit; i++)
+			{
+				auto& slot = m_Slots[size_t(m_CurrentTick + i) % SlotCount];
+				for (auto it = slot.begin(); it != slot.end(); )
+				{
+					if (it->m_Tick <= targetTick)
+					{
+						m_Due.push_back(std::move(it->m_Value));
+						it = slot.erase(it);
+						m_Count--;
+					}
+					else
+					{
+						++it;
+					}
+				}
+			}
+
+			m_CurrentTick = targetTick + 1;
+
+			for (T& value : m_Due)
+				func(std::move(value));
+
+			m_Due.clear();
+		}
+
+		size_t size() const { return m_Count; }
+		bool empty() const { return m_Count == 0; }
+		duration_t GetTickLength() const { return m_TickLength; }
+
+	private:
+		struct Entry
+		{
+			T m_Value;
+			int64_t m_Tick;
+		};
+
+		std::array<std::vector<Entry>, SlotCount> m_Slots;
+		std::vector<T> m_Due;
+		duration_t m_TickLength;
+		time_point_t m_StartTime;
+		int64_t m_CurrentTick = 0;  // Every tick before this one has already been processed
+		size_t m_Count = 0;
+	};
+}
@@ -21,6 +21,7 @@ namespace tf2_bot_detector
 		virtual void OnLocalPlayerInitialized(IWorldState& world, bool initialized) = 0;
 		virtual void OnLocalPlayerSpawned(IWorldState& world, TFClassType classType) = 0;
 		virtual void OnPlayerDroppedFromServer(IWorldState& world, IPlayer& player, const std::string_view& reason) = 0;
+		virtual void OnPlayerVoiceReceived(IWorldState& world, IPlayer& player, time_point_t timestamp) = 0;
 	};
 
 	class BaseWorldEventListener : public IWorldEventListener
@@ -32,6 +33,7 @@ namespace tf2_bot_detector
 		void OnLocalPlayerInitialized(IWorldState& world, bool initialized) override {}
 		void OnLocalPlayerSpawned(IWorldState& world, TFClassType classType) override {}
 		void OnPlayerDroppedFromServer(IWorldState& world, IPlayer& player, const std::string_view& reason) override {}
+		void OnPlayerVoiceReceived(IWorldState& world, IPlayer& player, time_point_t timestamp) override {}
 	};
 
 	class AutoWorldEventListener : public BaseWorldEventListener
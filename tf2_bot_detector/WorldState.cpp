@@ -4,11 +4,14 @@
 #include "ConsoleLog/ConsoleLineListener.h"
 #include "ConsoleLog/ConsoleLines.h"
 #include "ConsoleLog/ConsoleLogParser.h"
+#include "ConsoleLog/NetTelemetry.h"
 #include "GameData/TFClassType.h"
 #include "GameData/UserMessageType.h"
 #include "Networking/HTTPHelpers.h"
 #include "Networking/SteamAPI.h"
 #include "Networking/LogsTFAPI.h"
+#include "Util/ClientIndexTable.h"
+#include "Util/RecencyList.h"
 #include "Util/RegexUtils.h"
 #include "Util/TextUtils.h"
 #include "BatchedAction.h"
@@ -20,6 +23,7 @@
 #include "GlobalDispatcher.h"
 #include "Application.h"
 #include "DB/TempDB.h"
+#include "EventJournal/EventJournal.h"
 
 #include <mh/algorithm/algorithm.hpp>
 #include <mh/concurrency/dispatcher.hpp>
@@ -29,6 +33,9 @@
 #include <mh/future.hpp>
 #include <mh/coroutine/future.hpp>
 
+#include <algorithm>
+#include <limits>
+
 #undef GetCurrentTime
 #undef max
 #undef min
@@ -42,6 +49,40 @@ namespace
 {
 	class Player;
 
+	// The per-player fields that get looked at every frame, one column per field, so scans over
+	// every player (sorting, filtering) walk a few contiguous arrays instead of touching every
+	// Player. Rows are never removed individually, only all at once by clear(), so a Player's
+	// row index stays valid for as long as the Player is in the table.
+	class PlayerTable final
+	{
+	public:
+		size_t size() const { return m_Players.size(); }
+		bool empty() const { return m_Players.empty(); }
+		void clear();
+
+		Player* Find(const SteamID& id) const;
+		Player& Add(std::shared_ptr<Player> player);
+
+		time_point_t GetLastStatusUpdateTime(uint32_t row) const { return m_Recency.GetTime(row); }
+		void SetLastStatusUpdateTime(uint32_t row, time_point_t time) { m_Recency.Update(row, time); }
+
+		// Calls func(row) from the most to the least recently updated row, until it returns false.
+		// Only visits the rows it needs to.
+		template<typename TFunc> void ForEachRecentRow(TFunc&& func) const { m_Recency.ForEach(func); }
+
+		std::vector<std::shared_ptr<Player>> m_Players;
+		std::vector<SteamID> m_SteamIDs;
+		std::vector<TFTeam> m_Teams;
+		std::vector<uint16_t> m_Pings;
+		std::vector<PlayerScores> m_Scores;
+		std::vector<PlayerStatusState> m_States;
+		std::vector<UserID_t> m_UserIDs;  // 0 if unknown
+
+	private:
+		std::unordered_map<SteamID, uint32_t> m_Rows;
+		RecencyList m_Recency; // Last status update times
+	};
+
 	class WorldState final : public IWorldState, BaseConsoleLineListener
 	{
 	public:
@@ -82,6 +123,11 @@ namespace
 		mh::generator<const IPlayer&> GetPlayers() const;
 		std::vector<const IPlayer*> GetRecentPlayers(size_t recentPlayerCount = 32) const;
 		std::vector<IPlayer*> GetRecentPlayers(size_t recentPlayerCount = 32);
+		void FindPlayersUpdatedSince(time_point_t time, std::vector<IPlayer*>& players) override;
+		void SortPlayersByScore(std::vector<IPlayer*>& players) const override;
+
+		const PlayerTable& GetPlayerTable() const { return m_Players; }
+		PlayerTable& GetPlayerTable() { return m_Players; }
 
 		time_point_t GetLastStatusUpdateTime() const { return m_LastStatusUpdateTime; }
 
@@ -100,6 +146,8 @@ namespace
 		IAccountAges& GetAccountAges() { return *m_AccountAges; }
 		const IAccountAges& GetAccountAges() const override { return *m_AccountAges; }
 
+		const NetTelemetry& GetNetTelemetry() const override { return m_NetTelemetry; }
+
 	protected:
 		virtual IConsoleLineListener& GetConsoleLineListenerBroadcaster() { return m_ConsoleLineListenerBroadcaster; }
 
@@ -118,6 +166,12 @@ namespace
 
 		Player& FindOrCreatePlayer(const SteamID& id);
 
+		// Kept in sync with Player::m_ClientIndex, so lines that only identify a player by
+		// their client index don't have to scan every player
+		ClientIndexTable<Player> m_ClientIndexPlayers;
+		void SetClientIndex(Player& player, uint8_t clientIndex);
+		void ClearClientIndices();
+
 		struct PlayerSummaryUpdateAction final :
 			BatchedAction<WorldState*, SteamID, std::vector<SteamAPI::PlayerSummary>>
 		{
@@ -140,7 +194,7 @@ namespace
 
 		std::vector<LobbyMember> m_CurrentLobbyMembers;
 		std::vector<LobbyMember> m_PendingLobbyMembers;
-		std::unordered_map<SteamID, std::shared_ptr<Player>> m_CurrentPlayerData;
+		PlayerTable m_Players;  // Must clear m_ClientIndexPlayers when removing players
 		bool m_IsLocalPlayerInitialized = false;
 		bool m_IsVoteInProgress = false;
 
@@ -148,9 +202,25 @@ namespace
 
 		time_point_t m_LastStatusUpdateTime{};
 
+		NetTelemetry m_NetTelemetry;
+
 		std::unordered_set<IConsoleLineListener*> m_ConsoleLineListeners;
 		std::unordered_set<IWorldEventListener*> m_EventListeners;
 
+		struct ParsedOutputLine
+		{
+			std::shared_ptr<IConsoleLine> m_Parsed; // nullptr if the line wasn't recognized
+			std::string_view m_Text;                // Points into the chunk being processed
+		};
+
+		// Parses every complete ('\n' terminated) line in chunk, in order
+		std::vector<ParsedOutputLine> ParseConsoleOutputChunk(const std::string_view& chunk);
+
+		// Parses the whole chunk as one job on m_ConsoleLineParsingPool, then hands every line to the
+		// listeners in a single dispatch back to the main thread. Since the pool only has one thread
+		// and the dispatcher is FIFO, chunks are delivered in the order they were added.
+		mh::task<> ProcessConsoleOutputChunk(std::string chunk);
+
 		mh::thread_pool m_ConsoleLineParsingPool{ 1 };
 		std::vector<mh::shared_future<std::shared_ptr<IConsoleLine>>> m_ConsoleLineParsingTasks;
 
@@ -195,14 +265,14 @@ namespace
 		const LobbyMember* GetLobbyMember() const override;
 		std::string GetNameUnsafe() const override { return m_Status.m_Name; }
 		SteamID GetSteamID() const override { return m_Status.m_SteamID; }
-		PlayerStatusState GetConnectionState() const override { return m_Status.m_State; }
+		PlayerStatusState GetConnectionState() const override { return GetTable().m_States[m_Row]; }
 		std::optional<UserID_t> GetUserID() const override;
-		TFTeam GetTeam() const override { return m_Team; }
+		TFTeam GetTeam() const override { return GetTable().m_Teams[m_Row]; }
 		time_point_t GetConnectionTime() const override { return m_Status.m_ConnectionTime; }
 		duration_t GetConnectedTime() const override;
-		const PlayerScores& GetScores() const override { return m_Scores; }
-		uint16_t GetPing() const override { return m_Status.m_Ping; }
-		time_point_t GetLastStatusUpdateTime() const override { return m_LastStatusUpdateTime; }
+		const PlayerScores& GetScores() const override { return GetTable().m_Scores[m_Row]; }
+		uint16_t GetPing() const override { return GetTable().m_Pings[m_Row]; }
+		time_point_t GetLastStatusUpdateTime() const override { return GetTable().GetLastStatusUpdateTime(m_Row); }
 		const mh::expected<SteamAPI::PlayerSummary>& GetPlayerSummary() const override;
 		const mh::expected<SteamAPI::PlayerBans>& GetPlayerBans() const override;
 		mh::expected<duration_t> GetTF2Playtime() const override;
@@ -213,10 +283,11 @@ namespace
 		const mh::expected<LogsTFAPI::PlayerLogsInfo>& GetLogsInfo() const override;
 		const mh::expected<SteamAPI::PlayerInventoryInfo>& GetInventoryInfo() const override;
 
-		PlayerScores m_Scores{};
-		TFTeam m_Team{};
+		PlayerScores& GetMutableScores() { return GetWorld().GetPlayerTable().m_Scores[m_Row]; }
+		void SetTeam(TFTeam team) { GetWorld().GetPlayerTable().m_Teams[m_Row] = team; }
 
-		uint8_t m_ClientIndex{};
+		uint32_t m_Row{};  // Our row in WorldState's PlayerTable
+		uint8_t m_ClientIndex{};  // Use WorldState::SetClientIndex()
 		mutable mh::expected<SteamAPI::PlayerSummary> m_PlayerSummary = ErrorCode::LazyValueUninitialized;
 		mutable mh::expected<SteamAPI::PlayerBans> m_PlayerSteamBans = ErrorCode::LazyValueUninitialized;
 
@@ -240,12 +311,12 @@ namespace
 		const mh::expected<T>& GetOrFetchDataAsync(mh::expected<T>& variable, TFunc&& updateFunc,
 			std::initializer_list<std::error_condition> silentErrors = {}, MH_SOURCE_LOCATION_AUTO(location)) const;
 
+		const PlayerTable& GetTable() const { return m_World->GetPlayerTable(); }
+
 		WorldState* m_World = nullptr;
-		PlayerStatus m_Status{};
+		PlayerStatus m_Status{};  // Ping, state and userid are mirrored in the PlayerTable, read them from there
 
 		time_point_t m_LastStatusActiveBegin{};
-
-		time_point_t m_LastStatusUpdateTime{};
 		time_point_t m_LastPingUpdateTime{};
 
 		mutable mh::expected<duration_t> m_TF2Playtime = ErrorCode::LazyValueUninitialized;
@@ -254,6 +325,50 @@ namespace
 	};
 }
 
+void PlayerTable::clear()
+{
+	m_Players.clear();
+	m_SteamIDs.clear();
+	m_Teams.clear();
+	m_Pings.clear();
+	m_Scores.clear();
+	m_States.clear();
+	m_UserIDs.clear();
+	m_Rows.clear();
+	m_Recency.clear();
+}
+
+Player* PlayerTable::Find(const SteamID& id) const
+{
+	if (auto found = m_Rows.find(id); found != m_Rows.end())
+		return m_Players[found->second].get();
+
+	return nullptr;
+}
+
+Player& PlayerTable::Add(std::shared_ptr<Player> player)
+{
+	assert(player);
+	const PlayerStatus& status = player->GetStatus();
+	assert(!m_Rows.contains(status.m_SteamID));
+
+	player->m_Row = uint32_t(m_Players.size());
+	m_Rows.emplace(status.m_SteamID, player->m_Row);
+
+	m_SteamIDs.push_back(status.m_SteamID);
+	m_Teams.push_back(TFTeam{});
+	m_Pings.push_back(status.m_Ping);
+	m_Scores.push_back(PlayerScores{});
+	m_States.push_back(status.m_State);
+	m_UserIDs.push_back(status.m_UserID);
+
+	// Never updated, so this is the oldest row
+	[[maybe_unused]] const uint32_t recencyRow = m_Recency.AddRow();
+	assert(recencyRow == player->m_Row);
+
+	return *m_Players.emplace_back(std::move(player));
+}
+
 std::shared_ptr<IWorldState> IWorldState::Create(const Settings& settings)
 {
 	return std::make_shared<WorldState>(settings);
@@ -343,36 +458,62 @@ void WorldState::RemoveConsoleLineListener(IConsoleLineListener* listener)
 
 void WorldState::AddConsoleOutputChunk(const std::string_view& chunk)
 {
+	ProcessConsoleOutputChunk(std::string(chunk));
+}
+
+mh::task<> WorldState::AddConsoleOutputLine(std::string line)
+{
+	line.push_back('\n');
+	return ProcessConsoleOutputChunk(std::move(line));
+}
+
+auto WorldState::ParseConsoleOutputChunk(const std::string_view& chunk) -> std::vector<ParsedOutputLine>
+{
+	std::vector<ParsedOutputLine> retVal;
+	retVal.reserve(std::count(chunk.begin(), chunk.end(), '\n'));
+
+	const auto timestamp = GetCurrentTime();
+
 	size_t last = 0;
 	for (auto i = chunk.find('\n', 0); i != chunk.npos; i = chunk.find('\n', last))
 	{
-		auto line = chunk.substr(last, i - last);
-		AddConsoleOutputLine(std::string(line));
+		auto& line = retVal.emplace_back();
+		line.m_Text = chunk.substr(last, i - last);
+		line.m_Parsed = IConsoleLine::ParseConsoleLine(line.m_Text, timestamp, *this);
 		last = i + 1;
 	}
+
+	return retVal;
 }
 
-mh::task<> WorldState::AddConsoleOutputLine(std::string line)
+mh::task<> WorldState::ProcessConsoleOutputChunk(std::string chunk)
 {
 	auto worldState = shared_from_this();
 
 	// Switch to thread "pool" thread (there is only 1 thread in this particular pool)
 	co_await m_ConsoleLineParsingPool.co_add_task();
 
-	auto parsed = IConsoleLine::ParseConsoleLine(line, GetCurrentTime(), *this);
+	const auto lines = ParseConsoleOutputChunk(chunk);
+	if (lines.empty())
+		co_return;
 
 	// switch to main thread
 	co_await GetDispatcher().co_dispatch();
 
-	if (parsed)
-	{
-		for (auto listener : m_ConsoleLineListeners)
-			listener->OnConsoleLineParsed(*worldState, *parsed);
-	}
-	else
+	for (const ParsedOutputLine& line : lines)
 	{
-		for (auto listener : m_ConsoleLineListeners)
-			listener->OnConsoleLineUnparsed(*worldState, std::move(line));
+		if (line.m_Parsed)
+		{
+			IEventJournal::GetInstance().RecordConsoleLine(*line.m_Parsed, line.m_Text);
+
+			for (auto listener : m_ConsoleLineListeners)
+				listener->OnConsoleLineParsed(*worldState, *line.m_Parsed);
+		}
+		else
+		{
+			for (auto listener : m_ConsoleLineListeners)
+				listener->OnConsoleLineUnparsed(*worldState, line.m_Text);
+		}
 	}
 }
 
@@ -396,12 +537,13 @@ std::optional<SteamID> WorldState::FindSteamIDForName(const std::string_view& pl
 	std::optional<SteamID> retVal;
 	time_point_t lastUpdated{};
 
-	for (const auto& data : m_CurrentPlayerData)
+	for (size_t i = 0; i < m_Players.size(); i++)
 	{
-		if (data.second->GetStatus().m_Name == playerName && data.second->GetLastStatusUpdateTime() > lastUpdated)
+		const time_point_t updateTime = m_Players.GetLastStatusUpdateTime(uint32_t(i));
+		if (updateTime > lastUpdated && m_Players.m_Players[i]->GetStatus().m_Name == playerName)
 		{
-			retVal = data.second->GetSteamID();
-			lastUpdated = data.second->GetLastStatusUpdateTime();
+			retVal = m_Players.m_SteamIDs[i];
+			lastUpdated = updateTime;
 		}
 	}
 
@@ -427,11 +569,8 @@ std::optional<LobbyMemberTeam> WorldState::FindLobbyMemberTeam(const SteamID& id
 
 std::optional<UserID_t> WorldState::FindUserID(const SteamID& id) const
 {
-	for (const auto& player : m_CurrentPlayerData)
-	{
-		if (player.second->GetSteamID() == id)
-			return player.second->GetUserID();
-	}
+	if (auto player = m_Players.Find(id))
+		return player->GetUserID();
 
 	return std::nullopt;
 }
@@ -465,10 +604,7 @@ auto WorldState::GetTeamShareResult(const std::optional<LobbyMemberTeam>& team0,
 
 const IPlayer* WorldState::FindPlayer(const SteamID& id) const
 {
-	if (auto found = m_CurrentPlayerData.find(id); found != m_CurrentPlayerData.end())
-		return found->second.get();
-
-	return nullptr;
+	return m_Players.Find(id);
 }
 
 size_t WorldState::GetApproxLobbyMemberCount() const
@@ -483,11 +619,11 @@ mh::generator<const IPlayer&> WorldState::GetLobbyMembers() const
 		assert(member != LobbyMember{});
 		assert(member.m_SteamID.IsValid());
 
-		if (auto found = m_CurrentPlayerData.find(member.m_SteamID); found != m_CurrentPlayerData.end())
+		if (auto found = m_Players.Find(member.m_SteamID))
 		{
-			[[maybe_unused]] const LobbyMember* testMember = found->second->GetLobbyMember();
+			[[maybe_unused]] const LobbyMember* testMember = found->GetLobbyMember();
 			//assert(*testMember == member);
-			return found->second.get();
+			return found;
 		}
 		else
 		{
@@ -522,8 +658,8 @@ mh::generator<const IPlayer&> WorldState::GetLobbyMembers() const
 
 mh::generator<const IPlayer&> WorldState::GetPlayers() const
 {
-	for (const auto& pair : m_CurrentPlayerData)
-		co_yield *pair.second;
+	for (const auto& player : m_Players.m_Players)
+		co_yield *player;
 }
 
 void WorldState::QueuePlayerSummaryUpdate(const SteamID& id)
@@ -536,35 +672,81 @@ void WorldState::QueuePlayerBansUpdate(const SteamID& id)
 	return m_PlayerBansUpdates.Queue(id);
 }
 
-template<typename TMap>
-static auto GetRecentPlayersImpl(TMap&& map, size_t recentPlayerCount)
+std::vector<const IPlayer*> WorldState::GetRecentPlayers(size_t recentPlayerCount) const
 {
-	using value_type = std::conditional_t<std::is_const_v<std::remove_reference_t<TMap>>, const IPlayer*, IPlayer*>;
-	std::vector<value_type> retVal;
-
-	for (auto& [sid, player] : map)
-		retVal.push_back(player.get());
-
-	std::sort(retVal.begin(), retVal.end(),
-		[](const IPlayer* a, const IPlayer* b)
+	std::vector<const IPlayer*> retVal;
+	m_Players.ForEachRecentRow([&](uint32_t row)
 		{
-			return b->GetLastStatusUpdateTime() < a->GetLastStatusUpdateTime();
+			if (retVal.size() >= recentPlayerCount)
+				return false;
+
+			retVal.push_back(m_Players.m_Players[row].get());
+			return true;
 		});
 
-	if (retVal.size() > recentPlayerCount)
-		retVal.resize(recentPlayerCount);
+	return retVal;
+}
+
+std::vector<IPlayer*> WorldState::GetRecentPlayers(size_t recentPlayerCount)
+{
+	std::vector<IPlayer*> retVal;
+	for (const IPlayer* player : std::as_const(*this).GetRecentPlayers(recentPlayerCount))
+		retVal.push_back(const_cast<IPlayer*>(player));
 
 	return retVal;
 }
 
-std::vector<const IPlayer*> WorldState::GetRecentPlayers(size_t recentPlayerCount) const
+void WorldState::SortPlayersByScore(std::vector<IPlayer*>& players) const
 {
-	return GetRecentPlayersImpl(m_CurrentPlayerData, recentPlayerCount);
+	struct SortKey
+	{
+		uint16_t m_Kills;
+		uint16_t m_Deaths;
+		UserID_t m_UserID;
+		IPlayer* m_Player;
+	};
+
+	// Pull the keys out of the table columns once, so the sort itself only touches this array
+	std::vector<SortKey> keys;
+	keys.reserve(players.size());
+	for (IPlayer* player : players)
+	{
+		assert(player);
+		assert(&player->GetWorld() == this);
+		const uint32_t row = static_cast<const Player*>(player)->m_Row;
+		keys.push_back({ m_Players.m_Scores[row].m_Kills, m_Players.m_Scores[row].m_Deaths, m_Players.m_UserIDs[row], player });
+	}
+
+	std::sort(keys.begin(), keys.end(), [](const SortKey& lhs, const SortKey& rhs)
+		{
+			// Intentionally reversed, we want descending kill order
+			if (lhs.m_Kills != rhs.m_Kills)
+				return rhs.m_Kills < lhs.m_Kills;
+
+			if (lhs.m_Deaths != rhs.m_Deaths)
+				return lhs.m_Deaths < rhs.m_Deaths;
+
+			// Sort by ascending userid
+			if (lhs.m_UserID > 0 && rhs.m_UserID > 0)
+				return lhs.m_UserID < rhs.m_UserID;
+
+			return false;
+		});
+
+	for (size_t i = 0; i < keys.size(); i++)
+		players[i] = keys[i].m_Player;
 }
 
-std::vector<IPlayer*> WorldState::GetRecentPlayers(size_t recentPlayerCount)
+void WorldState::FindPlayersUpdatedSince(time_point_t time, std::vector<IPlayer*>& players)
 {
-	return GetRecentPlayersImpl(m_CurrentPlayerData, recentPlayerCount);
+	m_Players.ForEachRecentRow([&](uint32_t row)
+		{
+			if (m_Players.GetLastStatusUpdateTime(row) < time)
+				return false;
+
+			players.push_back(m_Players.m_Players[row].get());
+			return true;
+		});
 }
 
 void WorldState::OnConfigExecLineParsed(const ConfigExecLine& execLine)
@@ -620,7 +802,8 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 	{
 		m_CurrentLobbyMembers.clear();
 		m_PendingLobbyMembers.clear();
-		m_CurrentPlayerData.clear();
+		m_Players.clear();
+		m_ClientIndexPlayers.clear();
 	};
 
 	switch (parsed.GetType())
@@ -638,7 +821,8 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 		{
 			m_CurrentLobbyMembers.clear();
 			m_PendingLobbyMembers.clear();
-			m_CurrentPlayerData.clear();
+			m_Players.clear();
+			m_ClientIndexPlayers.clear();
 		}
 		break;
 	}
@@ -655,8 +839,7 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 		if (changeType == LobbyChangeType::Created || changeType == LobbyChangeType::Updated)
 		{
 			// We can't trust the existing client indices
-			for (auto& player : m_CurrentPlayerData)
-				player.second->m_ClientIndex = 0;
+			ClearClientIndices();
 		}
 		break;
 	}
@@ -726,27 +909,14 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 		break;
 	}
 
-#if 0
 	case ConsoleLineType::VoiceReceive:
 	{
 		auto& voiceReceiveLine = static_cast<const VoiceReceiveLine&>(parsed);
-		for (auto& player : m_CurrentPlayerData)
-		{
-			if (player.second.m_ClientIndex == (voiceReceiveLine.GetEntIndex() + 1))
-			{
-				auto& voice = player.second.m_Voice;
-				if (voice.m_LastTransmission != parsed.GetTimestamp())
-				{
-					voice.m_TotalTransmissions += 1s; // This is fine because we know the resolution of our timestamps is 1 second
-					voice.m_LastTransmission = parsed.GetTimestamp();
-				}
+		if (auto player = m_ClientIndexPlayers.Find(uint8_t(voiceReceiveLine.GetEntIndex() + 1)))
+			InvokeEventListener(&IWorldEventListener::OnPlayerVoiceReceived, *this, *player, parsed.GetTimestamp());
 
-				break;
-			}
-		}
 		break;
 	}
-#endif
 
 	case ConsoleLineType::LobbyMember:
 	{
@@ -757,7 +927,7 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 			vec[member.m_Index] = member;
 
 		const TFTeam tfTeam = member.m_Team == LobbyMemberTeam::Defenders ? TFTeam::Red : TFTeam::Blue;
-		FindOrCreatePlayer(member.m_SteamID).m_Team = tfTeam;
+		FindOrCreatePlayer(member.m_SteamID).SetTeam(tfTeam);
 
 		break;
 	}
@@ -797,7 +967,7 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 		auto& statusLine = static_cast<const ServerStatusShortPlayerLine&>(parsed);
 		const auto& status = statusLine.GetPlayerStatus();
 		if (auto steamID = FindSteamIDForName(status.m_Name))
-			FindOrCreatePlayer(*steamID).m_ClientIndex = status.m_ClientIndex;
+			SetClientIndex(FindOrCreatePlayer(*steamID), status.m_ClientIndex);
 
 		break;
 	}
@@ -811,19 +981,19 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 		if (attackerSteamID)
 		{
 			auto& attacker = FindOrCreatePlayer(*attackerSteamID);
-			attacker.m_Scores.m_Kills++;
+			attacker.GetMutableScores().m_Kills++;
 
 			if (victimSteamID == localSteamID)
-				attacker.m_Scores.m_LocalKills++;
+				attacker.GetMutableScores().m_LocalKills++;
 		}
 
 		if (victimSteamID)
 		{
 			auto& victim = FindOrCreatePlayer(*victimSteamID);
-			victim.m_Scores.m_Deaths++;
+			victim.GetMutableScores().m_Deaths++;
 
 			if (attackerSteamID == localSteamID)
-				victim.m_Scores.m_LocalDeaths++;
+				victim.GetMutableScores().m_LocalDeaths++;
 		}
 
 		break;
@@ -847,56 +1017,51 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 		break;
 	}
 
-#if 0
 	case ConsoleLineType::NetDataTotal:
-	{
-		auto& netDataLine = static_cast<const NetDataTotalLine&>(parsed);
-		auto ts = round_time_point(netDataLine.GetTimestamp(), 100ms);
-		m_NetSamplesIn.m_Data[ts].AddSample(netDataLine.GetInKBps());
-		m_NetSamplesOut.m_Data[ts].AddSample(netDataLine.GetOutKBps());
-		break;
-	}
 	case ConsoleLineType::NetLatency:
-	{
-		auto& netLatencyLine = static_cast<const NetLatencyLine&>(parsed);
-		auto ts = round_time_point(netLatencyLine.GetTimestamp(), 100ms);
-		m_NetSamplesIn.m_Latency[ts].AddSample(netLatencyLine.GetInLatency());
-		m_NetSamplesOut.m_Latency[ts].AddSample(netLatencyLine.GetOutLatency());
-		break;
-	}
 	case ConsoleLineType::NetPacketsTotal:
-	{
-		auto& netPacketsLine = static_cast<const NetPacketsTotalLine&>(parsed);
-		auto ts = round_time_point(netPacketsLine.GetTimestamp(), 100ms);
-		m_NetSamplesIn.m_Packets[ts].AddSample(netPacketsLine.GetInPacketsPerSecond());
-		m_NetSamplesOut.m_Packets[ts].AddSample(netPacketsLine.GetOutPacketsPerSecond());
-		break;
-	}
 	case ConsoleLineType::NetLoss:
 	{
-		auto& netLossLine = static_cast<const NetLossLine&>(parsed);
-		auto ts = round_time_point(netLossLine.GetTimestamp(), 100ms);
-		m_NetSamplesIn.m_Loss[ts].AddSample(netLossLine.GetInLossPercent());
-		m_NetSamplesOut.m_Loss[ts].AddSample(netLossLine.GetOutLossPercent());
+		m_NetTelemetry.Add(parsed);
 		break;
 	}
-#endif
 
 	default:
 		break;
 	}
 }
 
+void WorldState::SetClientIndex(Player& player, uint8_t clientIndex)
+{
+	if (player.m_ClientIndex == clientIndex)
+		return;
+
+	m_ClientIndexPlayers.Remove(player.m_ClientIndex, &player);
+	player.m_ClientIndex = clientIndex;
+
+	// Whoever had this index before has either left or been given a new one we haven't seen yet
+	if (Player* previous = m_ClientIndexPlayers.Set(clientIndex, &player); previous && previous != &player)
+		previous->m_ClientIndex = 0;
+}
+
+void WorldState::ClearClientIndices()
+{
+	for (auto& player : m_Players.m_Players)
+		player->m_ClientIndex = 0;
+
+	m_ClientIndexPlayers.clear();
+}
+
 Player& WorldState::FindOrCreatePlayer(const SteamID& id)
 {
 	Player* data;
-	if (auto found = m_CurrentPlayerData.find(id); found != m_CurrentPlayerData.end())
+	if (auto found = m_Players.Find(id))
 	{
-		data = found->second.get();
+		data = found;
 	}
 	else
 	{
-		data = m_CurrentPlayerData.emplace(id, std::make_shared<Player>(*this, id)).first->second.get();
+		data = &m_Players.Add(std::make_shared<Player>(*this, id));
 
 		if (!GetSettings().m_LazyLoadAPIData)
 		{
@@ -949,8 +1114,8 @@ const LobbyMember* Player::GetLobbyMember() const
 
 std::optional<UserID_t> Player::GetUserID() const
 {
-	if (m_Status.m_UserID > 0)
-		return m_Status.m_UserID;
+	if (const UserID_t userID = GetTable().m_UserIDs[m_Row]; userID > 0)
+		return userID;
 
 	return std::nullopt;
 }
@@ -1111,10 +1276,10 @@ bool Player::IsFriend() const
 
 duration_t Player::GetActiveTime() const
 {
-	if (m_Status.m_State != PlayerStatusState::Active)
+	if (GetConnectionState() != PlayerStatusState::Active)
 		return 0s;
 
-	return m_LastStatusUpdateTime - m_LastStatusActiveBegin;
+	return GetLastStatusUpdateTime() - m_LastStatusActiveBegin;
 }
 
 std::optional<time_point_t> Player::GetEstimatedAccountCreationTime() const
@@ -1134,11 +1299,18 @@ void Player::SetStatus(PlayerStatus status, time_point_t timestamp)
 		m_LastStatusActiveBegin = timestamp;
 
 	m_Status = std::move(status);
-	m_LastStatusUpdateTime = m_LastPingUpdateTime = timestamp;
+	m_LastPingUpdateTime = timestamp;
+
+	PlayerTable& table = GetWorld().GetPlayerTable();
+	table.m_States[m_Row] = m_Status.m_State;
+	table.m_Pings[m_Row] = m_Status.m_Ping;
+	table.m_UserIDs[m_Row] = m_Status.m_UserID;
+	table.SetLastStatusUpdateTime(m_Row, timestamp);
 }
 void Player::SetPing(uint16_t ping, time_point_t timestamp)
 {
 	m_Status.m_Ping = ping;
+	GetWorld().GetPlayerTable().m_Pings[m_Row] = ping;
 	m_LastPingUpdateTime = timestamp;
 }
 
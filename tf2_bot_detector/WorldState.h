@@ -8,6 +8,7 @@
 #include <mh/coroutine/generator.hpp>
 
 #include <optional>
+#include <vector>
 
 #undef GetCurrentTime
 
@@ -20,6 +21,7 @@ namespace tf2_bot_detector
 	class IConsoleLineListener;
 	class IPlayer;
 	class IWorldEventListener;
+	class NetTelemetry;
 	enum class LobbyMemberTeam : uint8_t;
 	class Settings;
 	enum class TFClassType;
@@ -85,11 +87,21 @@ namespace tf2_bot_detector
 		virtual mh::generator<const IPlayer&> GetPlayers() const = 0;
 		mh::generator<IPlayer&> GetPlayers();
 
+		// Appends every player whose last status update was at or after time
+		virtual void FindPlayersUpdatedSince(time_point_t time, std::vector<IPlayer*>& players) = 0;
+
+		// Scoreboard order: most kills, then fewest deaths, then lowest userid. All of the players
+		// must belong to this world.
+		virtual void SortPlayersByScore(std::vector<IPlayer*>& players) const = 0;
+
 		// Have we joined a team and picked a class?
 		virtual bool IsLocalPlayerInitialized() const = 0;
 		virtual bool IsVoteInProgress() const = 0;
 
 		virtual const IAccountAges& GetAccountAges() const = 0;
+
+		// net_status history, for lining up lag spikes with whatever else was going on
+		virtual const NetTelemetry& GetNetTelemetry() const = 0;
 	};
 
 	inline mh::generator<IPlayer&> IWorldState::GetLobbyMembers()
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "UpdateManifest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	struct StagedInstallStats
+	{
+		size_t m_FileCount = 0;
+		uint64_t m_ByteCount = 0;
+		std::chrono::steady_clock::duration m_CopyTime{};
+
+		// False if installDir couldn't be renamed (something had it open), and the files were replaced
+		// one at a time instead. The previous version from the install before is kept in that case, so
+		// rolling back goes back two versions.
+		bool m_SwappedDirectories = false;
+
+		double GetMBPerSecond() const;
+	};
+
+	// Next to installDir, named after it
+	std::filesystem::path GetStagedInstallShadowDir(const std::filesystem::path& installDir);
+	std::filesystem::path GetStagedInstallPreviousDir(const std::filesystem::path& installDir);
+
+	// Installs the files in manifest from sourceDir to installDir, without ever leaving installDir half updated:
+	//  1. The current contents of installDir are hard linked (or copied, where that isn't supported) into
+	//     a shadow directory, minus the files that are about to be replaced. The portable temp directory
+	//     and sourceDir, if it is inside installDir, are left behind with the previous version.
+	//  2. threadCount workers copy the files in manifest from sourceDir to the shadow directory, checking
+	//     each one against its hash.
+	//  3. installDir is renamed to the previous version directory, and the shadow directory takes its place.
+	// If anything fails before the last step, installDir is left untouched. The previous version is kept
+	// until the next install has swapped its directories, see RollbackStagedInstall().
+	StagedInstallStats InstallStaged(const std::filesystem::path& sourceDir, const std::filesystem::path& installDir,
+		const std::vector<UpdateManifestEntry>& manifest, unsigned threadCount = 4);
+
+	// Swaps the previous version kept by InstallStaged() back in, and the current version becomes the previous
+	// version. Returns false if there isn't one.
+	bool RollbackStagedInstall(const std::filesystem::path& installDir);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// Lowercase hex
+	std::string HashSHA256(const std::string_view& data);
+	std::string HashFileSHA256(const std::filesystem::path& path);
+
+	// Copies source to dest (overwriting it), returning the hash of the data that was copied. Only reads
+	// source once, so verifying a copy costs nothing extra in IO.
+	std::string CopyFileSHA256(const std::filesystem::path& source, const std::filesystem::path& dest);
+
+	struct UpdateManifestEntry
+	{
+		std::filesystem::path m_Path;  // Relative to the root of the build
+		std::string m_SHA256;
+	};
+
+	// Lists the files in a downloaded delta update. Same format as sha256sum (<hash> *<path>), so it can
+	// be checked by hand if something goes wrong.
+	constexpr std::string_view UPDATE_MANIFEST_FILENAME = "tf2bd_update_manifest.sha256";
+
+	// Relative, and doesn't try to escape the build directory with ..
+	bool IsValidUpdateManifestPath(const std::filesystem::path& path);
+
+	// Throws if any of the paths are invalid.
+	std::vector<UpdateManifestEntry> ReadUpdateManifest(const std::filesystem::path& path);
+	void WriteUpdateManifest(const std::filesystem::path& path, const std::vector<UpdateManifestEntry>& entries);
+
+	// Hashes every file under dir, other than an existing update manifest.
+	std::vector<UpdateManifestEntry> CreateUpdateManifest(const std::filesystem::path& dir);
+
+	// Copies source to a temporary file next to dest, then renames it over dest. If this fails partway
+	// through, dest is still the old file rather than a partially written one.
+	void ReplaceFile(const std::filesystem::path& source, const std::filesystem::path& dest);
+}
@@ -0,0 +1,272 @@
+#include "StagedInstall.h"
+
+#include <mh/text/format.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	// Where IFilesystem::GetTempDir() points in portable mode. Downloads and caches live in there, which
+	// belong to whatever version is running rather than the one being installed.
+	static constexpr char PORTABLE_TEMP_DIR[] = "temp";
+
+	std::filesystem::path NormalizeDir(const std::filesystem::path& dir)
+	{
+		auto retVal = dir.lexically_normal();
+		if (!retVal.has_filename())
+			retVal = retVal.parent_path(); // Trailing slash
+
+		return retVal;
+	}
+
+	std::filesystem::path GetSiblingDir(const std::filesystem::path& installDir, const std::string_view& suffix)
+	{
+		auto dir = NormalizeDir(installDir);
+		dir += suffix;
+		return dir;
+	}
+
+	// Everything in installDir, other than the files that are about to be replaced and the directories
+	// in skippedDirs (relative to installDir)
+	void LinkUnchangedFiles(const std::filesystem::path& installDir, const std::filesystem::path& shadowDir,
+		const std::set<std::filesystem::path>& replacedFiles, const std::set<std::filesystem::path>& skippedDirs)
+	{
+		std::filesystem::create_directories(shadowDir);
+
+		if (!std::filesystem::exists(installDir))
+			return; // First install
+
+		for (auto it = std::filesystem::recursive_directory_iterator(installDir);
+			it != std::filesystem::recursive_directory_iterator(); ++it)
+		{
+			const auto& entry = *it;
+			const auto relativePath = entry.path().lexically_relative(installDir);
+			const auto shadowPath = shadowDir / relativePath;
+
+			if (entry.is_directory() && !entry.is_symlink() && skippedDirs.contains(relativePath.lexically_normal()))
+			{
+				it.disable_recursion_pending();
+				continue;
+			}
+
+			if (entry.is_symlink())
+			{
+				std::filesystem::copy_symlink(entry.path(), shadowPath);
+			}
+			else if (entry.is_directory())
+			{
+				std::filesystem::create_directories(shadowPath);
+			}
+			else if (entry.is_regular_file() && !replacedFiles.contains(relativePath.lexically_normal()))
+			{
+				// Installs never write to these in place, so the previous version can share them. Settings
+				// and player lists in portable mode do get rewritten in place, which means rolling back
+				// keeps anything that changed since the update rather than restoring an old copy.
+				std::error_code ec;
+				std::filesystem::create_hard_link(entry.path(), shadowPath, ec);
+				if (ec)
+					std::filesystem::copy_file(entry.path(), shadowPath);
+			}
+		}
+	}
+
+	uint64_t CopyAndVerifyFiles(const std::filesystem::path& sourceDir, const std::filesystem::path& shadowDir,
+		const std::vector<UpdateManifestEntry>& manifest, unsigned threadCount)
+	{
+		// Up front, so the workers don't race each other creating them
+		for (const auto& entry : manifest)
+			std::filesystem::create_directories((shadowDir / entry.m_Path).parent_path());
+
+		std::atomic_size_t nextIndex = 0;
+		std::atomic_uint64_t byteCount = 0;
+		std::atomic_bool failed = false;
+
+		std::mutex exceptionMutex;
+		std::exception_ptr exception;
+
+		const auto Worker = [&]
+		{
+			try
+			{
+				for (size_t i = nextIndex++; i < manifest.size() && !failed; i = nextIndex++)
+				{
+					const auto& entry = manifest[i];
+					const auto destPath = shadowDir / entry.m_Path;
+
+					// Could be a hard link to the installed version if the case of the name changed
+					std::filesystem::remove(destPath);
+
+					if (const auto hash = CopyFileSHA256(sourceDir / entry.m_Path, destPath); hash != entry.m_SHA256)
+					{
+						throw std::runtime_error(mh::format("{} has hash {}, expected {}",
+							(sourceDir / entry.m_Path).string(), hash, entry.m_SHA256));
+					}
+
+					byteCount += std::filesystem::file_size(destPath);
+				}
+			}
+			catch (...)
+			{
+				failed = true;
+
+				std::lock_guard lock(exceptionMutex);
+				if (!exception)
+					exception = std::current_exception();
+			}
+		};
+
+		{
+			std::vector<std::jthread> threads;
+			const size_t workerCount = std::clamp<size_t>(threadCount, 1, std::max<size_t>(manifest.size(), 1));
+			for (size_t i = 1; i < workerCount; i++)
+				threads.emplace_back(Worker);
+
+			Worker();
+		}
+
+		if (exception)
+			std::rethrow_exception(exception);
+
+		return byteCount;
+	}
+}
+
+double StagedInstallStats::GetMBPerSecond() const
+{
+	const auto seconds = std::chrono::duration<double>(m_CopyTime).count();
+	if (seconds <= 0)
+		return 0;
+
+	return (m_ByteCount / (1024.0 * 1024.0)) / seconds;
+}
+
+std::filesystem::path tf2_bot_detector::GetStagedInstallShadowDir(const std::filesystem::path& installDir)
+{
+	return GetSiblingDir(installDir, ".update_staging");
+}
+
+std::filesystem::path tf2_bot_detector::GetStagedInstallPreviousDir(const std::filesystem::path& installDir)
+{
+	return GetSiblingDir(installDir, ".previous_version");
+}
+
+StagedInstallStats tf2_bot_detector::InstallStaged(const std::filesystem::path& sourceDir,
+	const std::filesystem::path& installDir, const std::vector<UpdateManifestEntry>& manifest, unsigned threadCount)
+{
+	StagedInstallStats stats;
+	stats.m_FileCount = manifest.size();
+
+	const auto shadowDir = GetStagedInstallShadowDir(installDir);
+
+	// Left over from an install that didn't finish
+	std::filesystem::remove_all(shadowDir);
+
+	try
+	{
+		std::set<std::filesystem::path> replacedFiles;
+		for (const auto& entry : manifest)
+		{
+			if (!IsValidUpdateManifestPath(entry.m_Path))
+				throw std::invalid_argument(mh::format("Invalid path in update manifest: {}", entry.m_Path.string()));
+
+			replacedFiles.insert(entry.m_Path.lexically_normal());
+		}
+
+		std::set<std::filesystem::path> skippedDirs{ PORTABLE_TEMP_DIR };
+		if (const auto sourceRelativeDir = NormalizeDir(sourceDir).lexically_relative(NormalizeDir(installDir));
+			!sourceRelativeDir.empty() && sourceRelativeDir != "." && *sourceRelativeDir.begin() != "..")
+		{
+			skippedDirs.insert(sourceRelativeDir); // Staged somewhere inside installDir
+		}
+
+		LinkUnchangedFiles(installDir, shadowDir, replacedFiles, skippedDirs);
+
+		const auto startTime = std::chrono::steady_clock::now();
+		stats.m_ByteCount = CopyAndVerifyFiles(sourceDir, shadowDir, manifest, threadCount);
+		stats.m_CopyTime = std::chrono::steady_clock::now() - startTime;
+	}
+	catch (...)
+	{
+		std::error_code ec;
+		std::filesystem::remove_all(shadowDir, ec);
+		throw;
+	}
+
+	// The old previous version is only moved aside until the swap has worked, so a failed swap still
+	// leaves something to roll back to
+	const auto previousDir = GetStagedInstallPreviousDir(installDir);
+	const auto oldPreviousDir = GetSiblingDir(installDir, ".previous_version.old");
+	std::filesystem::remove_all(oldPreviousDir);
+	if (std::filesystem::exists(previousDir))
+		std::filesystem::rename(previousDir, oldPreviousDir);
+
+	if (std::filesystem::exists(installDir))
+	{
+		std::error_code ec;
+		std::filesystem::rename(installDir, previousDir, ec);
+		if (ec)
+		{
+			std::filesystem::rename(oldPreviousDir, previousDir, ec);
+
+			// Usually something else has a file open in there. Not as safe, but each file still gets
+			// swapped in whole.
+			for (const auto& entry : manifest)
+				ReplaceFile(shadowDir / entry.m_Path, installDir / entry.m_Path);
+
+			std::filesystem::remove_all(shadowDir, ec);
+			return stats;
+		}
+	}
+
+	try
+	{
+		std::filesystem::rename(shadowDir, installDir);
+	}
+	catch (...)
+	{
+		std::error_code ec;
+		std::filesystem::rename(previousDir, installDir, ec);
+		std::filesystem::rename(oldPreviousDir, previousDir, ec);
+		throw;
+	}
+
+	std::error_code ec;
+	std::filesystem::remove_all(oldPreviousDir, ec);
+
+	stats.m_SwappedDirectories = true;
+	return stats;
+}
+
+bool tf2_bot_detector::RollbackStagedInstall(const std::filesystem::path& installDir)
+{
+	const auto previousDir = GetStagedInstallPreviousDir(installDir);
+	if (!std::filesystem::is_directory(previousDir))
+		return false;
+
+	// The current version becomes the previous version, so rolling back twice gets you where you started
+	const auto swapDir = GetSiblingDir(installDir, ".rollback");
+	std::filesystem::remove_all(swapDir);
+	std::filesystem::rename(installDir, swapDir);
+
+	try
+	{
+		std::filesystem::rename(previousDir, installDir);
+	}
+	catch (...)
+	{
+		std::error_code ec;
+		std::filesystem::rename(swapDir, installDir, ec);
+		throw;
+	}
+
+	std::filesystem::rename(swapDir, previousDir);
+	return true;
+}
@@ -0,0 +1,182 @@
+#include "UpdateManifest.h"
+
+#include <cryptopp/sha.h>
+#include <mh/text/format.hpp>
+
+#include <fstream>
+#include <stdexcept>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	std::string ToHex(const CryptoPP::byte* data, size_t size)
+	{
+		static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+		std::string retVal(size * 2, '\0');
+		for (size_t i = 0; i < size; i++)
+		{
+			retVal[i * 2] = HEX_DIGITS[data[i] >> 4];
+			retVal[i * 2 + 1] = HEX_DIGITS[data[i] & 0xF];
+		}
+
+		return retVal;
+	}
+
+	std::string FinalHex(CryptoPP::SHA256& hash)
+	{
+		CryptoPP::byte digest[CryptoPP::SHA256::DIGESTSIZE];
+		hash.Final(digest);
+		return ToHex(digest, sizeof(digest));
+	}
+}
+
+bool tf2_bot_detector::IsValidUpdateManifestPath(const std::filesystem::path& path)
+{
+	if (path.empty() || path.has_root_name() || path.has_root_directory())
+		return false;
+
+	for (const auto& part : path)
+	{
+		if (part == "..")
+			return false;
+	}
+
+	return true;
+}
+
+std::string tf2_bot_detector::HashSHA256(const std::string_view& data)
+{
+	CryptoPP::SHA256 hash;
+	hash.Update(reinterpret_cast<const CryptoPP::byte*>(data.data()), data.size());
+	return FinalHex(hash);
+}
+
+std::string tf2_bot_detector::HashFileSHA256(const std::filesystem::path& path)
+{
+	std::ifstream file;
+	file.exceptions(std::ios::badbit);
+	file.open(path, std::ios::binary);
+	if (!file.good())
+		throw std::runtime_error(mh::format("Failed to open {} for hashing", path.string()));
+
+	CryptoPP::SHA256 hash;
+	char buf[64 * 1024];
+	while (file.read(buf, sizeof(buf)) || file.gcount() > 0)
+		hash.Update(reinterpret_cast<const CryptoPP::byte*>(buf), static_cast<size_t>(file.gcount()));
+
+	return FinalHex(hash);
+}
+
+std::string tf2_bot_detector::CopyFileSHA256(const std::filesystem::path& source, const std::filesystem::path& dest)
+{
+	std::ifstream sourceFile;
+	sourceFile.exceptions(std::ios::badbit);
+	sourceFile.open(source, std::ios::binary);
+	if (!sourceFile.good())
+		throw std::runtime_error(mh::format("Failed to open {} for copying", source.string()));
+
+	std::ofstream destFile;
+	destFile.exceptions(std::ios::badbit | std::ios::failbit);
+	destFile.open(dest, std::ios::binary | std::ios::trunc);
+
+	CryptoPP::SHA256 hash;
+	char buf[64 * 1024];
+	while (sourceFile.read(buf, sizeof(buf)) || sourceFile.gcount() > 0)
+	{
+		hash.Update(reinterpret_cast<const CryptoPP::byte*>(buf), static_cast<size_t>(sourceFile.gcount()));
+		destFile.write(buf, sourceFile.gcount());
+	}
+
+	return FinalHex(hash);
+}
+
+std::vector<UpdateManifestEntry> tf2_bot_detector::ReadUpdateManifest(const std::filesystem::path& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.good())
+		throw std::runtime_error(mh::format("Failed to open update manifest {}", path.string()));
+
+	std::vector<UpdateManifestEntry> entries;
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::string_view view = line;
+		if (view.ends_with('\r'))
+			view.remove_suffix(1);
+
+		if (view.empty())
+			continue;
+
+		// <64 hex digits><space><space or * for binary mode><path>
+		if (view.size() < 67 || view[64] != ' ' || (view[65] != ' ' && view[65] != '*'))
+			throw std::runtime_error(mh::format("Malformed line in update manifest {}: {}", path.string(), line));
+
+		auto& entry = entries.emplace_back();
+		entry.m_SHA256 = view.substr(0, 64);
+		const auto pathStr = view.substr(66);
+		entry.m_Path = std::u8string(reinterpret_cast<const char8_t*>(pathStr.data()), pathStr.size());
+
+		if (!IsValidUpdateManifestPath(entry.m_Path))
+			throw std::runtime_error(mh::format("Invalid path in update manifest {}: {}", path.string(), line));
+	}
+
+	return entries;
+}
+
+void tf2_bot_detector::WriteUpdateManifest(const std::filesystem::path& path, const std::vector<UpdateManifestEntry>& entries)
+{
+	std::ofstream file;
+	file.exceptions(std::ios::badbit | std::ios::failbit);
+	file.open(path, std::ios::binary | std::ios::trunc);
+
+	for (const auto& entry : entries)
+	{
+		const auto u8Path = entry.m_Path.generic_u8string();
+		file << entry.m_SHA256 << " *"sv
+			<< std::string_view(reinterpret_cast<const char*>(u8Path.data()), u8Path.size()) << '\n';
+	}
+}
+
+std::vector<UpdateManifestEntry> tf2_bot_detector::CreateUpdateManifest(const std::filesystem::path& dir)
+{
+	std::vector<UpdateManifestEntry> entries;
+
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(dir))
+	{
+		if (!entry.is_regular_file())
+			continue;
+
+		auto path = entry.path().lexically_relative(dir);
+		if (path == UPDATE_MANIFEST_FILENAME)
+			continue;
+
+		entries.push_back({ std::move(path), HashFileSHA256(entry.path()) });
+	}
+
+	return entries;
+}
+
+void tf2_bot_detector::ReplaceFile(const std::filesystem::path& source, const std::filesystem::path& dest)
+{
+	std::filesystem::create_directories(dest.parent_path());
+
+	auto tempPath = dest;
+	tempPath += ".tf2bd_new";
+
+	std::filesystem::copy_file(source, tempPath, std::filesystem::copy_options::overwrite_existing);
+
+	try
+	{
+		std::filesystem::rename(tempPath, dest);
+	}
+	catch (...)
+	{
+		std::error_code ec;
+		std::filesystem::remove(tempPath, ec);
+		throw;
+	}
+}
@@ -27,6 +27,7 @@ namespace tf2_bot_detector::Updater
 	struct CmdLineArgs
 	{
 		bool m_PauseOnError = true;
+		bool m_Rollback = false;  // Portable only, swap the previous version back in
 
 		UpdateType m_UpdateType = UpdateType::Unknown;
 
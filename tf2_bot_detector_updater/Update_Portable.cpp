@@ -1,28 +1,65 @@
 #include "Update_Portable.h"
 #include "Platform/Platform.h"
 #include "Common.h"
+#include "StagedInstall.h"
+#include "UpdateManifest.h"
 
 #include <mh/reflection/enum.hpp>
 #include <mh/text/format.hpp>
 #include <mh/text/formatters/error_code.hpp>
 
+#include <chrono>
 #include <exception>
 #include <filesystem>
 #include <iostream>
+#include <vector>
 
 int tf2_bot_detector::Updater::Update_Portable() try
 {
 	auto sysDepsResult = Platform::UpdateSystemDependencies();
 
-	std::cerr << "Attempting to install portable version from "
-		<< s_CmdLineArgs.m_SourcePath << " to " << s_CmdLineArgs.m_DestPath
-		<< "..." << std::endl;
+	const std::filesystem::path sourcePath = s_CmdLineArgs.m_SourcePath;
+	const auto& destPath = s_CmdLineArgs.m_DestPath;
 
-	using copy_options = std::filesystem::copy_options;
-	std::filesystem::copy(s_CmdLineArgs.m_SourcePath, s_CmdLineArgs.m_DestPath,
-		copy_options::recursive | copy_options::overwrite_existing);
+	// We were probably started from inside destPath, which would stop it from being renamed
+	std::filesystem::current_path(std::filesystem::temp_directory_path());
 
-	std::cerr << "Finished copying files. Attempting to start tool..." << std::endl;
+	if (s_CmdLineArgs.m_Rollback)
+	{
+		std::cerr << "Attempting to roll back " << destPath << " to the previous version..." << std::endl;
+
+		if (!RollbackStagedInstall(destPath))
+		{
+			std::cerr << "No previous version found at " << GetStagedInstallPreviousDir(destPath) << std::endl;
+			return 1;
+		}
+	}
+	else
+	{
+		std::cerr << "Attempting to install portable version from "
+			<< sourcePath << " to " << destPath << "..." << std::endl;
+
+		// Delta updates only contain the files that changed. Builds downloaded by older versions of the
+		// tool don't have a manifest at all, so there is nothing to check them against.
+		std::vector<UpdateManifestEntry> manifest;
+		if (const auto manifestPath = sourcePath / UPDATE_MANIFEST_FILENAME; std::filesystem::exists(manifestPath))
+			manifest = ReadUpdateManifest(manifestPath);
+		else
+			manifest = CreateUpdateManifest(sourcePath);
+
+		const auto stats = InstallStaged(sourcePath, destPath, manifest);
+
+		std::cerr << mh::format("Copied {} file(s), {:.1f} MB in {:.2f} seconds ({:.1f} MB/s)",
+			stats.m_FileCount, stats.m_ByteCount / (1024.0 * 1024.0),
+			std::chrono::duration<double>(stats.m_CopyTime).count(), stats.GetMBPerSecond()) << std::endl;
+
+		if (stats.m_SwappedDirectories)
+			std::cerr << "Previous version kept at " << GetStagedInstallPreviousDir(destPath) << std::endl;
+		else
+			std::cerr << "Unable to swap install directories, files were replaced in place instead" << std::endl;
+	}
+
+	std::cerr << "Attempting to start tool..." << std::endl;
 
 	// FIXME linux
 	if (sysDepsResult != UpdateSystemDependenciesResult::RebootRequired)
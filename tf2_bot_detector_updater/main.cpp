@@ -46,7 +46,7 @@ CmdLineArgs tf2_bot_detector::Updater::s_CmdLineArgs;
 
 	if (s_CmdLineArgs.m_UpdateType == UpdateType::Portable)
 	{
-		if (s_CmdLineArgs.m_SourcePath.empty())
+		if (s_CmdLineArgs.m_SourcePath.empty() && !s_CmdLineArgs.m_Rollback)
 		{
 			return SourcePathEmpty();
 		}
@@ -123,6 +123,10 @@ CmdLineArgs tf2_bot_detector::Updater::s_CmdLineArgs;
 		{
 			s_CmdLineArgs.m_PauseOnError = false;
 		}
+		else if (arg == "--rollback")
+		{
+			s_CmdLineArgs.m_Rollback = true;
+		}
 	}
 
 	if (auto result = ValidateParameters(); result != 0)